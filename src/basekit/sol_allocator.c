@@ -0,0 +1,633 @@
+#include <string.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include "sol_allocator.h"
+
+static _Atomic size_t _sol_stats_b;
+static _Atomic size_t _sol_stats_pb;
+static _Atomic size_t _sol_stats_n;
+static _Atomic size_t _sol_stats_tn;
+
+#define _solArena_align(s) (((s) + SOL_ARENA_ALIGN - 1) & ~(size_t)(SOL_ARENA_ALIGN - 1))
+
+/**
+ * arena growing by chunks of cs bytes, cs 0 uses SOL_ARENA_CHUNK_SIZE
+ * containers made with solArena_allocator(ar) need not be freed one by one,
+ * reset or free the arena instead
+ */
+SolArena* solArena_new(size_t cs)
+{
+    SolArena *ar = sol_calloc(1, sizeof(SolArena));
+    if (ar == NULL) {
+        return NULL;
+    }
+    ar->cs = cs ? cs : SOL_ARENA_CHUNK_SIZE;
+    ar->a.f_alloc = &_solArena_f_alloc;
+    ar->a.f_calloc = &_solArena_f_calloc;
+    ar->a.f_realloc = &_solArena_f_realloc;
+    ar->a.f_free = &_solArena_f_free;
+    ar->a.ctx = ar;
+    return ar;
+}
+
+void solArena_free(SolArena *ar)
+{
+    SolArenaChunk *l[3] = {ar->ch, ar->fc, ar->rc};
+    SolArenaChunk *ch, *n;
+    int i;
+    for (i = 0; i < 3; i++) {
+        for (ch = l[i]; ch; ch = n) {
+            n = ch->n;
+            sol_free(ch);
+        }
+    }
+    sol_free(ar);
+}
+
+/**
+ * drop everything handed out, chunks are kept for reuse
+ */
+void solArena_reset(SolArena *ar)
+{
+    SolArenaChunk *ch, *n;
+    if (ar->ch) {
+        ar->ch->n = ar->rc;
+        ar->rc = ar->ch;
+        ar->ch = NULL;
+    }
+    for (ch = ar->fc; ch; ch = n) {
+        n = ch->n;
+        ch->n = ar->rc;
+        ar->rc = ch;
+    }
+    ar->fc = NULL;
+    ar->bp = NULL;
+    ar->be = NULL;
+    ar->lp = NULL;
+    ar->u = 0;
+}
+
+void* solArena_alloc(SolArena *ar, size_t s)
+{
+    s = _solArena_align(s ? s : 1);
+    if ((size_t)(ar->be - ar->bp) < s) {
+        return _solArena_new_chunk(ar, s);
+    }
+    ar->lp = ar->bp;
+    ar->bp += s;
+    ar->u += s;
+    return ar->lp;
+}
+
+void* solArena_calloc(SolArena *ar, size_t n, size_t s)
+{
+    void *p = solArena_alloc(ar, n * s);
+    if (p) {
+        memset(p, 0, n * s);
+    }
+    return p;
+}
+
+/**
+ * the last allocation grows in place when the chunk has room
+ */
+void* solArena_realloc(SolArena *ar, void *p, size_t os, size_t s)
+{
+    if (p == NULL) {
+        return solArena_alloc(ar, s);
+    }
+    if (p == ar->lp) {
+        size_t ns = _solArena_align(s ? s : 1);
+        if ((size_t)(ar->be - ar->lp) >= ns) {
+            ar->u = ar->u - (size_t)(ar->bp - ar->lp) + ns;
+            ar->bp = ar->lp + ns;
+            return p;
+        }
+    }
+    if (s <= os) {
+        return p;
+    }
+    void *np = solArena_alloc(ar, s);
+    if (np) {
+        memcpy(np, p, os);
+    }
+    return np;
+}
+
+/**
+ * move to a chunk of at least s bytes and allocate s from it
+ * big requests get a chunk of their own
+ */
+void* _solArena_new_chunk(SolArena *ar, size_t s)
+{
+    SolArenaChunk *ch = NULL;
+    SolArenaChunk **pp;
+    size_t hs = _solArena_align(sizeof(SolArenaChunk));
+    for (pp = &ar->rc; *pp; pp = &(*pp)->n) {
+        if ((*pp)->s >= s) {
+            ch = *pp;
+            *pp = ch->n;
+            break;
+        }
+    }
+    if (ch == NULL) {
+        size_t cs = s > ar->cs ? s : ar->cs;
+        ch = sol_alloc(hs + cs);
+        if (ch == NULL) {
+            return NULL;
+        }
+        ch->s = cs;
+    }
+    if (ar->ch) {
+        ar->ch->n = ar->fc;
+        ar->fc = ar->ch;
+    }
+    ch->n = NULL;
+    ar->ch = ch;
+    ar->lp = (char*)ch + hs;
+    ar->bp = ar->lp + s;
+    ar->be = ar->lp + ch->s;
+    ar->u += s;
+    return ar->lp;
+}
+
+void* _solArena_f_alloc(void *ar, size_t s)
+{
+    return solArena_alloc(ar, s);
+}
+
+void* _solArena_f_calloc(void *ar, size_t n, size_t s)
+{
+    return solArena_calloc(ar, n, s);
+}
+
+void* _solArena_f_realloc(void *ar, void *p, size_t os, size_t s)
+{
+    return solArena_realloc(ar, p, os, s);
+}
+
+void _solArena_f_free(void *ar, void *p)
+{
+}
+
+/**
+ * copy the process wide counts into st
+ */
+void sol_alloc_stats(SolAllocStats *st)
+{
+    st->b = atomic_load_explicit(&_sol_stats_b, memory_order_relaxed);
+    st->pb = atomic_load_explicit(&_sol_stats_pb, memory_order_relaxed);
+    st->n = atomic_load_explicit(&_sol_stats_n, memory_order_relaxed);
+    st->tn = atomic_load_explicit(&_sol_stats_tn, memory_order_relaxed);
+}
+
+/**
+ * start a new high water mark from the live bytes
+ */
+void sol_alloc_stats_reset_peak()
+{
+    atomic_store_explicit(&_sol_stats_pb, atomic_load_explicit(&_sol_stats_b, memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
+void _sol_stats_count(size_t s)
+{
+    size_t b = atomic_fetch_add_explicit(&_sol_stats_b, s, memory_order_relaxed) + s;
+    size_t pb = atomic_load_explicit(&_sol_stats_pb, memory_order_relaxed);
+    while (b > pb && !atomic_compare_exchange_weak_explicit(&_sol_stats_pb, &pb, b,
+                                                            memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * the size of each block sits in a header right before it
+ */
+void* _sol_stats_alloc(size_t s)
+{
+    char *p = malloc(SOL_ALLOC_STATS_HEADER + s);
+    if (p == NULL) {
+        return NULL;
+    }
+    *(size_t*)p = s;
+    _sol_stats_count(s);
+    atomic_fetch_add_explicit(&_sol_stats_n, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_sol_stats_tn, 1, memory_order_relaxed);
+    return p + SOL_ALLOC_STATS_HEADER;
+}
+
+void* _sol_stats_calloc(size_t n, size_t s)
+{
+    if (s && n > (size_t)-1 / s) {
+        return NULL;
+    }
+    void *p = _sol_stats_alloc(n * s);
+    if (p) {
+        memset(p, 0, n * s);
+    }
+    return p;
+}
+
+void* _sol_stats_realloc(void *p, size_t s)
+{
+    if (p == NULL) {
+        return _sol_stats_alloc(s);
+    }
+    char *h = (char*)p - SOL_ALLOC_STATS_HEADER;
+    size_t os = *(size_t*)h;
+    char *nh = realloc(h, SOL_ALLOC_STATS_HEADER + s);
+    if (nh == NULL) {
+        return NULL;
+    }
+    *(size_t*)nh = s;
+    atomic_fetch_sub_explicit(&_sol_stats_b, os, memory_order_relaxed);
+    _sol_stats_count(s);
+    return nh + SOL_ALLOC_STATS_HEADER;
+}
+
+void _sol_stats_free(void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    char *h = (char*)p - SOL_ALLOC_STATS_HEADER;
+    atomic_fetch_sub_explicit(&_sol_stats_b, *(size_t*)h, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&_sol_stats_n, 1, memory_order_relaxed);
+    free(h);
+}
+
+static const size_t _sol_magazine_sizes[SOL_MAGAZINE_CLASSES] = {16, 24, 32, 48, 64, 96, 128, 192, 256};
+// size class of (s + 7) / 8
+static const unsigned char _sol_magazine_size_class[SOL_MAGAZINE_MAX_SIZE / 8 + 1] = {
+    0, 0, 0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8,
+};
+static pthread_once_t _sol_magazine_once = PTHREAD_ONCE_INIT;
+static pthread_key_t _sol_magazine_key;
+static char *_Atomic _sol_magazine_base;
+static _Atomic size_t _sol_magazine_next_slab;
+// size class of every slab in the region
+static unsigned char _sol_magazine_slab_class[SOL_MAGAZINE_REGION_SIZE / SOL_MAGAZINE_SLAB_SIZE];
+static SolMagazineDepot _sol_magazine_depots[SOL_MAGAZINE_CLASSES];
+static _Thread_local SolMagazineCache _sol_magazine_cache;
+
+SolAllocator sol_magazine_allocator = {
+    &_sol_magazine_f_alloc, &_sol_magazine_f_calloc, &_sol_magazine_f_realloc, &_sol_magazine_f_free, NULL
+};
+
+/**
+ * sizes up to SOL_MAGAZINE_MAX_SIZE come from the magazines of the calling thread,
+ * the depot of their class is only locked when a magazine runs empty
+ */
+void* sol_magazine_alloc(size_t s)
+{
+    if (s > SOL_MAGAZINE_MAX_SIZE) {
+        return malloc(s);
+    }
+    size_t k = _sol_magazine_size_class[(s + 7) >> 3];
+    SolMagazineCache *c = &_sol_magazine_cache;
+    SolMagazine *m = c->ld[k];
+    if (m && m->c) {
+        c->a[k]++;
+        return m->r[--m->c];
+    }
+    m = c->pv[k];
+    if (m && m->c) {
+        c->pv[k] = c->ld[k];
+        c->ld[k] = m;
+        c->a[k]++;
+        return m->r[--m->c];
+    }
+    return _sol_magazine_reload(c, k);
+}
+
+void* sol_magazine_calloc(size_t n, size_t s)
+{
+    if (s && n > (size_t)-1 / s) {
+        return NULL;
+    }
+    void *p = sol_magazine_alloc(n * s);
+    if (p) {
+        memset(p, 0, n * s);
+    }
+    return p;
+}
+
+void* sol_magazine_realloc(void *p, size_t s)
+{
+    if (p == NULL) {
+        return sol_magazine_alloc(s);
+    }
+    size_t k = _sol_magazine_class(p);
+    if (k == SOL_MAGAZINE_CLASSES) {
+        return realloc(p, s);
+    }
+    if (s <= _sol_magazine_sizes[k]) {
+        return p;
+    }
+    void *np = sol_magazine_alloc(s);
+    if (np) {
+        memcpy(np, p, _sol_magazine_sizes[k]);
+        sol_magazine_free(p);
+    }
+    return np;
+}
+
+/**
+ * objects go to the magazines of the freeing thread, whoever allocated them
+ */
+void sol_magazine_free(void *p)
+{
+    if (p == NULL) {
+        return;
+    }
+    size_t k = _sol_magazine_class(p);
+    if (k == SOL_MAGAZINE_CLASSES) {
+        free(p);
+        return;
+    }
+    SolMagazineCache *c = &_sol_magazine_cache;
+    SolMagazine *m = c->ld[k];
+    if (m && m->c < SOL_MAGAZINE_ROUNDS) {
+        c->f[k]++;
+        m->r[m->c++] = p;
+        return;
+    }
+    m = c->pv[k];
+    if (m && m->c == 0) {
+        c->pv[k] = c->ld[k];
+        c->ld[k] = m;
+        c->f[k]++;
+        m->r[m->c++] = p;
+        return;
+    }
+    _sol_magazine_unload(c, k, p);
+}
+
+/**
+ * give the magazines of this thread back to the depots, done on thread exit too
+ */
+void sol_magazine_flush()
+{
+    if (_sol_magazine_cache.r) {
+        _sol_magazine_exit(&_sol_magazine_cache);
+    }
+}
+
+/**
+ * stats of size class k, return 1 when there is no such class
+ * counts of other running threads reach the depot as they exchange magazines
+ */
+int sol_magazine_stats(size_t k, SolMagazineStats *st)
+{
+    if (k >= SOL_MAGAZINE_CLASSES) {
+        return 1;
+    }
+    pthread_once(&_sol_magazine_once, &_sol_magazine_init);
+    SolMagazineDepot *d = &_sol_magazine_depots[k];
+    SolMagazineCache *c = &_sol_magazine_cache;
+    pthread_mutex_lock(&d->l);
+    d->a += c->a[k];
+    d->f += c->f[k];
+    c->a[k] = 0;
+    c->f[k] = 0;
+    st->s = _sol_magazine_sizes[k];
+    st->a = d->a;
+    st->f = d->f;
+    st->sl = d->sl;
+    st->nf = d->nf;
+    st->ne = d->ne;
+    st->x = d->x;
+    pthread_mutex_unlock(&d->l);
+    return 0;
+}
+
+/**
+ * reserve the slab region, without it every size goes to malloc
+ */
+void _sol_magazine_init()
+{
+    size_t k;
+    for (k = 0; k < SOL_MAGAZINE_CLASSES; k++) {
+        pthread_mutex_init(&_sol_magazine_depots[k].l, NULL);
+    }
+    pthread_key_create(&_sol_magazine_key, &_sol_magazine_exit);
+    int f = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    f |= MAP_NORESERVE;
+#endif
+    void *b = mmap(NULL, SOL_MAGAZINE_REGION_SIZE, PROT_READ | PROT_WRITE, f, -1, 0);
+    atomic_store_explicit(&_sol_magazine_base, b == MAP_FAILED ? NULL : b, memory_order_release);
+}
+
+void _sol_magazine_exit(void *a)
+{
+    SolMagazineCache *c = a;
+    SolMagazineDepot *d;
+    SolMagazine *m[2];
+    size_t k;
+    int i;
+    for (k = 0; k < SOL_MAGAZINE_CLASSES; k++) {
+        d = &_sol_magazine_depots[k];
+        m[0] = c->ld[k];
+        m[1] = c->pv[k];
+        pthread_mutex_lock(&d->l);
+        d->a += c->a[k];
+        d->f += c->f[k];
+        for (i = 0; i < 2; i++) {
+            if (m[i] == NULL) {
+                continue;
+            }
+            if (m[i]->c == SOL_MAGAZINE_ROUNDS) {
+                m[i]->n = d->fm;
+                d->fm = m[i];
+                d->nf++;
+                continue;
+            }
+            // rounds of a partial magazine become loose objects
+            while (m[i]->c) {
+                void *o = m[i]->r[--m[i]->c];
+                *(void**)o = d->fl;
+                d->fl = o;
+            }
+            m[i]->n = d->em;
+            d->em = m[i];
+            d->ne++;
+        }
+        pthread_mutex_unlock(&d->l);
+        c->ld[k] = NULL;
+        c->pv[k] = NULL;
+        c->a[k] = 0;
+        c->f[k] = 0;
+    }
+    c->r = 0;
+}
+
+/**
+ * class of the slab holding p, SOL_MAGAZINE_CLASSES when p is not in the region
+ */
+size_t _sol_magazine_class(void *p)
+{
+    char *b = atomic_load_explicit(&_sol_magazine_base, memory_order_relaxed);
+    if (b == NULL || (char*)p < b || (char*)p >= b + SOL_MAGAZINE_REGION_SIZE) {
+        return SOL_MAGAZINE_CLASSES;
+    }
+    return _sol_magazine_slab_class[(size_t)((char*)p - b) / SOL_MAGAZINE_SLAB_SIZE];
+}
+
+/**
+ * both magazines of class k are empty, trade them for a full one from the depot
+ * or fill one from the slab of the depot, return an object
+ */
+void* _sol_magazine_reload(SolMagazineCache *c, size_t k)
+{
+    pthread_once(&_sol_magazine_once, &_sol_magazine_init);
+    if (atomic_load_explicit(&_sol_magazine_base, memory_order_relaxed) == NULL) {
+        return malloc(_sol_magazine_sizes[k]);
+    }
+    if (c->r == 0) {
+        pthread_setspecific(_sol_magazine_key, c);
+        c->r = 1;
+    }
+    SolMagazineDepot *d = &_sol_magazine_depots[k];
+    SolMagazine *m;
+    void *o = NULL;
+    pthread_mutex_lock(&d->l);
+    d->a += c->a[k];
+    d->f += c->f[k];
+    c->a[k] = 0;
+    c->f[k] = 0;
+    if (d->fm) {
+        m = d->fm;
+        d->fm = m->n;
+        d->nf--;
+        if (c->pv[k]) {
+            c->pv[k]->n = d->em;
+            d->em = c->pv[k];
+            d->ne++;
+        }
+        c->pv[k] = c->ld[k];
+        c->ld[k] = m;
+        d->x++;
+    } else {
+        if (c->ld[k] == NULL) {
+            c->ld[k] = _sol_magazine_empty(d);
+        }
+        m = c->ld[k];
+        while (m && m->c < SOL_MAGAZINE_ROUNDS && (o = _sol_magazine_carve(d, k))) {
+            m->r[m->c++] = o;
+        }
+    }
+    m = c->ld[k];
+    o = m && m->c ? m->r[--m->c] : _sol_magazine_carve(d, k);
+    pthread_mutex_unlock(&d->l);
+    if (o == NULL) {
+        // region used up
+        return malloc(_sol_magazine_sizes[k]);
+    }
+    c->a[k]++;
+    return o;
+}
+
+/**
+ * the loaded magazine of class k is full and the previous one is not empty,
+ * hand the previous to the depot and load an empty one for p
+ */
+void _sol_magazine_unload(SolMagazineCache *c, size_t k, void *p)
+{
+    if (c->r == 0) {
+        pthread_setspecific(_sol_magazine_key, c);
+        c->r = 1;
+    }
+    SolMagazineDepot *d = &_sol_magazine_depots[k];
+    pthread_mutex_lock(&d->l);
+    d->a += c->a[k];
+    d->f += c->f[k] + 1;
+    c->a[k] = 0;
+    c->f[k] = 0;
+    if (c->ld[k]) {
+        if (c->pv[k]) {
+            c->pv[k]->n = d->fm;
+            d->fm = c->pv[k];
+            d->nf++;
+        }
+        c->pv[k] = c->ld[k];
+        d->x++;
+    }
+    c->ld[k] = _sol_magazine_empty(d);
+    if (c->ld[k]) {
+        c->ld[k]->r[c->ld[k]->c++] = p;
+    } else {
+        *(void**)p = d->fl;
+        d->fl = p;
+    }
+    pthread_mutex_unlock(&d->l);
+}
+
+/**
+ * next object of class k from the loose list or the current slab, depot locked
+ */
+void* _sol_magazine_carve(SolMagazineDepot *d, size_t k)
+{
+    void *o = d->fl;
+    if (o) {
+        d->fl = *(void**)o;
+        return o;
+    }
+    size_t s = _sol_magazine_sizes[k];
+    if (d->bp == NULL || (size_t)(d->be - d->bp) < s) {
+        size_t i = atomic_fetch_add_explicit(&_sol_magazine_next_slab, 1, memory_order_relaxed);
+        if (i >= SOL_MAGAZINE_REGION_SIZE / SOL_MAGAZINE_SLAB_SIZE) {
+            return NULL;
+        }
+        _sol_magazine_slab_class[i] = (unsigned char)k;
+        d->bp = atomic_load_explicit(&_sol_magazine_base, memory_order_relaxed) + i * SOL_MAGAZINE_SLAB_SIZE;
+        d->be = d->bp + SOL_MAGAZINE_SLAB_SIZE;
+        d->sl++;
+    }
+    o = d->bp;
+    d->bp += s;
+    return o;
+}
+
+/**
+ * empty magazine from the depot or malloc, depot locked
+ */
+SolMagazine* _sol_magazine_empty(SolMagazineDepot *d)
+{
+    SolMagazine *m = d->em;
+    if (m) {
+        d->em = m->n;
+        d->ne--;
+        return m;
+    }
+    m = malloc(sizeof(SolMagazine));
+    if (m) {
+        m->c = 0;
+    }
+    return m;
+}
+
+void* _sol_magazine_f_alloc(void *ctx, size_t s)
+{
+    (void)ctx;
+    return sol_magazine_alloc(s);
+}
+
+void* _sol_magazine_f_calloc(void *ctx, size_t n, size_t s)
+{
+    (void)ctx;
+    return sol_magazine_calloc(n, s);
+}
+
+void* _sol_magazine_f_realloc(void *ctx, void *p, size_t os, size_t s)
+{
+    (void)ctx;
+    (void)os;
+    return sol_magazine_realloc(p, s);
+}
+
+void _sol_magazine_f_free(void *ctx, void *p)
+{
+    (void)ctx;
+    sol_magazine_free(p);
+}
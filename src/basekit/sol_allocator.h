@@ -0,0 +1,168 @@
+#ifndef _SOL_ALLOCATOR_H_
+#define _SOL_ALLOCATOR_H_ 1
+
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+#include "sol_common.h"
+
+#define SOL_ARENA_CHUNK_SIZE 65536
+#define SOL_ARENA_ALIGN 16
+// room kept in front of every counted allocation for its size
+#define SOL_ALLOC_STATS_HEADER 16
+
+// size classes served by magazines, bigger sizes go to malloc
+#define SOL_MAGAZINE_CLASSES 9
+#define SOL_MAGAZINE_MAX_SIZE 256
+// objects moved between a thread and the depot at once
+#define SOL_MAGAZINE_ROUNDS 64
+#define SOL_MAGAZINE_SLAB_SIZE 65536
+// address space reserved for slabs, pages are only used once touched
+#ifndef SOL_MAGAZINE_REGION_SIZE
+#define SOL_MAGAZINE_REGION_SIZE ((size_t)1 << 30)
+#endif
+
+// allocator of a container, NULL in a container means sol_alloc and friends
+typedef struct _SolAllocator {
+    void* (*f_alloc)(void*, size_t);
+    void* (*f_calloc)(void*, size_t, size_t);
+    void* (*f_realloc)(void*, void*, size_t, size_t); // ctx, ptr, old size, new size
+    void (*f_free)(void*, void*);
+    void *ctx;
+} SolAllocator;
+
+typedef struct _SolArenaChunk {
+    struct _SolArenaChunk *n; // next chunk
+    size_t s; // usable size
+} SolArenaChunk;
+
+// bump pointer arena, free is a no op, memory goes back on reset or free
+typedef struct _SolArena {
+    SolAllocator a; // allocator handing out arena memory
+    size_t cs; // default chunk size
+    size_t u; // bytes handed out
+    char *bp; // bump pointer
+    char *be; // end of current chunk
+    char *lp; // last allocation, may grow in place
+    SolArenaChunk *ch; // chunk in use
+    SolArenaChunk *fc; // full chunks
+    SolArenaChunk *rc; // chunks kept by reset
+} SolArena;
+
+// bytes held by a container, the parts add up to b
+typedef struct _SolMemoryUsage {
+    size_t b; // live bytes
+    size_t pb; // peak bytes, the peaks of the parts added up
+    size_t n; // live allocations
+    size_t sb; // container structs
+    size_t rb; // hash records
+    size_t nb; // tree and list nodes, vec elements
+    size_t ub; // rules
+    size_t mb; // marks
+} SolMemoryUsage;
+
+typedef struct _SolMagazine {
+    struct _SolMagazine *n; // next in the depot
+    size_t c; // rounds held
+    void *r[SOL_MAGAZINE_ROUNDS]; // rounds
+} SolMagazine;
+
+// magazines of one size class shared by all threads
+typedef struct _SolMagazineDepot {
+    pthread_mutex_t l; // lock
+    SolMagazine *fm; // full magazines
+    SolMagazine *em; // empty magazines
+    void *fl; // loose objects, linked through their first word
+    char *bp; // carving pointer in the current slab
+    char *be; // end of the current slab
+    size_t nf; // full magazines
+    size_t ne; // empty magazines
+    size_t a; // allocations
+    size_t f; // frees
+    size_t x; // exchanges with threads
+    size_t sl; // slabs
+    char _p0[SOL_CACHE_LINE_SIZE]; // keeps the locks of neighbour depots apart
+} SolMagazineDepot;
+
+// magazines of the running thread, rounds move between them without locking
+typedef struct _SolMagazineCache {
+    SolMagazine *ld[SOL_MAGAZINE_CLASSES]; // loaded
+    SolMagazine *pv[SOL_MAGAZINE_CLASSES]; // previous
+    size_t a[SOL_MAGAZINE_CLASSES]; // allocations not yet added to the depot
+    size_t f[SOL_MAGAZINE_CLASSES]; // frees not yet added to the depot
+    int r; // registered for the exit flush
+} SolMagazineCache;
+
+typedef struct _SolMagazineStats {
+    size_t s; // object size
+    size_t a; // allocations
+    size_t f; // frees
+    size_t sl; // slabs
+    size_t nf; // full magazines in the depot
+    size_t ne; // empty magazines in the depot
+    size_t x; // exchanges with threads
+} SolMagazineStats;
+
+// hands out magazine memory to a container, ctx is unused
+extern SolAllocator sol_magazine_allocator;
+
+SolArena* solArena_new(size_t);
+void solArena_free(SolArena*);
+void solArena_reset(SolArena*);
+void* solArena_alloc(SolArena*, size_t);
+void* solArena_calloc(SolArena*, size_t, size_t);
+void* solArena_realloc(SolArena*, void*, size_t, size_t);
+void* _solArena_new_chunk(SolArena*, size_t);
+void* _solArena_f_alloc(void*, size_t);
+void* _solArena_f_calloc(void*, size_t, size_t);
+void* _solArena_f_realloc(void*, void*, size_t, size_t);
+void _solArena_f_free(void*, void*);
+void _sol_stats_count(size_t);
+
+void sol_magazine_flush();
+int sol_magazine_stats(size_t, SolMagazineStats*);
+void _sol_magazine_init();
+void _sol_magazine_exit(void*);
+size_t _sol_magazine_class(void*);
+void* _sol_magazine_reload(SolMagazineCache*, size_t);
+void _sol_magazine_unload(SolMagazineCache*, size_t, void*);
+void* _sol_magazine_carve(SolMagazineDepot*, size_t);
+SolMagazine* _sol_magazine_empty(SolMagazineDepot*);
+void* _sol_magazine_f_alloc(void*, size_t);
+void* _sol_magazine_f_calloc(void*, size_t, size_t);
+void* _sol_magazine_f_realloc(void*, void*, size_t, size_t);
+void _sol_magazine_f_free(void*, void*);
+
+#define solArena_allocator(ar) (&(ar)->a)
+#define solArena_used(ar) (ar)->u
+
+// zero u before adding parts to it
+#define solMemoryUsage_init(u) memset(u, 0, sizeof(SolMemoryUsage))
+// total the parts, the peak is never under the live bytes
+#define solMemoryUsage_sum(u) do {                                      \
+        (u)->b = (u)->sb + (u)->rb + (u)->nb + (u)->ub + (u)->mb;       \
+        if ((u)->pb < (u)->b) {                                         \
+            (u)->pb = (u)->b;                                           \
+        }                                                               \
+    } while (0)
+// add one allocation of s bytes to the part p of u
+#define solMemoryUsage_add(u, p, s) do {                                \
+        (u)->p += (s);                                                  \
+        (u)->pb += (s);                                                 \
+        (u)->n++;                                                       \
+    } while (0)
+// move everything in t to the part p of u
+#define solMemoryUsage_add_as(u, t, p) do {                             \
+        (u)->p += (t)->sb + (t)->rb + (t)->nb + (t)->ub + (t)->mb;      \
+        (u)->pb += (t)->pb;                                             \
+        (u)->n += (t)->n;                                               \
+    } while (0)
+
+#define solAllocator_alloc(x, s) ((x) ? (*(x)->f_alloc)((x)->ctx, s) : sol_alloc(s))
+#define solAllocator_calloc(x, n, s) ((x) ? (*(x)->f_calloc)((x)->ctx, n, s) : sol_calloc(n, s))
+#define solAllocator_realloc(x, p, os, s) ((x) ? (*(x)->f_realloc)((x)->ctx, p, os, s) : sol_realloc(p, s))
+#define solAllocator_free(x, p) do {if (x) {(*(x)->f_free)((x)->ctx, p);} else {sol_free(p);}} while (0)
+// solAllocator_free once no reader inside sol_epoch_enter may still see p, 1 when out of memory
+#define solAllocator_free_deferred(x, p) ((x) ? sol_epoch_defer((x)->f_free, (x)->ctx, p) : sol_free_deferred(p))
+
+#endif
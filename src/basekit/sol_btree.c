@@ -0,0 +1,524 @@
+#include <string.h>
+#include "sol_btree.h"
+
+SolBTree* solBTree_new()
+{
+    return solBTree_new_with_allocator(NULL);
+}
+
+/**
+ * tree whose struct and nodes come from allocator a
+ */
+SolBTree* solBTree_new_with_allocator(SolAllocator *a)
+{
+    SolBTree *t = solAllocator_calloc(a, 1, sizeof(SolBTree));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->a = a;
+    return t;
+}
+
+void solBTree_free(SolBTree *t)
+{
+    solBTree_wipe(t);
+    solAllocator_free(t->a, t);
+}
+
+/**
+ * drop all vals and nodes, the tree stays usable
+ */
+void solBTree_wipe(SolBTree *t)
+{
+    if (t->root) {
+        _solBTree_free_node(t, t->root);
+    }
+    t->root = NULL;
+    t->hd = NULL;
+    t->tl = NULL;
+    t->c = 0;
+    t->h = 0;
+}
+
+/**
+ * insert v, return the val kept in the tree:
+ * v itself, the equal val already there, or NULL when out of memory
+ */
+void* solBTree_insert(SolBTree *t, void *v)
+{
+    SolBTreeInner *pn[SOL_BTREE_MAX_DEPTH];
+    unsigned int pi[SOL_BTREE_MAX_DEPTH];
+    size_t d;
+    if (t->root == NULL) {
+        SolBTreeLeaf *l = solAllocator_calloc(t->a, 1, sizeof(SolBTreeLeaf));
+        if (l == NULL) {
+            return NULL;
+        }
+        l->n.lf = 1;
+        l->n.k[0] = v;
+        l->n.c = 1;
+        t->root = &l->n;
+        t->hd = l;
+        t->tl = l;
+        t->h = 1;
+        t->c = 1;
+        return v;
+    }
+    SolBTreeLeaf *l = _solBTree_find_leaf(t, v, pn, pi, &d);
+    unsigned int i = _solBTree_lower(t, &l->n, v);
+    if (i < l->n.c && solBTree_val_compare(t, v, l->n.k[i]) == 0) {
+        return l->n.k[i];
+    }
+    if (l->n.c == SOL_BTREE_ORDER) {
+        SolBTreeNode *nn[SOL_BTREE_MAX_DEPTH + 1];
+        size_t j, s = 1;
+        // one new node per full level on the way up, and a new root when all are full
+        while (s <= d && pn[d - s]->n.c == SOL_BTREE_ORDER) {
+            s++;
+        }
+        if (s > d) {
+            s++;
+        }
+        for (j = 0; j < s; j++) {
+            nn[j] = solAllocator_calloc(t->a, 1, j ? sizeof(SolBTreeInner) : sizeof(SolBTreeLeaf));
+            if (nn[j] == NULL) {
+                while (j--) {
+                    solAllocator_free(t->a, nn[j]);
+                }
+                return NULL;
+            }
+        }
+        return _solBTree_split(t, l, i, v, pn, pi, d, nn);
+    }
+    memmove(&l->n.k[i + 1], &l->n.k[i], sizeof(void*) * (l->n.c - i));
+    l->n.k[i] = v;
+    l->n.c++;
+    t->c++;
+    return v;
+}
+
+/**
+ * remove the val equal to v and free it, return 1 when there is none
+ */
+int solBTree_del(SolBTree *t, void *v)
+{
+    SolBTreeInner *pn[SOL_BTREE_MAX_DEPTH];
+    unsigned int pi[SOL_BTREE_MAX_DEPTH];
+    size_t d;
+    if (t->root == NULL) {
+        return 1;
+    }
+    SolBTreeLeaf *l = _solBTree_find_leaf(t, v, pn, pi, &d);
+    unsigned int i = _solBTree_lower(t, &l->n, v);
+    if (i == l->n.c || solBTree_val_compare(t, v, l->n.k[i]) != 0) {
+        return 1;
+    }
+    void *x = l->n.k[i];
+    l->n.c--;
+    memmove(&l->n.k[i], &l->n.k[i + 1], sizeof(void*) * (l->n.c - i));
+    t->c--;
+    _solBTree_rebalance(t, &l->n, pn, pi, d);
+    if (i == 0) {
+        // a separator is the first val of the leaves right of it, x may be one
+        _solBTree_replace_separator(t, x);
+    }
+    if (t->f_free) {
+        solBTree_val_free(t, x);
+    }
+    return 0;
+}
+
+void* solBTree_search(SolBTree *t, void *v)
+{
+    if (t->root == NULL) {
+        return NULL;
+    }
+    SolBTreeNode *n = t->root;
+    while (n->lf == 0) {
+        n = _solBTree_inner(n)->ch[_solBTree_upper(t, n, v)];
+    }
+    unsigned int i = _solBTree_lower(t, n, v);
+    if (i < n->c && solBTree_val_compare(t, v, n->k[i]) == 0) {
+        return n->k[i];
+    }
+    return NULL;
+}
+
+void* solBTree_min(SolBTree *t)
+{
+    return t->hd ? t->hd->n.k[0] : NULL;
+}
+
+void* solBTree_max(SolBTree *t)
+{
+    return t->tl ? t->tl->n.k[t->tl->n.c - 1] : NULL;
+}
+
+/**
+ * call f on the vals from lo up to but not including hi in order
+ * NULL lo or hi leaves that end open, a non zero return of f stops the scan
+ */
+int solBTree_range(SolBTree *t, void *lo, void *hi, solBTree_f_ptr_act f, void *d)
+{
+    SolBTreeIter i;
+    void *v;
+    int r;
+    if (lo) {
+        solBTreeIter_seek(&i, t, lo);
+    } else {
+        solBTreeIter_init(&i, t);
+    }
+    while ((v = solBTreeIter_next(&i))) {
+        if (hi && solBTree_val_compare(t, v, hi) >= 0) {
+            break;
+        }
+        if ((r = (*f)(t, v, d))) {
+            return r;
+        }
+    }
+    return 0;
+}
+
+int solBTree_travelsal_inorder(SolBTree *t, solBTree_f_ptr_act f, void *d)
+{
+    return solBTree_range(t, NULL, NULL, f, d);
+}
+
+/**
+ * struct and nodes of the tree, vals are not counted
+ */
+void solBTree_memory_usage(SolBTree *t, SolMemoryUsage *u)
+{
+    solMemoryUsage_init(u);
+    solMemoryUsage_add(u, sb, sizeof(SolBTree));
+    if (t->root) {
+        _solBTree_node_memory_usage(t->root, u);
+    }
+    solMemoryUsage_sum(u);
+}
+
+void solBTreeIter_init(SolBTreeIter *i, SolBTree *t)
+{
+    i->l = t->hd;
+    i->i = 0;
+}
+
+void solBTreeIter_init_last(SolBTreeIter *i, SolBTree *t)
+{
+    i->l = t->tl;
+    i->i = t->tl ? t->tl->n.c : 0;
+}
+
+/**
+ * place i on the first val not less than v
+ */
+void solBTreeIter_seek(SolBTreeIter *i, SolBTree *t, void *v)
+{
+    i->l = NULL;
+    i->i = 0;
+    if (t->root == NULL) {
+        return;
+    }
+    SolBTreeNode *n = t->root;
+    while (n->lf == 0) {
+        n = _solBTree_inner(n)->ch[_solBTree_upper(t, n, v)];
+    }
+    i->l = _solBTree_leaf(n);
+    i->i = _solBTree_lower(t, n, v);
+}
+
+/**
+ * val under i and step forward, NULL past the last val
+ */
+void* solBTreeIter_next(SolBTreeIter *i)
+{
+    while (i->l && i->i == i->l->n.c) {
+        i->l = i->l->nx;
+        i->i = 0;
+    }
+    if (i->l == NULL) {
+        return NULL;
+    }
+    return i->l->n.k[i->i++];
+}
+
+/**
+ * step back and return the val before i, NULL before the first val
+ */
+void* solBTreeIter_prev(SolBTreeIter *i)
+{
+    while (i->l && i->i == 0) {
+        i->l = i->l->pv;
+        i->i = i->l ? i->l->n.c : 0;
+    }
+    if (i->l == NULL) {
+        return NULL;
+    }
+    return i->l->n.k[--i->i];
+}
+
+/**
+ * first key of n not less than v
+ */
+unsigned int _solBTree_lower(SolBTree *t, SolBTreeNode *n, void *v)
+{
+    unsigned int l = 0, h = n->c, m;
+    while (l < h) {
+        m = (l + h) / 2;
+        if (solBTree_val_compare(t, n->k[m], v) < 0) {
+            l = m + 1;
+        } else {
+            h = m;
+        }
+    }
+    return l;
+}
+
+/**
+ * first key of n greater than v, the child of an inner node holding v
+ */
+unsigned int _solBTree_upper(SolBTree *t, SolBTreeNode *n, void *v)
+{
+    unsigned int l = 0, h = n->c, m;
+    while (l < h) {
+        m = (l + h) / 2;
+        if (solBTree_val_compare(t, n->k[m], v) <= 0) {
+            l = m + 1;
+        } else {
+            h = m;
+        }
+    }
+    return l;
+}
+
+/**
+ * leaf where v belongs, the inner nodes passed and the child taken in each go to pn and pi
+ */
+SolBTreeLeaf* _solBTree_find_leaf(SolBTree *t, void *v, SolBTreeInner **pn, unsigned int *pi, size_t *d)
+{
+    SolBTreeNode *n = t->root;
+    size_t i = 0;
+    while (n->lf == 0) {
+        pn[i] = _solBTree_inner(n);
+        pi[i] = _solBTree_upper(t, n, v);
+        n = pn[i]->ch[pi[i]];
+        i++;
+    }
+    *d = i;
+    return _solBTree_leaf(n);
+}
+
+/**
+ * insert v at i of the full leaf l, splitting it and every full node above
+ * nn holds the new leaf, then one new inner node per split level
+ */
+void* _solBTree_split(SolBTree *t, SolBTreeLeaf *l, unsigned int i, void *v,
+                      SolBTreeInner **pn, unsigned int *pi, size_t d, SolBTreeNode **nn)
+{
+    void *tk[SOL_BTREE_ORDER + 1];
+    SolBTreeNode *tc[SOL_BTREE_ORDER + 2];
+    unsigned int m, j;
+    SolBTreeLeaf *r = _solBTree_leaf(nn[0]);
+    memcpy(tk, l->n.k, sizeof(void*) * i);
+    tk[i] = v;
+    memcpy(tk + i + 1, l->n.k + i, sizeof(void*) * (SOL_BTREE_ORDER - i));
+    m = (SOL_BTREE_ORDER + 1) / 2;
+    memcpy(l->n.k, tk, sizeof(void*) * m);
+    l->n.c = m;
+    r->n.lf = 1;
+    r->n.c = SOL_BTREE_ORDER + 1 - m;
+    memcpy(r->n.k, tk + m, sizeof(void*) * r->n.c);
+    r->pv = l;
+    r->nx = l->nx;
+    if (l->nx) {
+        l->nx->pv = r;
+    } else {
+        t->tl = r;
+    }
+    l->nx = r;
+    t->c++;
+    // pass the separator and the new right node up
+    void *sk = r->n.k[0];
+    SolBTreeNode *sn = &r->n;
+    size_t s = 1;
+    SolBTreeInner *p, *ri;
+    while (d > 0) {
+        d--;
+        p = pn[d];
+        j = pi[d];
+        if (p->n.c < SOL_BTREE_ORDER) {
+            memmove(&p->n.k[j + 1], &p->n.k[j], sizeof(void*) * (p->n.c - j));
+            memmove(&p->ch[j + 2], &p->ch[j + 1], sizeof(SolBTreeNode*) * (p->n.c - j));
+            p->n.k[j] = sk;
+            p->ch[j + 1] = sn;
+            p->n.c++;
+            return v;
+        }
+        memcpy(tk, p->n.k, sizeof(void*) * j);
+        tk[j] = sk;
+        memcpy(tk + j + 1, p->n.k + j, sizeof(void*) * (SOL_BTREE_ORDER - j));
+        memcpy(tc, p->ch, sizeof(SolBTreeNode*) * (j + 1));
+        tc[j + 1] = sn;
+        memcpy(tc + j + 2, p->ch + j + 1, sizeof(SolBTreeNode*) * (SOL_BTREE_ORDER - j));
+        // the middle key moves up and leaves both halves
+        m = SOL_BTREE_ORDER / 2;
+        ri = _solBTree_inner(nn[s++]);
+        memcpy(p->n.k, tk, sizeof(void*) * m);
+        memcpy(p->ch, tc, sizeof(SolBTreeNode*) * (m + 1));
+        p->n.c = m;
+        ri->n.c = SOL_BTREE_ORDER - m;
+        memcpy(ri->n.k, tk + m + 1, sizeof(void*) * ri->n.c);
+        memcpy(ri->ch, tc + m + 1, sizeof(SolBTreeNode*) * (ri->n.c + 1));
+        sk = tk[m];
+        sn = &ri->n;
+    }
+    ri = _solBTree_inner(nn[s]);
+    ri->n.c = 1;
+    ri->n.k[0] = sk;
+    ri->ch[0] = t->root;
+    ri->ch[1] = sn;
+    t->root = &ri->n;
+    t->h++;
+    return v;
+}
+
+/**
+ * n at depth d lost a key, refill it from a sibling or merge it into one,
+ * then go on with the parent when the merge left it short
+ */
+void _solBTree_rebalance(SolBTree *t, SolBTreeNode *n, SolBTreeInner **pn, unsigned int *pi, size_t d)
+{
+    SolBTreeInner *p;
+    SolBTreeNode *s;
+    unsigned int i;
+    while (d > 0 && n->c < SOL_BTREE_MIN) {
+        p = pn[d - 1];
+        i = pi[d - 1];
+        if (i > 0 && (s = p->ch[i - 1])->c > SOL_BTREE_MIN) {
+            // borrow the last key of the left sibling
+            memmove(&n->k[1], &n->k[0], sizeof(void*) * n->c);
+            if (n->lf) {
+                n->k[0] = s->k[s->c - 1];
+                p->n.k[i - 1] = n->k[0];
+            } else {
+                memmove(&_solBTree_inner(n)->ch[1], &_solBTree_inner(n)->ch[0], sizeof(SolBTreeNode*) * (n->c + 1));
+                n->k[0] = p->n.k[i - 1];
+                _solBTree_inner(n)->ch[0] = _solBTree_inner(s)->ch[s->c];
+                p->n.k[i - 1] = s->k[s->c - 1];
+            }
+            s->c--;
+            n->c++;
+            return;
+        }
+        if (i < p->n.c && (s = p->ch[i + 1])->c > SOL_BTREE_MIN) {
+            // borrow the first key of the right sibling
+            if (n->lf) {
+                n->k[n->c] = s->k[0];
+                memmove(&s->k[0], &s->k[1], sizeof(void*) * (s->c - 1));
+                p->n.k[i] = s->k[0];
+            } else {
+                n->k[n->c] = p->n.k[i];
+                _solBTree_inner(n)->ch[n->c + 1] = _solBTree_inner(s)->ch[0];
+                p->n.k[i] = s->k[0];
+                memmove(&s->k[0], &s->k[1], sizeof(void*) * (s->c - 1));
+                memmove(&_solBTree_inner(s)->ch[0], &_solBTree_inner(s)->ch[1], sizeof(SolBTreeNode*) * s->c);
+            }
+            s->c--;
+            n->c++;
+            return;
+        }
+        _solBTree_merge(t, p, i > 0 ? i - 1 : i);
+        n = &p->n;
+        d--;
+    }
+    if (d == 0 && n->c == 0) {
+        // the root ran empty
+        if (n->lf) {
+            t->root = NULL;
+            t->hd = NULL;
+            t->tl = NULL;
+            t->h = 0;
+        } else {
+            t->root = _solBTree_inner(n)->ch[0];
+            t->h--;
+        }
+        solAllocator_free(t->a, n);
+    }
+}
+
+/**
+ * the separator that is x, if any, takes the min val of the subtree right of it
+ * done after the rebalance, merges and borrows may have moved x to another node
+ */
+void _solBTree_replace_separator(SolBTree *t, void *x)
+{
+    SolBTreeNode *n = t->root, *m;
+    unsigned int i;
+    while (n && n->lf == 0) {
+        i = _solBTree_upper(t, n, x);
+        if (i > 0 && n->k[i - 1] == x) {
+            for (m = _solBTree_inner(n)->ch[i]; m->lf == 0; m = _solBTree_inner(m)->ch[0]);
+            n->k[i - 1] = m->k[0];
+            return;
+        }
+        n = _solBTree_inner(n)->ch[i];
+    }
+}
+
+/**
+ * merge child i + 1 of p into child i and drop separator i
+ */
+void _solBTree_merge(SolBTree *t, SolBTreeInner *p, unsigned int i)
+{
+    SolBTreeNode *l = p->ch[i];
+    SolBTreeNode *r = p->ch[i + 1];
+    if (l->lf) {
+        memcpy(&l->k[l->c], r->k, sizeof(void*) * r->c);
+        l->c += r->c;
+        _solBTree_leaf(l)->nx = _solBTree_leaf(r)->nx;
+        if (_solBTree_leaf(r)->nx) {
+            _solBTree_leaf(r)->nx->pv = _solBTree_leaf(l);
+        } else {
+            t->tl = _solBTree_leaf(l);
+        }
+    } else {
+        l->k[l->c] = p->n.k[i];
+        memcpy(&l->k[l->c + 1], r->k, sizeof(void*) * r->c);
+        memcpy(&_solBTree_inner(l)->ch[l->c + 1], _solBTree_inner(r)->ch, sizeof(SolBTreeNode*) * (r->c + 1));
+        l->c += r->c + 1;
+    }
+    solAllocator_free(t->a, r);
+    p->n.c--;
+    memmove(&p->n.k[i], &p->n.k[i + 1], sizeof(void*) * (p->n.c - i));
+    memmove(&p->ch[i + 1], &p->ch[i + 2], sizeof(SolBTreeNode*) * (p->n.c - i));
+}
+
+void _solBTree_free_node(SolBTree *t, SolBTreeNode *n)
+{
+    unsigned int i;
+    if (n->lf) {
+        if (t->f_free) {
+            for (i = 0; i < n->c; i++) {
+                solBTree_val_free(t, n->k[i]);
+            }
+        }
+    } else {
+        for (i = 0; i <= n->c; i++) {
+            _solBTree_free_node(t, _solBTree_inner(n)->ch[i]);
+        }
+    }
+    solAllocator_free(t->a, n);
+}
+
+void _solBTree_node_memory_usage(SolBTreeNode *n, SolMemoryUsage *u)
+{
+    unsigned int i;
+    if (n->lf) {
+        solMemoryUsage_add(u, nb, sizeof(SolBTreeLeaf));
+        return;
+    }
+    solMemoryUsage_add(u, nb, sizeof(SolBTreeInner));
+    for (i = 0; i <= n->c; i++) {
+        _solBTree_node_memory_usage(_solBTree_inner(n)->ch[i], u);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef _SOL_BTREE_H_
+#define _SOL_BTREE_H_ 1
+
+#include <stddef.h>
+#include "sol_common.h"
+#include "sol_allocator.h"
+
+// keys per node, a leaf takes about four cache lines
+#ifndef SOL_BTREE_ORDER
+#define SOL_BTREE_ORDER 32
+#endif
+// a node must keep a key after losing one
+#if SOL_BTREE_ORDER < 2
+#error "SOL_BTREE_ORDER must be at least 2"
+#endif
+// nodes other than the root never hold fewer keys
+#define SOL_BTREE_MIN (SOL_BTREE_ORDER / 2)
+// deeper than any tree addressable memory can hold
+#define SOL_BTREE_MAX_DEPTH 24
+
+typedef struct _SolBTreeNode {
+    unsigned int c; // keys
+    unsigned int lf; // 1 for a leaf
+    void *k[SOL_BTREE_ORDER]; // vals in a leaf, separators in an inner node
+} SolBTreeNode;
+
+typedef struct _SolBTreeLeaf {
+    SolBTreeNode n;
+    struct _SolBTreeLeaf *pv; // previous leaf
+    struct _SolBTreeLeaf *nx; // next leaf
+} SolBTreeLeaf;
+
+// child i holds the keys from k[i - 1] up to but not including k[i]
+typedef struct _SolBTreeInner {
+    SolBTreeNode n;
+    SolBTreeNode *ch[SOL_BTREE_ORDER + 1]; // children
+} SolBTreeInner;
+
+// ordered set of vals, all vals live in leaves linked in order
+typedef struct _SolBTree {
+    size_t c; // count
+    size_t h; // height, 0 when empty
+    SolBTreeNode *root;
+    SolBTreeLeaf *hd; // first leaf
+    SolBTreeLeaf *tl; // last leaf
+    sol_f_cmp_ptr f_compare;
+    sol_f_free_ptr f_free; // free val func
+    SolAllocator *a; // allocator, NULL for sol_alloc
+} SolBTree;
+
+// cursor over the leaves, keep it on the stack
+typedef struct _SolBTreeIter {
+    SolBTreeLeaf *l; // leaf
+    unsigned int i; // index in the leaf
+} SolBTreeIter;
+
+typedef int (*solBTree_f_ptr_act)(SolBTree*, void*, void*);
+
+SolBTree* solBTree_new();
+SolBTree* solBTree_new_with_allocator(SolAllocator*);
+void solBTree_free(SolBTree*);
+void solBTree_wipe(SolBTree*);
+void* solBTree_insert(SolBTree*, void*);
+int solBTree_del(SolBTree*, void*);
+void* solBTree_search(SolBTree*, void*);
+void* solBTree_min(SolBTree*);
+void* solBTree_max(SolBTree*);
+int solBTree_range(SolBTree*, void*, void*, solBTree_f_ptr_act, void*);
+int solBTree_travelsal_inorder(SolBTree*, solBTree_f_ptr_act, void*);
+void solBTree_memory_usage(SolBTree*, SolMemoryUsage*);
+
+void solBTreeIter_init(SolBTreeIter*, SolBTree*);
+void solBTreeIter_init_last(SolBTreeIter*, SolBTree*);
+void solBTreeIter_seek(SolBTreeIter*, SolBTree*, void*);
+void* solBTreeIter_next(SolBTreeIter*);
+void* solBTreeIter_prev(SolBTreeIter*);
+
+unsigned int _solBTree_lower(SolBTree*, SolBTreeNode*, void*);
+unsigned int _solBTree_upper(SolBTree*, SolBTreeNode*, void*);
+SolBTreeLeaf* _solBTree_find_leaf(SolBTree*, void*, SolBTreeInner**, unsigned int*, size_t*);
+void* _solBTree_split(SolBTree*, SolBTreeLeaf*, unsigned int, void*, SolBTreeInner**, unsigned int*, size_t,
+                      SolBTreeNode**);
+void _solBTree_rebalance(SolBTree*, SolBTreeNode*, SolBTreeInner**, unsigned int*, size_t);
+void _solBTree_replace_separator(SolBTree*, void*);
+void _solBTree_merge(SolBTree*, SolBTreeInner*, unsigned int);
+void _solBTree_free_node(SolBTree*, SolBTreeNode*);
+void _solBTree_node_memory_usage(SolBTreeNode*, SolMemoryUsage*);
+
+#define solBTree_count(t) (t)->c
+#define solBTree_height(t) (t)->h
+#define solBTree_is_empty(t) ((t)->c == 0)
+#define solBTree_allocator(t) (t)->a
+
+#define solBTree_set_compare_func(t, f) (t)->f_compare = f
+#define solBTree_set_val_free_func(t, f) (t)->f_free = f
+#define solBTree_val_compare(t, v1, v2) (*(t)->f_compare)(v1, v2)
+#define solBTree_val_free(t, v) (*(t)->f_free)(v)
+
+#define _solBTree_inner(n) ((SolBTreeInner*)(n))
+#define _solBTree_leaf(n) ((SolBTreeLeaf*)(n))
+
+#endif
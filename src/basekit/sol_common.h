@@ -6,15 +6,61 @@
 
 #define SolNil NULL
 
+// build with -DSOL_ALLOC_STATS to count every sol_alloc, link sol_allocator.o
+// or with -DSOL_ALLOC_MAGAZINE for per thread caches of small sizes, link -lpthread too
+#if defined(SOL_ALLOC_MAGAZINE)
+#define sol_alloc sol_magazine_alloc
+#define sol_calloc sol_magazine_calloc
+#define sol_free sol_magazine_free
+#define sol_realloc sol_magazine_realloc
+#elif defined(SOL_ALLOC_STATS)
+#define sol_alloc _sol_stats_alloc
+#define sol_calloc _sol_stats_calloc
+#define sol_free _sol_stats_free
+#define sol_realloc _sol_stats_realloc
+#else
 #define sol_alloc malloc
 #define sol_calloc calloc
 #define sol_free free
 #define sol_realloc realloc
+#endif
+// sol_free once no thread that may still see p is inside sol_epoch_enter, link sol_epoch.o and -lpthread
+// out of memory it waits for the readers and frees p at once, unless inside sol_epoch_enter or a deferred free
+// 1 then, p is left to the caller
+#define sol_free_deferred(p) sol_epoch_defer(&_sol_epoch_f_free, NULL, p)
+
+// process wide counts of sol_alloc, all zero without SOL_ALLOC_STATS
+typedef struct _SolAllocStats {
+    size_t b; // live bytes
+    size_t pb; // peak live bytes
+    size_t n; // live allocations
+    size_t tn; // allocations ever made
+} SolAllocStats;
+
+void sol_alloc_stats(SolAllocStats*);
+void sol_alloc_stats_reset_peak();
+void* _sol_stats_alloc(size_t);
+void* _sol_stats_calloc(size_t, size_t);
+void* _sol_stats_realloc(void*, size_t);
+void _sol_stats_free(void*);
+void* sol_magazine_alloc(size_t);
+void* sol_magazine_calloc(size_t, size_t);
+void* sol_magazine_realloc(void*, size_t);
+void sol_magazine_free(void*);
+
+// padding between fields written by different threads
+#ifndef SOL_CACHE_LINE_SIZE
+#define SOL_CACHE_LINE_SIZE 64
+#endif
 
 typedef int (*sol_f_cmp_ptr)(void*, void*);
 typedef void (*sol_f_free_ptr)(void*);
 typedef void* (*sol_f_dup_ptr)(void*);
 typedef size_t (*sol_f_hash_ptr)(void*);
+typedef void (*sol_f_defer_ptr)(void*, void*); // ctx, ptr
+
+int sol_epoch_defer(sol_f_defer_ptr, void*, void*);
+void _sol_epoch_f_free(void*, void*);
 
 enum SolValType {
     SolValTypeInt = 1,
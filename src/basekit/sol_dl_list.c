@@ -4,10 +4,19 @@
 
 SolDlList* solDlList_new()
 {
-    SolDlList *l = sol_calloc(1, sizeof(SolDlList));
+    return solDlList_new_with_allocator(NULL);
+}
+
+/**
+ * list whose struct and nodes come from allocator a, unless it has a pool
+ */
+SolDlList* solDlList_new_with_allocator(SolAllocator *a)
+{
+    SolDlList *l = solAllocator_calloc(a, 1, sizeof(SolDlList));
     if (l == NULL) {
         return NULL;
     }
+    l->a = a;
     return l;
 }
 
@@ -17,22 +26,47 @@ void solDlList_free(SolDlList *l)
     SolDlListNode *c, *n;
     c = l->head;
     len = l->len;
+    // nodes live in a pool nobody else uses, drop the chunks at once
+    if (l->pool && solPool_is_shared(l->pool) == 0 && l->f_free == NULL) {
+        c = NULL;
+    }
     if (c != NULL) {
         while (len--) {
             n = c->next;
             solDlListNodeVal_free(l, c);
             if (c != NULL) {
-                sol_free(c);
+                solDlListNode_free(l, c);
             }
             c = n;
         }
     }
-    sol_free(l);
+    solPool_free(l->pool);
+    solAllocator_free(l->a, l);
+}
+
+/**
+ * take nodes of the list from the pool, the list keeps a reference
+ * only an empty list can change its pool
+ */
+int solDlList_set_pool(SolDlList *l, SolPool *p)
+{
+    if (l->len != 0) {
+        return -1;
+    }
+    if (p && solPool_slot_size(p) < sizeof(SolDlListNode)) {
+        return -2;
+    }
+    solPool_free(l->pool);
+    if (p) {
+        solPool_ref(p);
+    }
+    l->pool = p;
+    return 0;
 }
 
 SolDlListNode *solDlList_add(SolDlList *l, void *v, enum _SolDlListDir d)
 {
-    SolDlListNode  *n = sol_alloc(sizeof(SolDlListNode));
+    SolDlListNode  *n = solDlListNode_alloc(l);
     if (n == NULL) {
         return NULL;
     }
@@ -73,7 +107,27 @@ void solDlList_del_node(SolDlList *l, SolDlListNode *n)
     }
     solDlListNodeVal_free(l, n);
     l->len--;
-    sol_free(n);
+    solDlListNode_free(l, n);
+}
+
+/**
+ * unlink n and put it back at the head, no node is freed or allocated
+ */
+void solDlList_move_to_head(SolDlList *l, SolDlListNode *n)
+{
+    if (n == l->head) {
+        return;
+    }
+    n->pre->next = n->next;
+    if (n->next) {
+        n->next->pre = n->pre;
+    } else {
+        l->tail = n->pre;
+    }
+    n->pre = NULL;
+    n->next = l->head;
+    l->head->pre = n;
+    l->head = n;
 }
 
 int solDlList_attach(SolDlList *l1, SolDlList *l2)
@@ -81,6 +135,19 @@ int solDlList_attach(SolDlList *l1, SolDlList *l2)
     if (l1 == NULL || l2 == NULL) {
         return -1;
     }
+    if (l1->pool != l2->pool || l1->a != l2->a) {
+        // nodes must go back to the pool or allocator they came from, copy values instead
+        SolDlListNode *n = l2->head;
+        while (n) {
+            if (solDlList_add(l1, n->val, _SolDlListDirFwd) == NULL) {
+                return 1;
+            }
+            n = n->next;
+        }
+        l2->f_free = NULL;
+        solDlList_free(l2);
+        return 0;
+    }
     if (l1->head == NULL) {
         l1->head = l2->head;
         l1->tail = l2->tail;
@@ -103,12 +170,142 @@ finish:
     return 0;
 }
 
+/**
+ * remove duplicated values in O(n), the first occurrence is kept
+ * values are matched by f_match, or by address when it is NULL
+ */
+int solDlList_uniq_hashed(SolDlList *l, sol_f_hash_ptr fh1, sol_f_hash_ptr fh2, sol_f_cmp_ptr f_match)
+{
+    SolDlListNode *n = l->head;
+    if (n == NULL) return -1;
+    SolHash *h = solHash_new();
+    if (h == NULL) return -2;
+    size_t size = SOL_HASH_INIT_SIZE;
+    while (size < l->len * 2) {
+        size = size * 2;
+    }
+    if (size > solHash_size(h) && solHash_resize(h, size)) {
+        solHash_free(h);
+        return -2;
+    }
+    solHash_set_hash_func1(h, fh1);
+    solHash_set_hash_func2(h, fh2);
+    solHash_set_equal_func(h, f_match ? f_match : &_solDlList_val_equal);
+    int has_null = 0;
+    int r = 0;
+    SolDlListNode *nn;
+    while (n) {
+        nn = n->next;
+        // hash can not hold NULL key
+        if (n->val == NULL) {
+            if (has_null) {
+                solDlList_del_node(l, n);
+            }
+            has_null = 1;
+        } else if (solHash_find_record_by_key(h, n->val)) {
+            solDlList_del_node(l, n);
+        } else if (solHash_put(h, n->val, SolNil)) {
+            r = -3;
+            break;
+        }
+        n = nn;
+    }
+    solHash_free(h);
+    return r;
+}
+
+/**
+ * remove duplicated neighbours, run it after solDlList_sort
+ */
+int solDlList_uniq_sorted(SolDlList *l, sol_f_cmp_ptr f_match)
+{
+    SolDlListNode *n = l->head;
+    if (n == NULL) return -1;
+    SolDlListNode *nn;
+    while ((nn = n->next)) {
+        if ((f_match && (*f_match)(n->val, nn->val) == 0)
+            || (f_match == NULL && n->val == nn->val)
+            ) {
+            solDlList_del_node(l, nn);
+        } else {
+            n = nn;
+        }
+    }
+    return 0;
+}
+
+/**
+ * stable bottom-up merge sort, relinks the nodes in place
+ */
+int solDlList_sort(SolDlList *l, sol_f_cmp_ptr f)
+{
+    if (l == NULL || f == NULL) return -1;
+    SolDlListNode *h = l->head;
+    if (h == NULL) return 0;
+    SolDlListNode *p, *q, *e, *t;
+    size_t rs = 1; // run size
+    size_t ps, qs; // size of run p and run q
+    size_t mc; // merge count
+    do {
+        p = h;
+        h = NULL;
+        t = NULL;
+        mc = 0;
+        while (p) {
+            mc++;
+            q = p;
+            ps = 0;
+            while (ps < rs && q) {
+                ps++;
+                q = q->next;
+            }
+            qs = rs;
+            while (ps > 0 || (qs > 0 && q)) {
+                if (ps == 0) {
+                    e = q;
+                    q = q->next;
+                    qs--;
+                } else if (qs == 0 || q == NULL || (*f)(p->val, q->val) <= 0) {
+                    e = p;
+                    p = p->next;
+                    ps--;
+                } else {
+                    e = q;
+                    q = q->next;
+                    qs--;
+                }
+                if (t) {
+                    t->next = e;
+                } else {
+                    h = e;
+                }
+                e->pre = t;
+                t = e;
+            }
+            p = q;
+        }
+        t->next = NULL;
+        rs = rs * 2;
+    } while (mc > 1);
+    l->head = h;
+    l->tail = t;
+    return 0;
+}
+
+int _solDlList_val_equal(void *v1, void *v2)
+{
+    if (v1 == v2) {
+        return 0;
+    }
+    return 1;
+}
+
 SolDlListIter* solDlListIter_new(SolDlList *l, enum _SolDlListDir d)
 {
     if (l == NULL) {
         return NULL;
     }
-    SolDlListIter *i = sol_alloc(sizeof(SolDlListIter));
+    SolDlListIter *i = solAllocator_alloc(l->a, sizeof(SolDlListIter));
     if (i == NULL) {
         return NULL;
     }
@@ -125,7 +322,7 @@ SolDlListIter* solDlListIter_new(SolDlList *l, enum _SolDlListDir d)
 void solDlListIter_free(SolDlListIter *i)
 {
     if (i != NULL) {
-        sol_free(i);
+        solAllocator_free(i->l->a, i);
     }
 }
 
@@ -2,6 +2,9 @@
 #define _SOL_DL_LIST_H_ 1
 
 #include "sol_common.h"
+#include "sol_hash.h"
+#include "sol_pool.h"
+#include "sol_allocator.h"
 
 enum _SolDlListDir {
     _SolDlListDirFwd = 1,
@@ -22,6 +25,8 @@ typedef struct _SolDlList {
     void (*f_free)(void*);
     int (*f_match)(void*);
     void *(*f_mnu)(void*); // match and update
+    SolPool *pool; // node pool
+    SolAllocator *a; // allocator, NULL for sol_alloc
 } SolDlList;
 
 typedef struct _SolDlListIter {
@@ -31,6 +36,7 @@ typedef struct _SolDlListIter {
 } SolDlListIter;
 
 SolDlList* solDlList_new();
+SolDlList* solDlList_new_with_allocator(SolAllocator*);
 void solDlList_free(SolDlList*);
 
 #define solDlList_head(l) l->head
@@ -40,15 +46,26 @@ void solDlList_free(SolDlList*);
 #define solDlList_set_dup_func(l, f) l->f_dup = f
 #define solDlList_set_match_func(l, f) l->f_match = f
 #define solDlList_set_match_and_up_func(l, f) l->f_mnu = f
+#define solDlList_pool(l) (l)->pool
+#define solDlList_allocator(l) (l)->a
+#define solDlList_pool_new(c) solPool_new(sizeof(SolDlListNode), c)
 
 #define solDlListNode_val(n) (n)->val
 #define solDlListNode_next(n) (n)->next
 #define solDlListNode_pre(n) (n)->pre
 #define solDlListNodeVal_free(l, n) if (l->f_free) {(*l->f_free)(n->val);}
+#define solDlListNode_alloc(l) ((l)->pool ? solPool_alloc((l)->pool) : solAllocator_alloc((l)->a, sizeof(SolDlListNode)))
+#define solDlListNode_free(l, n) if ((l)->pool) {solPool_recycle((l)->pool, n);} else {solAllocator_free((l)->a, n);}
 
 SolDlListNode* solDlList_add(SolDlList*, void*, enum _SolDlListDir);
 void solDlList_del_node(SolDlList*, SolDlListNode*);
+void solDlList_move_to_head(SolDlList*, SolDlListNode*);
 int solDlList_attach(SolDlList*, SolDlList*);
+int solDlList_set_pool(SolDlList*, SolPool*);
+int solDlList_uniq_hashed(SolDlList*, sol_f_hash_ptr, sol_f_hash_ptr, sol_f_cmp_ptr);
+int solDlList_uniq_sorted(SolDlList*, sol_f_cmp_ptr);
+int solDlList_sort(SolDlList*, sol_f_cmp_ptr);
+int _solDlList_val_equal(void*, void*);
 
 #define solDlList_add_fwd(l, v) solDlList_add(l, v, _SolDlListDirFwd)
 #define solDlList_add_bak(l, v) solDlList_add(l, v, _SolDlListDirBak)
@@ -0,0 +1,289 @@
+#include <sched.h>
+#include "sol_epoch.h"
+
+static pthread_once_t _sol_epoch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t _sol_epoch_key;
+// guards the thread list, the epoch move and reclaiming
+static pthread_mutex_t _sol_epoch_lock = PTHREAD_MUTEX_INITIALIZER;
+static SolEpochThread *_sol_epoch_threads;
+static _Atomic size_t _sol_epoch_e = 1;
+// bags handed over, newest first
+static _Atomic(SolEpochBag*) _sol_epoch_limbo;
+// counts under the lock, d only of threads gone
+static size_t _sol_epoch_d;
+static size_t _sol_epoch_f;
+static size_t _sol_epoch_a;
+static _Thread_local SolEpochThread _sol_epoch_self;
+
+/**
+ * add the calling thread to the threads an epoch waits for, done on first use too
+ */
+void sol_epoch_register()
+{
+    SolEpochThread *th = &_sol_epoch_self;
+    if (th->r) {
+        return;
+    }
+    pthread_once(&_sol_epoch_once, &_sol_epoch_init);
+    pthread_mutex_lock(&_sol_epoch_lock);
+    th->pv = NULL;
+    th->nx = _sol_epoch_threads;
+    if (th->nx) {
+        th->nx->pv = th;
+    }
+    _sol_epoch_threads = th;
+    th->r = 1;
+    pthread_mutex_unlock(&_sol_epoch_lock);
+    pthread_setspecific(_sol_epoch_key, th);
+}
+
+/**
+ * pointers read from shared structures stay valid until the matching sol_epoch_exit, calls nest
+ */
+void sol_epoch_enter()
+{
+    SolEpochThread *th = _sol_epoch_thread();
+    if (th->dp++ == 0) {
+        atomic_store_explicit(&th->le, atomic_load_explicit(&_sol_epoch_e, memory_order_acquire) << 1 | 1,
+                              memory_order_relaxed);
+        // no shared pointer is read before the epoch is seen by the threads moving it
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+void sol_epoch_exit()
+{
+    SolEpochThread *th = &_sol_epoch_self;
+    if (--th->dp == 0) {
+        atomic_store_explicit(&th->le, 0, memory_order_release);
+    }
+}
+
+/**
+ * call f(d, p) once every thread inside sol_epoch_enter now has left, p must be unreachable already
+ * frees gather in a bag of the calling thread, a full bag is handed over and old bags get freed
+ * out of memory for a bag, it waits the readers out with sol_epoch_barrier and calls f at once
+ * @return 0, 1 out of memory inside sol_epoch_enter or a deferred free and f is not called
+ */
+int sol_epoch_defer(sol_f_defer_ptr f, void *d, void *p)
+{
+    SolEpochThread *th = _sol_epoch_thread();
+    SolEpochBag *b = th->b;
+    if (b == NULL) {
+        b = th->sp;
+        th->sp = NULL;
+        if (b == NULL && (b = sol_alloc(sizeof(SolEpochBag))) == NULL) {
+            if (th->dp || th->rf) {
+                return 1;
+            }
+            sol_epoch_barrier();
+            (*f)(d, p);
+            return 0;
+        }
+        b->n = 0;
+        th->b = b;
+    }
+    b->it[b->n].f = f;
+    b->it[b->n].d = d;
+    b->it[b->n].p = p;
+    b->n++;
+    atomic_store_explicit(&th->d, atomic_load_explicit(&th->d, memory_order_relaxed) + 1, memory_order_relaxed);
+    if (b->n == SOL_EPOCH_BATCH) {
+        _sol_epoch_hand_over(th);
+        _sol_epoch_collect(th);
+    }
+    return 0;
+}
+
+/**
+ * hand the bag being filled over and move the epoch on if no thread holds it back,
+ * done on thread exit too
+ */
+void sol_epoch_flush()
+{
+    SolEpochThread *th = &_sol_epoch_self;
+    _sol_epoch_hand_over(th);
+    _sol_epoch_collect(th);
+    sol_free(th->sp);
+    th->sp = NULL;
+}
+
+/**
+ * wait until every free deferred before the call, by this thread or by threads that flushed, is done
+ * must not be called inside sol_epoch_enter nor from a deferred free
+ * @return 0, -1 inside sol_epoch_enter
+ */
+int sol_epoch_barrier()
+{
+    SolEpochThread *th = _sol_epoch_thread();
+    size_t e;
+    if (th->dp) {
+        return -1;
+    }
+    _sol_epoch_hand_over(th);
+    e = atomic_load_explicit(&_sol_epoch_e, memory_order_seq_cst) + 2;
+    pthread_mutex_lock(&_sol_epoch_lock);
+    while (atomic_load_explicit(&_sol_epoch_e, memory_order_relaxed) < e) {
+        if (_sol_epoch_advance()) {
+            // a reader is still in, let it get on
+            pthread_mutex_unlock(&_sol_epoch_lock);
+            sched_yield();
+            pthread_mutex_lock(&_sol_epoch_lock);
+        }
+    }
+    _sol_epoch_reclaim(th);
+    pthread_mutex_unlock(&_sol_epoch_lock);
+    return 0;
+}
+
+/**
+ * process wide counts, frees of running threads count as deferred when they are made
+ */
+void sol_epoch_stats(SolEpochStats *st)
+{
+    SolEpochThread *th;
+    pthread_mutex_lock(&_sol_epoch_lock);
+    st->e = atomic_load_explicit(&_sol_epoch_e, memory_order_relaxed);
+    st->t = 0;
+    st->d = _sol_epoch_d;
+    for (th = _sol_epoch_threads; th; th = th->nx) {
+        st->t++;
+        st->d += atomic_load_explicit(&th->d, memory_order_relaxed);
+    }
+    st->f = _sol_epoch_f;
+    st->w = st->d - st->f;
+    st->a = _sol_epoch_a;
+    pthread_mutex_unlock(&_sol_epoch_lock);
+}
+
+void _sol_epoch_f_free(void *d, void *p)
+{
+    (void)d;
+    sol_free(p);
+}
+
+SolEpochThread* _sol_epoch_thread()
+{
+    SolEpochThread *th = &_sol_epoch_self;
+    if (th->r == 0) {
+        sol_epoch_register();
+    }
+    return th;
+}
+
+void _sol_epoch_init()
+{
+    pthread_key_create(&_sol_epoch_key, &_sol_epoch_unregister);
+}
+
+/**
+ * thread exit, the bag being filled is handed over and the thread no longer holds an epoch back
+ */
+void _sol_epoch_unregister(void *a)
+{
+    SolEpochThread *th = a;
+    sol_epoch_flush();
+    pthread_mutex_lock(&_sol_epoch_lock);
+    if (th->pv) {
+        th->pv->nx = th->nx;
+    } else {
+        _sol_epoch_threads = th->nx;
+    }
+    if (th->nx) {
+        th->nx->pv = th->pv;
+    }
+    _sol_epoch_d += atomic_load_explicit(&th->d, memory_order_relaxed);
+    atomic_store_explicit(&th->d, 0, memory_order_relaxed);
+    atomic_store_explicit(&th->le, 0, memory_order_relaxed);
+    th->dp = 0;
+    th->r = 0;
+    pthread_mutex_unlock(&_sol_epoch_lock);
+}
+
+/**
+ * tag the bag being filled with the epoch now and put it with the waiting ones
+ * its pointers were all unlinked before, a reader entering from here on can not reach them
+ */
+void _sol_epoch_hand_over(SolEpochThread *th)
+{
+    SolEpochBag *b = th->b;
+    if (b == NULL || b->n == 0) {
+        return;
+    }
+    th->b = NULL;
+    b->e = atomic_load_explicit(&_sol_epoch_e, memory_order_seq_cst);
+    b->nx = atomic_load_explicit(&_sol_epoch_limbo, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&_sol_epoch_limbo, &b->nx, b, memory_order_release,
+                                                  memory_order_relaxed));
+}
+
+/**
+ * move the epoch on and free what is two epochs old, skipped when another thread is at it
+ */
+void _sol_epoch_collect(SolEpochThread *th)
+{
+    if (pthread_mutex_trylock(&_sol_epoch_lock)) {
+        return;
+    }
+    _sol_epoch_advance();
+    _sol_epoch_reclaim(th);
+    pthread_mutex_unlock(&_sol_epoch_lock);
+}
+
+/**
+ * one epoch on once every thread inside has seen the current one, the lock is held
+ * @return 0 moved, -1 a thread inside is still in the epoch before
+ */
+int _sol_epoch_advance()
+{
+    size_t e = atomic_load_explicit(&_sol_epoch_e, memory_order_relaxed);
+    size_t x;
+    SolEpochThread *th;
+    atomic_thread_fence(memory_order_seq_cst);
+    for (th = _sol_epoch_threads; th; th = th->nx) {
+        x = atomic_load_explicit(&th->le, memory_order_acquire);
+        if ((x & 1) && (x >> 1) != e) {
+            return -1;
+        }
+    }
+    atomic_store_explicit(&_sol_epoch_e, e + 1, memory_order_seq_cst);
+    _sol_epoch_a++;
+    return 0;
+}
+
+/**
+ * free the bags two epochs behind, the others go back, the lock is held
+ * a thread inside then entered after they were handed over and can not reach them
+ */
+void _sol_epoch_reclaim(SolEpochThread *th)
+{
+    SolEpochBag *b = atomic_exchange_explicit(&_sol_epoch_limbo, NULL, memory_order_acquire);
+    SolEpochBag *kp = NULL, *kt = NULL, *nx;
+    size_t e = atomic_load_explicit(&_sol_epoch_e, memory_order_relaxed);
+    size_t i;
+    for (; b; b = nx) {
+        nx = b->nx;
+        if (b->e + 2 > e) {
+            b->nx = kp;
+            kp = b;
+            kt = kt ? kt : b;
+            continue;
+        }
+        th->rf++;
+        for (i = 0; i < b->n; i++) {
+            (*b->it[i].f)(b->it[i].d, b->it[i].p);
+        }
+        th->rf--;
+        _sol_epoch_f += b->n;
+        if (th->sp == NULL) {
+            th->sp = b;
+        } else {
+            sol_free(b);
+        }
+    }
+    if (kp) {
+        kt->nx = atomic_load_explicit(&_sol_epoch_limbo, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&_sol_epoch_limbo, &kt->nx, kp, memory_order_release,
+                                                      memory_order_relaxed));
+    }
+}
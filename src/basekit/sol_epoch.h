@@ -0,0 +1,68 @@
+#ifndef _SOL_EPOCH_H_
+#define _SOL_EPOCH_H_ 1
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "sol_common.h"
+
+// deferred frees a thread gathers before handing them over as one batch
+#ifndef SOL_EPOCH_BATCH
+#define SOL_EPOCH_BATCH 64
+#endif
+
+typedef struct _SolEpochItem {
+    sol_f_defer_ptr f;
+    void *d; // first arg of f
+    void *p; // pointer to free
+} SolEpochItem;
+
+typedef struct _SolEpochBag {
+    struct _SolEpochBag *nx; // next bag waiting
+    size_t e; // epoch when handed over, freed two epochs on
+    size_t n; // items
+    SolEpochItem it[SOL_EPOCH_BATCH];
+} SolEpochBag;
+
+// epoch state of a thread, registered on first use and dropped on thread exit
+typedef struct _SolEpochThread {
+    _Atomic size_t le; // epoch seen on entering << 1 | 1, 0 when outside
+    char _p0[SOL_CACHE_LINE_SIZE - sizeof(size_t)];
+    size_t dp; // nesting depth
+    size_t rf; // running deferred frees, the lock is held then
+    SolEpochBag *b; // bag being filled
+    SolEpochBag *sp; // spare empty bag
+    _Atomic size_t d; // frees deferred
+    struct _SolEpochThread *pv; // registered threads
+    struct _SolEpochThread *nx;
+    int r; // registered
+} SolEpochThread;
+
+typedef struct _SolEpochStats {
+    size_t e; // global epoch
+    size_t t; // threads registered
+    size_t d; // frees deferred
+    size_t f; // deferred frees done
+    size_t w; // deferred frees waiting, in bags handed over or still being filled
+    size_t a; // epoch advances
+} SolEpochStats;
+
+void sol_epoch_register();
+void sol_epoch_enter();
+void sol_epoch_exit();
+void sol_epoch_flush();
+int sol_epoch_barrier();
+void sol_epoch_stats(SolEpochStats*);
+
+SolEpochThread* _sol_epoch_thread();
+void _sol_epoch_init();
+void _sol_epoch_unregister(void*);
+void _sol_epoch_hand_over(SolEpochThread*);
+void _sol_epoch_collect(SolEpochThread*);
+int _sol_epoch_advance();
+void _sol_epoch_reclaim(SolEpochThread*);
+
+// inside sol_epoch_enter on the calling thread
+#define sol_epoch_is_inside() (_sol_epoch_thread()->dp > 0)
+
+#endif
@@ -4,11 +4,21 @@
 
 SolHash* solHash_new()
 {
-    SolHash *hash = sol_calloc(1, sizeof(SolHash));
+    return solHash_new_with_allocator(NULL);
+}
+
+/**
+ * hash whose struct and records come from allocator a
+ */
+SolHash* solHash_new_with_allocator(SolAllocator *a)
+{
+    SolHash *hash = solAllocator_calloc(a, 1, sizeof(SolHash));
     if (hash == NULL) {
         return NULL;
     }
+    hash->a = a;
     if (solHash_set_size(hash, SOL_HASH_INIT_SIZE)) {
+        solAllocator_free(a, hash);
         return NULL;
     }
     return hash;
@@ -16,11 +26,11 @@ SolHash* solHash_new()
 
 void solHash_free(SolHash *hash)
 {
-    solHash_free_records(hash->records, hash->size, hash->f_free_k, hash->f_free_v);
-    sol_free(hash);
+    solHash_free_records(hash->a, hash->records, hash->size, hash->f_free_k, hash->f_free_v);
+    solAllocator_free(hash->a, hash);
 }
 
-inline void solHash_free_records(SolHashRecord *r, size_t s, sol_f_free_ptr fk, sol_f_free_ptr fv)
+inline void solHash_free_records(SolAllocator *a, SolHashRecord *r, size_t s, sol_f_free_ptr fk, sol_f_free_ptr fv)
 {
     SolHashRecord *cr;
     if (fk || fv) {
@@ -36,17 +46,20 @@ inline void solHash_free_records(SolHashRecord *r, size_t s, sol_f_free_ptr fk,
             o++;
         }
     }
-    sol_free(r);
+    solAllocator_free(a, r);
 }
 
 int solHash_set_size(SolHash *hash, size_t size)
 {
-    hash->records = sol_calloc(size, sizeof(SolHashRecord));
+    hash->records = solAllocator_calloc(hash->a, size, sizeof(SolHashRecord));
     if (hash->records == NULL) {
         return 8;
     }
     hash->size = size;
     solHash_update_mask(hash);
+    if (hash->is_resizing == SOL_HASH_RESIZING_N && size > hash->ps) {
+        hash->ps = size;
+    }
     return 0;
 }
 
@@ -59,14 +72,16 @@ void solHash_wipe(SolHash *hash)
 int solHash_dup(SolHash *h1, SolHash *h2)
 {
     if (h1->size != h2->size) {
-        solHash_free_records(h1->records, h1->size, h1->f_free_k, h1->f_free_v);
+        solHash_free_records(h1->a, h1->records, h1->size, h1->f_free_k, h1->f_free_v);
         if (solHash_set_size(h1, h2->size) != 0) {
             return 1;
         }
     }
     SolHashRecord *r = h1->records;
+    SolAllocator *a = h1->a;
     memcpy(h1, h2, sizeof(SolHash));
     h1->records = r;
+    h1->a = a;
     if (h1->f_dup_k || h1->f_dup_v) {
         size_t offset = 0;
         void *k;
@@ -243,12 +258,16 @@ int solHash_resize(SolHash *hash, size_t size)
             hash->is_resizing = SOL_HASH_RESIZING_N;
             return 6;
         }
+        // old records stay alive until all moved
+        if (old_size + size > hash->ps) {
+            hash->ps = old_size + size;
+        }
         hash->count = 0;
         if (solHash_add_records(hash, records, old_size) == 0) {
             hash->is_resizing = SOL_HASH_RESIZING_N;
         } else {
             size = size * 2;
-            solHash_free_records(hash->records, hash->size, NULL, NULL);
+            solHash_free_records(hash->a, hash->records, hash->size, NULL, NULL);
         }
     } while (loop_limit-- && hash->is_resizing == SOL_HASH_RESIZING_Y);
     if (hash->is_resizing == SOL_HASH_RESIZING_Y) {
@@ -257,11 +276,32 @@ int solHash_resize(SolHash *hash, size_t size)
         hash->is_resizing = SOL_HASH_RESIZING_N;
         return 7;
     } else {
-        solHash_free_records(records, old_size, NULL, NULL);
+        solHash_free_records(hash->a, records, old_size, NULL, NULL);
         return 0;
     }
 }
 
+/**
+ * struct and records of the hash, keys and vals are not counted
+ */
+void solHash_memory_usage(SolHash *hash, SolMemoryUsage *u)
+{
+    solMemoryUsage_init(u);
+    _solHash_memory_usage(hash, u);
+    solMemoryUsage_sum(u);
+}
+
+/**
+ * add the hash to u, the peak counts the records alive during a resize
+ */
+void _solHash_memory_usage(SolHash *hash, SolMemoryUsage *u)
+{
+    u->sb += sizeof(SolHash);
+    u->rb += sizeof(SolHashRecord) * hash->size;
+    u->pb += sizeof(SolHash) + sizeof(SolHashRecord) * hash->ps;
+    u->n += 2;
+}
+
 int solHash_merge(SolHash *h1, SolHash *h2)
 {
     if (h2 == NULL) {
@@ -312,7 +352,7 @@ inline SolHashRecord* solHash_record2_of_key(SolHash *hash, void *k)
 
 SolHashIter* solHashIter_new(SolHash *hash)
 {
-    SolHashIter *iter = sol_alloc(sizeof(SolHashIter));
+    SolHashIter *iter = solAllocator_alloc(hash->a, sizeof(SolHashIter));
     if (iter == NULL) {
         return NULL;
     }
@@ -321,9 +361,20 @@ SolHashIter* solHashIter_new(SolHash *hash)
     return iter;
 }
 
+/**
+ * init a cursor which lives outside of the hash (e.g. on the stack)
+ * iterating with it never writes to the hash, so many readers
+ * can walk the same hash at once
+ */
+void solHashIter_init(SolHashIter *iter, SolHash *hash)
+{
+    iter->hash = hash;
+    solHashIter_rewind(iter);
+}
+
 void solHashIter_free(SolHashIter *iter)
 {
-    sol_free(iter);
+    solAllocator_free(iter->hash->a, iter);
 }
 
 SolHashRecord* solHashIter_current_record(SolHashIter *iter)
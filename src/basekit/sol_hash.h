@@ -2,6 +2,7 @@
 #define _SOL_HASH_H_ 1
 #include <stddef.h>
 #include "sol_common.h"
+#include "sol_allocator.h"
 
 #define SOL_HASH_INIT_SIZE 8
 #define SOL_HASH_RESIZE_MAX_LOOP 100
@@ -31,6 +32,8 @@ typedef struct _SolHash {
     sol_f_free_ptr f_free_k;
     sol_f_free_ptr f_free_v;
     int is_resizing;
+    size_t ps; // peak record slots alive at once
+    SolAllocator *a; // allocator, NULL for sol_alloc
 } SolHash;
 
 typedef struct _SolHashIter {
@@ -40,6 +43,7 @@ typedef struct _SolHashIter {
 } SolHashIter;
 
 SolHash* solHash_new();
+SolHash* solHash_new_with_allocator(SolAllocator*);
 void solHash_free(SolHash*);
 int solHash_set_size(SolHash*, size_t);
 int solHash_try_to_put(SolHash*, void*, void*);
@@ -47,12 +51,15 @@ int solHash_resize(SolHash*, size_t);
 void solHash_wipe(SolHash*);
 int solHash_dup(SolHash*, SolHash*);
 SolHashRecord* solHash_find_record_by_key(SolHash*, void *);
+void solHash_memory_usage(SolHash*, SolMemoryUsage*);
+void _solHash_memory_usage(SolHash*, SolMemoryUsage*);
 
 #define solHash_size(h) h->size
 #define solHash_count(h) h->count
 #define solHash_is_empty(h) solHash_count(h) == 0
 #define solHash_is_not_empty(h) solHash_count(h) != 0
 #define solHash_update_mask(h) h->mask = h->size - 1
+#define solHash_allocator(h) (h)->a
 
 #define solHash_put(h, k, v) solHash_put_key_and_val(h, k, v)
 #define solHash_get(h, k) solHash_find_value(h, k)
@@ -64,6 +71,7 @@ int solHash_merge(SolHash*, SolHash*);
 void solHash_remove(SolHash*, void*);
 
 SolHashIter* solHashIter_new(SolHash*);
+void solHashIter_init(SolHashIter*, SolHash*);
 void solHashIter_free(SolHashIter*);
 void solHashIter_rewind(SolHashIter*);
 SolHashRecord* solHashIter_current_record(SolHashIter *iter);
@@ -93,10 +101,10 @@ SolHashRecord* solHashIter_get(SolHashIter *iter);
 #define solHash_free_k(h, k) (*h->f_free_k)(k)
 #define solHash_free_v(h, v) (*h->f_free_v)(v)
 
-inline void solHash_free_records(SolHashRecord*, size_t, sol_f_free_ptr, sol_f_free_ptr);
-inline SolHashRecord* solHash_record1_of_key(SolHash*, void*);
-inline SolHashRecord* solHash_record2_of_key(SolHash*, void*);
-inline void solHash_record_switch(SolHashRecord*, SolHashRecord*);
-inline int solHash_add_records(SolHash*, SolHashRecord*, size_t);
+void solHash_free_records(SolAllocator*, SolHashRecord*, size_t, sol_f_free_ptr, sol_f_free_ptr);
+SolHashRecord* solHash_record1_of_key(SolHash*, void*);
+SolHashRecord* solHash_record2_of_key(SolHash*, void*);
+void solHash_record_switch(SolHashRecord*, SolHashRecord*);
+int solHash_add_records(SolHash*, SolHashRecord*, size_t);
 
 #endif
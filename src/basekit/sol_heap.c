@@ -0,0 +1,242 @@
+#include "sol_heap.h"
+
+/**
+ * array backed d-ary min heap, the val comparing lowest pops first
+ * d 0 uses SOL_HEAP_ARITY
+ */
+SolHeap* solHeap_new(size_t d)
+{
+    SolHeap *h = sol_calloc(1, sizeof(SolHeap));
+    if (h == NULL) {
+        return NULL;
+    }
+    h->d = d >= 2 ? d : SOL_HEAP_ARITY;
+    return h;
+}
+
+void solHeap_free(SolHeap *h)
+{
+    solHeap_wipe(h);
+    if (h->e) {
+        sol_free(h->e);
+    }
+    if (h->np) {
+        solPool_free(h->np);
+    }
+    sol_free(h);
+}
+
+/**
+ * all handles become invalid
+ */
+void solHeap_wipe(SolHeap *h)
+{
+    size_t i;
+    for (i = 0; i < h->c; i++) {
+        if (solHeap_val_free_func(h)) {
+            solHeap_val_free(h, h->e[i].v);
+        }
+        if (h->e[i].n) {
+            solPool_recycle(h->np, h->e[i].n);
+        }
+    }
+    h->c = 0;
+}
+
+int solHeap_reserve(SolHeap *h, size_t s)
+{
+    if (s <= h->s) {
+        return 0;
+    }
+    SolHeapEntry *e = sol_realloc(h->e, sizeof(SolHeapEntry) * s);
+    if (e == NULL) {
+        return 1;
+    }
+    h->e = e;
+    h->s = s;
+    return 0;
+}
+
+int solHeap_push(SolHeap *h, void *v)
+{
+    if (_solHeap_append(h, v, NULL)) {
+        return 1;
+    }
+    _solHeap_sift_up(h, h->c - 1);
+    return 0;
+}
+
+/**
+ * push and return a handle, valid until the val is popped or removed
+ */
+SolHeapNode* solHeap_push_node(SolHeap *h, void *v)
+{
+    if (h->np == NULL) {
+        h->np = solPool_new(sizeof(SolHeapNode), 0);
+        if (h->np == NULL) {
+            return NULL;
+        }
+    }
+    SolHeapNode *n = solPool_alloc(h->np);
+    if (n == NULL) {
+        return NULL;
+    }
+    n->v = v;
+    if (_solHeap_append(h, v, n)) {
+        solPool_recycle(h->np, n);
+        return NULL;
+    }
+    _solHeap_sift_up(h, h->c - 1);
+    return n;
+}
+
+void* solHeap_pop(SolHeap *h)
+{
+    if (h->c == 0) {
+        return NULL;
+    }
+    SolHeapEntry top = h->e[0];
+    if (top.n) {
+        solPool_recycle(h->np, top.n);
+    }
+    if (--h->c) {
+        h->e[0] = h->e[h->c];
+        if (h->e[0].n) {
+            h->e[0].n->i = 0;
+        }
+        _solHeap_sift_down(h, 0);
+    }
+    return top.v;
+}
+
+/**
+ * add n vals at once and restore the heap bottom up, O(count) in total
+ */
+int solHeap_heapify(SolHeap *h, void **v, size_t n)
+{
+    if (solHeap_reserve(h, h->c + n)) {
+        return 1;
+    }
+    size_t i;
+    for (i = 0; i < n; i++) {
+        h->e[h->c].v = v[i];
+        h->e[h->c].n = NULL;
+        h->c++;
+    }
+    if (h->c < 2) {
+        return 0;
+    }
+    i = (h->c - 2) / h->d + 1;
+    while (i--) {
+        _solHeap_sift_down(h, i);
+    }
+    return 0;
+}
+
+/**
+ * the val of n now compares lower than before
+ */
+void solHeap_decrease_key(SolHeap *h, SolHeapNode *n)
+{
+    _solHeap_sift_up(h, n->i);
+}
+
+/**
+ * the val of n changed either way
+ */
+void solHeap_update(SolHeap *h, SolHeapNode *n)
+{
+    size_t i = n->i;
+    _solHeap_sift_up(h, i);
+    if (n->i == i) {
+        _solHeap_sift_down(h, i);
+    }
+}
+
+/**
+ * take the val of n out of the heap, n is recycled
+ */
+void* solHeap_remove(SolHeap *h, SolHeapNode *n)
+{
+    size_t i = n->i;
+    void *v = n->v;
+    solPool_recycle(h->np, n);
+    if (i != --h->c) {
+        h->e[i] = h->e[h->c];
+        if (h->e[i].n) {
+            h->e[i].n->i = i;
+        }
+        _solHeap_sift_up(h, i);
+        _solHeap_sift_down(h, h->e[i].n ? h->e[i].n->i : i);
+    }
+    return v;
+}
+
+int _solHeap_append(SolHeap *h, void *v, SolHeapNode *n)
+{
+    if (h->c == h->s && solHeap_reserve(h, h->s ? h->s * 2 : SOL_HEAP_INIT_SIZE)) {
+        return 1;
+    }
+    h->e[h->c].v = v;
+    h->e[h->c].n = n;
+    if (n) {
+        n->i = h->c;
+    }
+    h->c++;
+    return 0;
+}
+
+/**
+ * move the entry at i up through a hole, one copy per level
+ */
+void _solHeap_sift_up(SolHeap *h, size_t i)
+{
+    SolHeapEntry x = h->e[i];
+    size_t p;
+    while (i) {
+        p = (i - 1) / h->d;
+        if (solHeap_val_compare(h, x.v, h->e[p].v) >= 0) {
+            break;
+        }
+        h->e[i] = h->e[p];
+        if (h->e[i].n) {
+            h->e[i].n->i = i;
+        }
+        i = p;
+    }
+    h->e[i] = x;
+    if (x.n) {
+        x.n->i = i;
+    }
+}
+
+void _solHeap_sift_down(SolHeap *h, size_t i)
+{
+    SolHeapEntry x = h->e[i];
+    size_t c, m, k, e;
+    for (;;) {
+        c = i * h->d + 1;
+        if (c >= h->c) {
+            break;
+        }
+        e = c + h->d < h->c ? c + h->d : h->c;
+        m = c;
+        for (k = c + 1; k < e; k++) {
+            if (solHeap_val_compare(h, h->e[k].v, h->e[m].v) < 0) {
+                m = k;
+            }
+        }
+        if (solHeap_val_compare(h, h->e[m].v, x.v) >= 0) {
+            break;
+        }
+        h->e[i] = h->e[m];
+        if (h->e[i].n) {
+            h->e[i].n->i = i;
+        }
+        i = m;
+    }
+    h->e[i] = x;
+    if (x.n) {
+        x.n->i = i;
+    }
+}
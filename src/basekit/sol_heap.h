@@ -0,0 +1,62 @@
+#ifndef _SOL_HEAP_H_
+#define _SOL_HEAP_H_ 1
+
+#include <stddef.h>
+#include "sol_common.h"
+#include "sol_pool.h"
+
+// children per node
+#define SOL_HEAP_ARITY 4
+#define SOL_HEAP_INIT_SIZE 16
+
+// handle of a val in the heap, for update and remove
+typedef struct _SolHeapNode {
+    void *v; // val
+    size_t i; // index in the heap
+} SolHeapNode;
+
+typedef struct _SolHeapEntry {
+    void *v; // val
+    SolHeapNode *n; // handle, NULL if pushed without one
+} SolHeapEntry;
+
+typedef struct _SolHeap {
+    size_t c; // count
+    size_t s; // capacity
+    size_t d; // arity
+    SolHeapEntry *e; // entries
+    SolPool *np; // handles
+    sol_f_cmp_ptr f_compare;
+    sol_f_free_ptr f_free; // free val func
+} SolHeap;
+
+SolHeap* solHeap_new(size_t);
+void solHeap_free(SolHeap*);
+void solHeap_wipe(SolHeap*);
+int solHeap_reserve(SolHeap*, size_t);
+int solHeap_push(SolHeap*, void*);
+SolHeapNode* solHeap_push_node(SolHeap*, void*);
+void* solHeap_pop(SolHeap*);
+int solHeap_heapify(SolHeap*, void**, size_t);
+void solHeap_decrease_key(SolHeap*, SolHeapNode*);
+void solHeap_update(SolHeap*, SolHeapNode*);
+void* solHeap_remove(SolHeap*, SolHeapNode*);
+int _solHeap_append(SolHeap*, void*, SolHeapNode*);
+void _solHeap_sift_up(SolHeap*, size_t);
+void _solHeap_sift_down(SolHeap*, size_t);
+
+#define solHeap_count(h) (h)->c
+#define solHeap_is_empty(h) ((h)->c == 0)
+#define solHeap_arity(h) (h)->d
+#define solHeap_peek(h) ((h)->c ? (h)->e[0].v : NULL)
+
+#define solHeap_set_compare_func(h, f) (h)->f_compare = f
+#define solHeap_val_compare(h, v1, v2) (*(h)->f_compare)(v1, v2)
+
+#define solHeap_set_val_free_func(h, f) (h)->f_free = f
+#define solHeap_val_free_func(h) (h)->f_free
+#define solHeap_val_free(h, v) (*(h)->f_free)(v)
+
+#define solHeapNode_val(n) (n)->v
+
+#endif
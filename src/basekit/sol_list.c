@@ -3,26 +3,77 @@
 
 SolList* solList_new()
 {
-    SolList *l = sol_calloc(1, sizeof(SolList));
+    return solList_new_with_allocator(NULL);
+}
+
+/**
+ * list whose struct and nodes come from allocator a, unless it has a pool
+ */
+SolList* solList_new_with_allocator(SolAllocator *a)
+{
+    SolList *l = solAllocator_calloc(a, 1, sizeof(SolList));
+    if (l) {
+        l->a = a;
+    }
     return l;
 }
 void solList_free(SolList *l)
 {
     SolListNode *n = solList_head(l);
     SolListNode *nn;
+    // nodes live in a pool nobody else uses, drop the chunks at once
+    if (solList_pool(l)
+        && solPool_is_shared(solList_pool(l)) == 0
+        && solListVal_free_func(l) == NULL
+        ) {
+        n = NULL;
+    }
     while (n) {
         nn = solListNode_next(n);
         solListNode_free(l, n);
         n = nn;
     }
-    sol_free(l);
+    solPool_free(solList_pool(l));
+    solAllocator_free(solList_allocator(l), l);
+}
+
+/**
+ * take nodes of the list from the pool, the list keeps a reference
+ * only an empty list can change its pool
+ */
+int solList_set_pool(SolList *l, SolPool *p)
+{
+    if (solList_len(l) != 0) {
+        return -1;
+    }
+    if (p && solPool_slot_size(p) < sizeof(SolListNode)) {
+        return -2;
+    }
+    solPool_free(solList_pool(l));
+    if (p) {
+        solPool_ref(p);
+    }
+    l->pool = p;
+    return 0;
 }
 
 SolListNode* solList_add(SolList *l, void *v)
 {
-    SolListNode *n = solListNode_new(v);
-    if (n == NULL) {
-        return NULL;
+    SolListNode *n;
+    if (solList_pool(l)) {
+        n = solPool_alloc(solList_pool(l));
+        if (n == NULL) {
+            return NULL;
+        }
+        solListNode_set_val(n, v);
+        solListNode_set_next(n, NULL);
+    } else {
+        n = solAllocator_alloc(solList_allocator(l), sizeof(SolListNode));
+        if (n == NULL) {
+            return NULL;
+        }
+        solListNode_set_val(n, v);
+        solListNode_set_next(n, NULL);
     }
     if (solList_len(l) == 0) {
         solList_set_head(l, n);
@@ -157,11 +208,180 @@ int solList_uniq(SolList *l)
     return 0;
 }
 
+/**
+ * remove duplicated values in O(n), the first occurrence is kept
+ * values are matched by match func of list, or by address
+ * hash funcs must agree with the matching
+ */
+int solList_uniq_hashed(SolList *l, sol_f_hash_ptr fh1, sol_f_hash_ptr fh2)
+{
+    SolListNode *n = solList_head(l);
+    if (n == NULL) return -1;
+    SolHash *h = solHash_new();
+    if (h == NULL) return -2;
+    size_t size = SOL_HASH_INIT_SIZE;
+    while (size < solList_len(l) * 2) {
+        size = size * 2;
+    }
+    if (size > solHash_size(h) && solHash_resize(h, size)) {
+        solHash_free(h);
+        return -2;
+    }
+    solHash_set_hash_func1(h, fh1);
+    solHash_set_hash_func2(h, fh2);
+    if (solListVal_match_func(l)) {
+        solHash_set_equal_func(h, solListVal_match_func(l));
+    } else {
+        solHash_set_equal_func(h, &_solList_val_equal);
+    }
+    int has_null = 0;
+    int r = 0;
+    SolListNode *pn = NULL;
+    SolListNode *nn;
+    while (n) {
+        nn = solListNode_next(n);
+        // hash can not hold NULL key
+        if (solListNode_val(n) == NULL) {
+            if (has_null) {
+                goto del_node;
+            }
+            has_null = 1;
+        } else if (solHash_find_record_by_key(h, solListNode_val(n))) {
+            goto del_node;
+        } else if (solHash_put(h, solListNode_val(n), SolNil)) {
+            r = -3;
+            break;
+        }
+        pn = n;
+        n = nn;
+        continue;
+    del_node:
+        // the first node is always kept, pn is not NULL
+        solListNode_set_next(pn, nn);
+        if (solList_tail(l) == n) {
+            solList_set_tail(l, pn);
+        }
+        solListNode_free(l, n);
+        solList_decr_len(l);
+        n = nn;
+    }
+    solHash_free(h);
+    return r;
+}
+
+/**
+ * remove duplicated neighbours, run it after solList_sort
+ */
+int solList_uniq_sorted(SolList *l)
+{
+    SolListNode *n = solList_head(l);
+    if (n == NULL) return -1;
+    SolListNode *nn;
+    while ((nn = solListNode_next(n))) {
+        if (solListVal_match_func(l)) {
+            if (solListVal_match(l, solListNode_val(n), solListNode_val(nn)) == 0) {
+                goto del_node;
+            }
+        } else {
+            if (solListNode_val(n) == solListNode_val(nn)) {
+                goto del_node;
+            }
+        }
+        n = nn;
+        continue;
+    del_node:
+        solListNode_set_next(n, solListNode_next(nn));
+        if (solList_tail(l) == nn) {
+            solList_set_tail(l, n);
+        }
+        solListNode_free(l, nn);
+        solList_decr_len(l);
+    }
+    return 0;
+}
+
+/**
+ * stable bottom-up merge sort, relinks the nodes in place
+ * runs of size 1, 2, 4 ... are merged until one run is left
+ */
+int solList_sort(SolList *l, sol_f_cmp_ptr f)
+{
+    if (l == NULL || f == NULL) return -1;
+    SolListNode *h = solList_head(l);
+    if (h == NULL) return 0;
+    SolListNode *p, *q, *e, *t;
+    size_t rs = 1; // run size
+    size_t ps, qs; // size of run p and run q
+    size_t mc; // merge count
+    do {
+        p = h;
+        h = NULL;
+        t = NULL;
+        mc = 0;
+        while (p) {
+            mc++;
+            q = p;
+            ps = 0;
+            while (ps < rs && q) {
+                ps++;
+                q = solListNode_next(q);
+            }
+            qs = rs;
+            while (ps > 0 || (qs > 0 && q)) {
+                if (ps == 0) {
+                    e = q;
+                    q = solListNode_next(q);
+                    qs--;
+                } else if (qs == 0 || q == NULL
+                           || (*f)(solListNode_val(p), solListNode_val(q)) <= 0
+                    ) {
+                    e = p;
+                    p = solListNode_next(p);
+                    ps--;
+                } else {
+                    e = q;
+                    q = solListNode_next(q);
+                    qs--;
+                }
+                if (t) {
+                    solListNode_set_next(t, e);
+                } else {
+                    h = e;
+                }
+                t = e;
+            }
+            p = q;
+        }
+        solListNode_set_next(t, NULL);
+        rs = rs * 2;
+    } while (mc > 1);
+    solList_set_head(l, h);
+    solList_set_tail(l, t);
+    return 0;
+}
+
+int _solList_val_equal(void *v1, void *v2)
+{
+    if (v1 == v2) {
+        return 0;
+    }
+    return 1;
+}
+
 int solList_attach(SolList *l1, SolList *l2)
 {
     if (l1 == NULL || l2 == NULL) {
         return -1;
     }
+    if (solList_pool(l1) != solList_pool(l2) || solList_allocator(l1) != solList_allocator(l2)) {
+        // nodes must go back to the pool or allocator they came from, copy values instead
+        if (solList_merge(l1, l2) != 0) {
+            return 1;
+        }
+        solList_set_val_free_func(l2, NULL);
+        solList_free(l2);
+        return 0;
+    }
     if (solList_head(l1) == NULL) {
         solList_set_head(l1, solList_head(l2));
         goto finish;
@@ -193,7 +413,9 @@ int solList_merge(SolList *l1, SolList *l2)
 SolList* solList_dup(SolList *l)
 {
     if (l == NULL) return NULL;
-    SolList *l1 = solList_new();
+    SolList *l1 = solList_new_with_allocator(solList_allocator(l));
+    if (l1 == NULL) return NULL;
+    solList_set_pool(l1, solList_pool(l));
     if (solList_len(l) == 0) return l1;
     SolListNode *n = solList_head(l);
     do {
@@ -218,13 +440,17 @@ void solListNode_free(SolList *l, SolListNode *n)
     if (solListVal_free_func(l)) {
         solListVal_free(l, solListNode_val(n));
     }
-    sol_free(n);
+    if (solList_pool(l)) {
+        solPool_recycle(solList_pool(l), n);
+    } else {
+        solAllocator_free(solList_allocator(l), n);
+    }
 }
 
 SolListIter* solListIter_new(SolList *l)
 {
     if (l == NULL) return NULL;
-    SolListIter *i = sol_alloc(sizeof(SolListIter));
+    SolListIter *i = solAllocator_alloc(solList_allocator(l), sizeof(SolListIter));
     if (i == NULL) return NULL;
     i->l = l;
     i->n = solList_head(l);
@@ -233,7 +459,7 @@ SolListIter* solListIter_new(SolList *l)
 
 void solListIter_free(SolListIter *i)
 {
-    if (i) sol_free(i);
+    if (i) solAllocator_free(solList_allocator(i->l), i);
 }
 
 SolListNode* solListIter_current(SolListIter *i)
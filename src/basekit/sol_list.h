@@ -2,6 +2,9 @@
 #define _SOL_SLIST_H_ 1
 
 #include "sol_common.h"
+#include "sol_hash.h"
+#include "sol_pool.h"
+#include "sol_allocator.h"
 
 typedef struct _SolListNode {
     void *val;
@@ -15,6 +18,8 @@ typedef struct _SolList {
     void *(*f_dup)(void*);
     void (*f_free)(void*);
     int (*f_match)(void*, void*);
+    SolPool *pool; // node pool
+    SolAllocator *a; // allocator, NULL for sol_alloc
 } SolList;
 
 typedef struct _SolListIter {
@@ -36,6 +41,10 @@ typedef struct _SolListIter {
 #define solList_set_val_free_func(l, f) (l)->f_free = f
 #define solList_set_val_match_func(l, f) (l)->f_match = f
 
+#define solList_pool(l) (l)->pool
+#define solList_allocator(l) (l)->a
+#define solList_pool_new(c) solPool_new(sizeof(SolListNode), c)
+
 #define solListVal_free_func(l) (l)->f_free
 #define solListVal_match_func(l) (l)->f_match
 
@@ -49,6 +58,7 @@ typedef struct _SolListIter {
 #define solListNode_next(n) (n)->next
 
 SolList* solList_new();
+SolList* solList_new_with_allocator(SolAllocator*);
 void solList_free(SolList*);
 SolListNode* solList_add(SolList*, void*);
 int solList_del_node(SolList*, SolListNode*);
@@ -57,7 +67,12 @@ int solList_has(SolList*, void*);
 int solList_attach(SolList*, SolList*);
 int solList_merge(SolList*, SolList*);
 SolList* solList_dup(SolList*);
+int solList_set_pool(SolList*, SolPool*);
 int solList_uniq(SolList*);
+int solList_uniq_hashed(SolList*, sol_f_hash_ptr, sol_f_hash_ptr);
+int solList_uniq_sorted(SolList*);
+int solList_sort(SolList*, sol_f_cmp_ptr);
+int _solList_val_equal(void*, void*);
 
 SolListNode* solListNode_new();
 void solListNode_free(SolList*, SolListNode*);
@@ -0,0 +1,329 @@
+#include "sol_lru.h"
+
+/**
+ * cap is the total cost the cache may hold
+ * set the hash and equal funcs of keys before use
+ */
+SolLRU* solLRU_new(size_t cap)
+{
+    SolLRU *c = sol_calloc(1, sizeof(SolLRU));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->cap = cap;
+    c->h = solHash_new();
+    c->l = solDlList_new();
+    c->ep = solPool_new(sizeof(SolLRUEntry), 0);
+    if (c->h == NULL || c->l == NULL || c->ep == NULL) {
+        goto oops;
+    }
+    SolPool *p = solDlList_pool_new(0);
+    if (p == NULL) {
+        goto oops;
+    }
+    solDlList_set_pool(c->l, p);
+    solPool_free(p);
+    return c;
+oops:
+    if (c->h) {
+        solHash_free(c->h);
+    }
+    if (c->l) {
+        solDlList_free(c->l);
+    }
+    if (c->ep) {
+        solPool_free(c->ep);
+    }
+    sol_free(c);
+    return NULL;
+}
+
+void solLRU_free(SolLRU *c)
+{
+    SolDlListNode *n;
+    SolLRUEntry *e;
+    if (c->f_evict) {
+        for (n = solDlList_head(c->l); n; n = solDlListNode_next(n)) {
+            e = solDlListNode_val(n);
+            (*c->f_evict)(e->k, e->v);
+        }
+    }
+    solHash_free(c->h);
+    solDlList_free(c->l);
+    solPool_free(c->ep);
+    sol_free(c);
+}
+
+/**
+ * find the val of k and mark it most recently used
+ */
+void* solLRU_get(SolLRU *c, void *k)
+{
+    SolDlListNode *n = solHash_get(c->h, k);
+    if (n == NULL) {
+        c->miss++;
+        return NULL;
+    }
+    c->hit++;
+    solDlList_move_to_head(c->l, n);
+    return ((SolLRUEntry*)solDlListNode_val(n))->v;
+}
+
+/**
+ * find the val of k, leave the order and the counters alone
+ */
+void* solLRU_peek(SolLRU *c, void *k)
+{
+    SolDlListNode *n = solHash_get(c->h, k);
+    if (n == NULL) {
+        return NULL;
+    }
+    return ((SolLRUEntry*)solDlListNode_val(n))->v;
+}
+
+/**
+ * put k => v of cost s, evicting the least recently used entries to make room
+ * a replaced pair goes to the evict func too
+ * return 1 when s alone is over capacity
+ */
+int solLRU_put(SolLRU *c, void *k, void *v, size_t s)
+{
+    if (s > c->cap) {
+        return 1;
+    }
+    SolLRUEntry *e;
+    SolHashRecord *r = solHash_find_record_by_key(c->h, k);
+    SolDlListNode *n;
+    if (r) {
+        n = r->v;
+        e = solDlListNode_val(n);
+        if (c->f_evict && (e->k != k || e->v != v)) {
+            (*c->f_evict)(e->k, e->v);
+        }
+        r->k = k;
+        e->k = k;
+        e->v = v;
+        c->u = c->u - e->s + s;
+        e->s = s;
+        solDlList_move_to_head(c->l, n);
+    } else {
+        e = solPool_alloc(c->ep);
+        if (e == NULL) {
+            return 2;
+        }
+        e->k = k;
+        e->v = v;
+        e->s = s;
+        n = solDlList_add_bak(c->l, e);
+        if (n == NULL) {
+            solPool_recycle(c->ep, e);
+            return 2;
+        }
+        if (solHash_put(c->h, k, n)) {
+            solDlList_del_node(c->l, n);
+            solPool_recycle(c->ep, e);
+            return 3;
+        }
+        c->u += s;
+    }
+    while (c->u > c->cap) {
+        solLRU_evict(c);
+    }
+    return 0;
+}
+
+/**
+ * return 1 when k is not in the cache
+ */
+int solLRU_remove(SolLRU *c, void *k)
+{
+    SolDlListNode *n = solHash_get(c->h, k);
+    if (n == NULL) {
+        return 1;
+    }
+    _solLRU_drop(c, n);
+    return 0;
+}
+
+/**
+ * evict the least recently used entry, return 1 when empty
+ */
+int solLRU_evict(SolLRU *c)
+{
+    SolDlListNode *n = solDlList_tail(c->l);
+    if (n == NULL) {
+        return 1;
+    }
+    c->ev++;
+    _solLRU_drop(c, n);
+    return 0;
+}
+
+void _solLRU_drop(SolLRU *c, SolDlListNode *n)
+{
+    SolLRUEntry *e = solDlListNode_val(n);
+    solHash_remove(c->h, e->k);
+    c->u -= e->s;
+    if (c->f_evict) {
+        (*c->f_evict)(e->k, e->v);
+    }
+    solDlList_del_node(c->l, n);
+    solPool_recycle(c->ep, e);
+}
+
+/**
+ * cache of n entries
+ * get only reads the hash and sets a flag, so readers can share a read lock
+ * put and remove need the cache to themselves
+ */
+SolClockCache* solClockCache_new(size_t n)
+{
+    if (n == 0) {
+        return NULL;
+    }
+    SolClockCache *c = sol_calloc(1, sizeof(SolClockCache));
+    if (c == NULL) {
+        return NULL;
+    }
+    c->n = n;
+    c->sl = sol_calloc(n, sizeof(SolClockCacheSlot));
+    c->h = solHash_new();
+    if (c->sl == NULL || c->h == NULL) {
+        goto oops;
+    }
+    atomic_init(&c->hit, 0);
+    atomic_init(&c->miss, 0);
+    // room for all keys without growing on the way
+    size_t s = SOL_HASH_INIT_SIZE;
+    while (s < n * 2) {
+        s <<= 1;
+    }
+    if (solHash_resize(c->h, s)) {
+        goto oops;
+    }
+    return c;
+oops:
+    if (c->sl) {
+        sol_free(c->sl);
+    }
+    if (c->h) {
+        solHash_free(c->h);
+    }
+    sol_free(c);
+    return NULL;
+}
+
+void solClockCache_free(SolClockCache *c)
+{
+    size_t i;
+    if (c->f_evict) {
+        for (i = 0; i < c->n; i++) {
+            if (c->sl[i].k) {
+                (*c->f_evict)(c->sl[i].k, c->sl[i].v);
+            }
+        }
+    }
+    solHash_free(c->h);
+    sol_free(c->sl);
+    sol_free(c);
+}
+
+void* solClockCache_get(SolClockCache *c, void *k)
+{
+    SolClockCacheSlot *sl = solHash_get(c->h, k);
+    if (sl == NULL) {
+        atomic_fetch_add_explicit(&c->miss, 1, memory_order_relaxed);
+        return NULL;
+    }
+    atomic_fetch_add_explicit(&c->hit, 1, memory_order_relaxed);
+    // a slot already referenced is not written again
+    if (atomic_load_explicit(&sl->r, memory_order_relaxed) == 0) {
+        atomic_store_explicit(&sl->r, 1, memory_order_relaxed);
+    }
+    return sl->v;
+}
+
+/**
+ * put k => v, a full cache evicts the first slot the hand finds unreferenced
+ * a replaced pair goes to the evict func too
+ */
+int solClockCache_put(SolClockCache *c, void *k, void *v)
+{
+    SolHashRecord *r = solHash_find_record_by_key(c->h, k);
+    SolClockCacheSlot *sl;
+    if (r) {
+        sl = r->v;
+        if (c->f_evict && (sl->k != k || sl->v != v)) {
+            (*c->f_evict)(sl->k, sl->v);
+        }
+        r->k = k;
+        sl->k = k;
+        sl->v = v;
+        atomic_store_explicit(&sl->r, 1, memory_order_relaxed);
+        return 0;
+    }
+    sl = _solClockCache_victim(c);
+    if (sl->k) {
+        c->ev++;
+        solHash_remove(c->h, sl->k);
+        if (c->f_evict) {
+            (*c->f_evict)(sl->k, sl->v);
+        }
+        c->c--;
+    }
+    if (solHash_put(c->h, k, sl)) {
+        sl->k = NULL;
+        return 3;
+    }
+    sl->k = k;
+    sl->v = v;
+    atomic_store_explicit(&sl->r, 0, memory_order_relaxed);
+    c->c++;
+    return 0;
+}
+
+/**
+ * return 1 when k is not in the cache
+ */
+int solClockCache_remove(SolClockCache *c, void *k)
+{
+    SolClockCacheSlot *sl = solHash_get(c->h, k);
+    if (sl == NULL) {
+        return 1;
+    }
+    solHash_remove(c->h, k);
+    if (c->f_evict) {
+        (*c->f_evict)(sl->k, sl->v);
+    }
+    sl->k = NULL;
+    sl->v = NULL;
+    c->c--;
+    return 0;
+}
+
+/**
+ * a free slot while there is one, otherwise sweep the hand to a slot
+ * not referenced since the last sweep, clearing the flags it passes
+ */
+SolClockCacheSlot* _solClockCache_victim(SolClockCache *c)
+{
+    SolClockCacheSlot *sl;
+    if (c->c < c->n) {
+        while (c->sl[c->hd].k) {
+            if (++c->hd == c->n) {
+                c->hd = 0;
+            }
+        }
+        return &c->sl[c->hd];
+    }
+    for (;;) {
+        sl = &c->sl[c->hd];
+        if (++c->hd == c->n) {
+            c->hd = 0;
+        }
+        if (atomic_load_explicit(&sl->r, memory_order_relaxed) == 0) {
+            return sl;
+        }
+        atomic_store_explicit(&sl->r, 0, memory_order_relaxed);
+    }
+}
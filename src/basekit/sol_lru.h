@@ -0,0 +1,93 @@
+#ifndef _SOL_LRU_H_
+#define _SOL_LRU_H_ 1
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sol_common.h"
+#include "sol_hash.h"
+#include "sol_dl_list.h"
+#include "sol_pool.h"
+
+// gets key and val of every pair leaving the cache
+typedef void (*sol_f_evict_ptr)(void*, void*);
+
+typedef struct _SolLRUEntry {
+    void *k; // key
+    void *v; // val
+    size_t s; // cost
+} SolLRUEntry;
+
+// least recently used cache, capacity counts entry costs
+typedef struct _SolLRU {
+    size_t cap; // capacity
+    size_t u; // used
+    size_t hit; // hits
+    size_t miss; // misses
+    size_t ev; // evictions
+    SolHash *h; // key => list node
+    SolDlList *l; // entries, most recent at the head
+    SolPool *ep; // entry pool
+    sol_f_evict_ptr f_evict;
+} SolLRU;
+
+SolLRU* solLRU_new(size_t);
+void solLRU_free(SolLRU*);
+void* solLRU_get(SolLRU*, void*);
+void* solLRU_peek(SolLRU*, void*);
+int solLRU_put(SolLRU*, void*, void*, size_t);
+int solLRU_remove(SolLRU*, void*);
+int solLRU_evict(SolLRU*);
+void _solLRU_drop(SolLRU*, SolDlListNode*);
+
+#define solLRU_count(x) solDlList_len((x)->l)
+#define solLRU_used(x) (x)->u
+#define solLRU_capacity(x) (x)->cap
+#define solLRU_hits(x) (x)->hit
+#define solLRU_misses(x) (x)->miss
+#define solLRU_evictions(x) (x)->ev
+// count based capacity, every entry costs 1
+#define solLRU_add(x, k, v) solLRU_put(x, k, v, 1)
+
+#define solLRU_set_evict_func(x, f) (x)->f_evict = f
+#define solLRU_set_hash_func1(x, f) solHash_set_hash_func1((x)->h, f)
+#define solLRU_set_hash_func2(x, f) solHash_set_hash_func2((x)->h, f)
+#define solLRU_set_equal_func(x, f) solHash_set_equal_func((x)->h, f)
+
+typedef struct _SolClockCacheSlot {
+    void *k; // key, NULL when free
+    void *v; // val
+    _Atomic unsigned char r; // referenced since the hand last passed
+} SolClockCacheSlot;
+
+// second chance cache, a hit only sets the referenced flag of its slot
+typedef struct _SolClockCache {
+    size_t n; // slots
+    size_t c; // count
+    size_t hd; // hand
+    _Atomic size_t hit; // hits
+    _Atomic size_t miss; // misses
+    size_t ev; // evictions
+    SolClockCacheSlot *sl; // slots
+    SolHash *h; // key => slot
+    sol_f_evict_ptr f_evict;
+} SolClockCache;
+
+SolClockCache* solClockCache_new(size_t);
+void solClockCache_free(SolClockCache*);
+void* solClockCache_get(SolClockCache*, void*);
+int solClockCache_put(SolClockCache*, void*, void*);
+int solClockCache_remove(SolClockCache*, void*);
+SolClockCacheSlot* _solClockCache_victim(SolClockCache*);
+
+#define solClockCache_count(x) (x)->c
+#define solClockCache_capacity(x) (x)->n
+#define solClockCache_hits(x) atomic_load_explicit(&(x)->hit, memory_order_relaxed)
+#define solClockCache_misses(x) atomic_load_explicit(&(x)->miss, memory_order_relaxed)
+#define solClockCache_evictions(x) (x)->ev
+
+#define solClockCache_set_evict_func(x, f) (x)->f_evict = f
+#define solClockCache_set_hash_func1(x, f) solHash_set_hash_func1((x)->h, f)
+#define solClockCache_set_hash_func2(x, f) solHash_set_hash_func2((x)->h, f)
+#define solClockCache_set_equal_func(x, f) solHash_set_equal_func((x)->h, f)
+
+#endif
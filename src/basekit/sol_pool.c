@@ -0,0 +1,69 @@
+#include "sol_pool.h"
+
+/**
+ * pool of fixed size slots, carved from chunks of c slots
+ * the pool is reference counted, solPool_free drops one reference
+ */
+SolPool* solPool_new(size_t s, size_t c)
+{
+    SolPool *p = sol_calloc(1, sizeof(SolPool));
+    if (p == NULL) {
+        return NULL;
+    }
+    // slot must hold the free list link, keep slots pointer aligned
+    if (s < sizeof(void*)) {
+        s = sizeof(void*);
+    }
+    s = (s + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    p->s = s;
+    p->c = c ? c : SOL_POOL_CHUNK_SLOTS;
+    p->r = 1;
+    return p;
+}
+
+void solPool_free(SolPool *p)
+{
+    if (p == NULL || --p->r > 0) {
+        return;
+    }
+    SolPoolChunk *ch = p->ch;
+    SolPoolChunk *n;
+    while (ch) {
+        n = ch->n;
+        sol_free(ch);
+        ch = n;
+    }
+    sol_free(p);
+}
+
+void* solPool_alloc(SolPool *p)
+{
+    void *x;
+    if (p->fl) {
+        x = p->fl;
+        p->fl = *(void**)x;
+    } else {
+        if (p->bp == p->be) {
+            size_t hs = (sizeof(SolPoolChunk) + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+            SolPoolChunk *ch = sol_alloc(hs + p->s * p->c);
+            if (ch == NULL) {
+                return NULL;
+            }
+            ch->n = p->ch;
+            p->ch = ch;
+            p->bp = (char*)ch + hs;
+            p->be = p->bp + p->s * p->c;
+        }
+        x = p->bp;
+        p->bp += p->s;
+    }
+    p->u++;
+    return x;
+}
+
+void solPool_recycle(SolPool *p, void *x)
+{
+    *(void**)x = p->fl;
+    p->fl = x;
+    p->u--;
+}
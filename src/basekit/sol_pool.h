@@ -0,0 +1,34 @@
+#ifndef _SOL_POOL_H_
+#define _SOL_POOL_H_ 1
+
+#include <stddef.h>
+#include "sol_common.h"
+
+#define SOL_POOL_CHUNK_SLOTS 64
+
+typedef struct _SolPoolChunk {
+    struct _SolPoolChunk *n; // next chunk
+} SolPoolChunk;
+
+typedef struct _SolPool {
+    size_t s; // slot size
+    size_t c; // slots per chunk
+    size_t u; // used slots
+    size_t r; // references
+    void *fl; // free list
+    char *bp; // bump pointer in newest chunk
+    char *be; // end of newest chunk
+    SolPoolChunk *ch; // chunks
+} SolPool;
+
+SolPool* solPool_new(size_t, size_t);
+void solPool_free(SolPool*);
+void* solPool_alloc(SolPool*);
+void solPool_recycle(SolPool*, void*);
+
+#define solPool_slot_size(p) (p)->s
+#define solPool_used(p) (p)->u
+#define solPool_ref(p) (p)->r++
+#define solPool_is_shared(p) ((p)->r > 1)
+
+#endif
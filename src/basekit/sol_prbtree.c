@@ -0,0 +1,472 @@
+#include "sol_prbtree.h"
+
+SolPRBTree* solPRBTree_new()
+{
+    return solPRBTree_new_with_allocator(NULL);
+}
+
+/**
+ * tree whose handles and nodes come from allocator a, a must be safe to free into
+ * from every thread that lets go of a snapshot
+ */
+SolPRBTree* solPRBTree_new_with_allocator(SolAllocator *a)
+{
+    SolPRBTree *t = solAllocator_calloc(a, 1, sizeof(SolPRBTree));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->a = a;
+    return t;
+}
+
+/**
+ * read only version of t as it is now, in O(1)
+ * take it on the thread updating t, then hand it to any reader
+ */
+SolPRBTree* solPRBTree_snapshot(SolPRBTree *t)
+{
+    SolPRBTree *s = solAllocator_calloc(solPRBTree_allocator(t), 1, sizeof(SolPRBTree));
+    if (s == NULL) {
+        return NULL;
+    }
+    s->c = t->c;
+    s->root = _solPRBTree_retain(t->root);
+    s->f_compare = t->f_compare;
+    s->a = t->a;
+    return s;
+}
+
+/**
+ * let go of this version, nodes no other version holds are freed
+ */
+void solPRBTree_free(SolPRBTree *t)
+{
+    SolPRBTreeNode *n;
+    _solPRBTree_release(t, t->root);
+    while ((n = t->sp)) {
+        t->sp = n->l;
+        solAllocator_free(solPRBTree_allocator(t), n);
+    }
+    solAllocator_free(solPRBTree_allocator(t), t);
+}
+
+/**
+ * @return 0 inserted, -1 an equal val is already there, 1 out of memory, the tree is untouched then
+ */
+int solPRBTree_insert(SolPRBTree *t, void *val)
+{
+    if (_solPRBTree_find(t, val)) {
+        return -1;
+    }
+    // a copy per node on the path, the new leaf and the root
+    if (_solPRBTree_reserve(t, 2 * _solPRBTree_black_height(t) + 4)) {
+        return 1;
+    }
+    t->root = _solPRBTree_blacken(t, _solPRBTree_ins(t, t->root, val));
+    t->c++;
+    return 0;
+}
+
+/**
+ * @return 0 deleted, -1 no equal val, 1 out of memory, the tree is untouched then
+ */
+int solPRBTree_del(SolPRBTree *t, void *val)
+{
+    if (_solPRBTree_find(t, val) == NULL) {
+        return -1;
+    }
+    // the path down to val and on down both spines below it, a few nodes rebuilt per level
+    size_t n = 8 * (2 * _solPRBTree_black_height(t) + 2);
+    if (_solPRBTree_reserve(t, n)) {
+        return 1;
+    }
+    t->root = _solPRBTree_blacken(t, _solPRBTree_del(t, t->root, val));
+    t->c--;
+    // the deleted node came back as a spare, keep no more than an update needs
+    while (t->sc > n) {
+        SolPRBTreeNode *s = t->sp;
+        t->sp = s->l;
+        t->sc--;
+        solAllocator_free(solPRBTree_allocator(t), s);
+    }
+    return 0;
+}
+
+SolPRBTreeNode* _solPRBTree_find(SolPRBTree *t, void *val)
+{
+    int w;
+    SolPRBTreeNode *n = t->root;
+    while (n) {
+        w = solPRBTree_val_compare(t, val, n->val);
+        if (w == 0) {
+            break;
+        }
+        n = w < 0 ? n->l : n->r;
+    }
+    return n;
+}
+
+void* solPRBTree_search(SolPRBTree *t, void *val)
+{
+    SolPRBTreeNode *n = _solPRBTree_find(t, val);
+    return n ? n->val : NULL;
+}
+
+void* solPRBTree_min(SolPRBTree *t)
+{
+    SolPRBTreeNode *n = t->root;
+    if (n == NULL) {
+        return NULL;
+    }
+    while (n->l) {
+        n = n->l;
+    }
+    return n->val;
+}
+
+void* solPRBTree_max(SolPRBTree *t)
+{
+    SolPRBTreeNode *n = t->root;
+    if (n == NULL) {
+        return NULL;
+    }
+    while (n->r) {
+        n = n->r;
+    }
+    return n->val;
+}
+
+/**
+ * vals in order, stop at the first f returning non 0 and return that
+ */
+int solPRBTree_travelsal_inorder(SolPRBTree *t, solPRBTree_f_ptr_act f, void *d)
+{
+    SolPRBTreeNode *s[SOL_RBTREE_MAX_HEIGHT];
+    SolPRBTreeNode *n = t->root;
+    size_t k = 0;
+    int r;
+    for (;;) {
+        for (; n; n = n->l) {
+            s[k++] = n;
+        }
+        if (k == 0) {
+            return 0;
+        }
+        n = s[--k];
+        r = (*f)(t, n->val, d);
+        if (r != 0) {
+            return r;
+        }
+        n = n->r;
+    }
+}
+
+/**
+ * make sure n spare nodes are at hand
+ */
+int _solPRBTree_reserve(SolPRBTree *t, size_t n)
+{
+    SolPRBTreeNode *s;
+    while (t->sc < n) {
+        s = solAllocator_alloc(solPRBTree_allocator(t), sizeof(SolPRBTreeNode));
+        if (s == NULL) {
+            return 1;
+        }
+        s->l = t->sp;
+        t->sp = s;
+        t->sc++;
+    }
+    return 0;
+}
+
+size_t _solPRBTree_black_height(SolPRBTree *t)
+{
+    size_t h = 0;
+    SolPRBTreeNode *n;
+    for (n = t->root; n; n = n->l) {
+        if (n->col == _SolRBTreeCol_black) {
+            h++;
+        }
+    }
+    return h;
+}
+
+SolPRBTreeNode* _solPRBTree_retain(SolPRBTreeNode *n)
+{
+    if (n) {
+        atomic_fetch_add_explicit(&n->rc, 1, memory_order_relaxed);
+    }
+    return n;
+}
+
+void _solPRBTree_release(SolPRBTree *t, SolPRBTreeNode *n)
+{
+    if (n && atomic_fetch_sub_explicit(&n->rc, 1, memory_order_acq_rel) == 1) {
+        _solPRBTree_release(t, n->l);
+        _solPRBTree_release(t, n->r);
+        solAllocator_free(solPRBTree_allocator(t), n);
+    }
+}
+
+/**
+ * take apart a node the caller holds one reference on, children come back held
+ * @return the node itself to build on when no one else holds it, else NULL
+ */
+SolPRBTreeNode* _solPRBTree_open(SolPRBTree *t, SolPRBTreeNode *n,
+                                 SolPRBTreeNode **l, void **val, SolPRBTreeNode **r)
+{
+    *l = n->l;
+    *val = n->val;
+    *r = n->r;
+    if (atomic_load_explicit(&n->rc, memory_order_acquire) == 1) {
+        return n;
+    }
+    // shared with another version, leave it be
+    _solPRBTree_retain(*l);
+    _solPRBTree_retain(*r);
+    _solPRBTree_release(t, n);
+    return NULL;
+}
+
+/**
+ * node from held children, built in shell s when there is one, else in a spare
+ */
+SolPRBTreeNode* _solPRBTree_make(SolPRBTree *t, SolPRBTreeNode *s, enum _SolRBTreeCol col,
+                                 SolPRBTreeNode *l, void *val, SolPRBTreeNode *r)
+{
+    if (s == NULL) {
+        s = t->sp;
+        t->sp = s->l;
+        t->sc--;
+        atomic_init(&s->rc, 1);
+    }
+    s->col = col;
+    s->l = l;
+    s->val = val;
+    s->r = r;
+    return s;
+}
+
+/**
+ * shell no longer needed goes back to the spares
+ */
+void _solPRBTree_give(SolPRBTree *t, SolPRBTreeNode *s)
+{
+    s->l = t->sp;
+    t->sp = s;
+    t->sc++;
+}
+
+SolPRBTreeNode* _solPRBTree_blacken(SolPRBTree *t, SolPRBTreeNode *n)
+{
+    SolPRBTreeNode *l, *r, *s;
+    void *v;
+    if (_solPRBTreeNode_is_red(n) == 0) {
+        return n;
+    }
+    s = _solPRBTree_open(t, n, &l, &v, &r);
+    return _solPRBTree_make(t, s, _SolRBTreeCol_black, l, v, r);
+}
+
+/**
+ * black node of l, v and r with at most one red red pair below it, rebuilt without it
+ * rr also splits a node with two red children, as deletion expects
+ */
+SolPRBTreeNode* _solPRBTree_balance(SolPRBTree *t, SolPRBTreeNode *s,
+                                    SolPRBTreeNode *l, void *v, SolPRBTreeNode *r, int rr)
+{
+    SolPRBTreeNode *a, *b, *c, *d, *m, *s1, *s2;
+    void *x, *y;
+    if (rr && _solPRBTreeNode_is_red(l) && _solPRBTreeNode_is_red(r)) {
+        s1 = _solPRBTree_open(t, l, &a, &x, &b);
+        s2 = _solPRBTree_open(t, r, &c, &y, &d);
+        return _solPRBTree_make(t, s, _SolRBTreeCol_red,
+                                _solPRBTree_make(t, s1, _SolRBTreeCol_black, a, x, b), v,
+                                _solPRBTree_make(t, s2, _SolRBTreeCol_black, c, y, d));
+    }
+    if (_solPRBTreeNode_is_red(l) && _solPRBTreeNode_is_red(l->l)) {
+        s1 = _solPRBTree_open(t, l, &m, &y, &c);
+        s2 = _solPRBTree_open(t, m, &a, &x, &b);
+        return _solPRBTree_make(t, s1, _SolRBTreeCol_red,
+                                _solPRBTree_make(t, s2, _SolRBTreeCol_black, a, x, b), y,
+                                _solPRBTree_make(t, s, _SolRBTreeCol_black, c, v, r));
+    }
+    if (_solPRBTreeNode_is_red(l) && _solPRBTreeNode_is_red(l->r)) {
+        s1 = _solPRBTree_open(t, l, &a, &x, &m);
+        s2 = _solPRBTree_open(t, m, &b, &y, &c);
+        return _solPRBTree_make(t, s2, _SolRBTreeCol_red,
+                                _solPRBTree_make(t, s1, _SolRBTreeCol_black, a, x, b), y,
+                                _solPRBTree_make(t, s, _SolRBTreeCol_black, c, v, r));
+    }
+    if (_solPRBTreeNode_is_red(r) && _solPRBTreeNode_is_red(r->l)) {
+        s1 = _solPRBTree_open(t, r, &m, &y, &d);
+        s2 = _solPRBTree_open(t, m, &b, &x, &c);
+        return _solPRBTree_make(t, s2, _SolRBTreeCol_red,
+                                _solPRBTree_make(t, s, _SolRBTreeCol_black, l, v, b), x,
+                                _solPRBTree_make(t, s1, _SolRBTreeCol_black, c, y, d));
+    }
+    if (_solPRBTreeNode_is_red(r) && _solPRBTreeNode_is_red(r->r)) {
+        s1 = _solPRBTree_open(t, r, &b, &x, &m);
+        s2 = _solPRBTree_open(t, m, &c, &y, &d);
+        return _solPRBTree_make(t, s1, _SolRBTreeCol_red,
+                                _solPRBTree_make(t, s, _SolRBTreeCol_black, l, v, b), x,
+                                _solPRBTree_make(t, s2, _SolRBTreeCol_black, c, y, d));
+    }
+    return _solPRBTree_make(t, s, _SolRBTreeCol_black, l, v, r);
+}
+
+/**
+ * subtree n with val added, val is known not to be there
+ */
+SolPRBTreeNode* _solPRBTree_ins(SolPRBTree *t, SolPRBTreeNode *n, void *val)
+{
+    SolPRBTreeNode *l, *r, *s;
+    void *v;
+    if (n == NULL) {
+        return _solPRBTree_make(t, NULL, _SolRBTreeCol_red, NULL, val, NULL);
+    }
+    enum _SolRBTreeCol col = n->col;
+    int w = solPRBTree_val_compare(t, val, n->val);
+    s = _solPRBTree_open(t, n, &l, &v, &r);
+    if (w < 0) {
+        l = _solPRBTree_ins(t, l, val);
+    } else {
+        r = _solPRBTree_ins(t, r, val);
+    }
+    if (col == _SolRBTreeCol_black) {
+        return _solPRBTree_balance(t, s, l, v, r, 0);
+    }
+    return _solPRBTree_make(t, s, _SolRBTreeCol_red, l, v, r);
+}
+
+/**
+ * subtree n without val, val is known to be there
+ * a black n comes back one black shorter, maybe with a red root
+ */
+SolPRBTreeNode* _solPRBTree_del(SolPRBTree *t, SolPRBTreeNode *n, void *val)
+{
+    SolPRBTreeNode *l, *r, *s;
+    void *v;
+    if (n == NULL) {
+        return NULL;
+    }
+    int w = solPRBTree_val_compare(t, val, n->val);
+    int lb = _solPRBTreeNode_is_black(n->l);
+    int rb = _solPRBTreeNode_is_black(n->r);
+    s = _solPRBTree_open(t, n, &l, &v, &r);
+    if (w < 0) {
+        l = _solPRBTree_del(t, l, val);
+        if (lb) {
+            return _solPRBTree_balleft(t, s, l, v, r);
+        }
+        return _solPRBTree_make(t, s, _SolRBTreeCol_red, l, v, r);
+    }
+    if (w > 0) {
+        r = _solPRBTree_del(t, r, val);
+        if (rb) {
+            return _solPRBTree_balright(t, s, l, v, r);
+        }
+        return _solPRBTree_make(t, s, _SolRBTreeCol_red, l, v, r);
+    }
+    if (s) {
+        _solPRBTree_give(t, s);
+    }
+    return _solPRBTree_app(t, l, r);
+}
+
+/**
+ * node of bl, x and r where bl is one black shorter than r
+ */
+SolPRBTreeNode* _solPRBTree_balleft(SolPRBTree *t, SolPRBTreeNode *s,
+                                    SolPRBTreeNode *bl, void *x, SolPRBTreeNode *r)
+{
+    SolPRBTreeNode *a, *b, *c, *m, *s1, *s2;
+    void *y, *z;
+    if (_solPRBTreeNode_is_red(bl)) {
+        s1 = _solPRBTree_open(t, bl, &a, &y, &b);
+        return _solPRBTree_make(t, s, _SolRBTreeCol_red, _solPRBTree_make(t, s1, _SolRBTreeCol_black, a, y, b), x, r);
+    }
+    if (_solPRBTreeNode_is_black(r)) {
+        s1 = _solPRBTree_open(t, r, &a, &y, &b);
+        return _solPRBTree_balance(t, s, bl, x, _solPRBTree_make(t, s1, _SolRBTreeCol_red, a, y, b), 1);
+    }
+    // r is red over a black left child
+    s1 = _solPRBTree_open(t, r, &m, &z, &c);
+    s2 = _solPRBTree_open(t, m, &a, &y, &b);
+    m = _solPRBTree_make(t, s2, _SolRBTreeCol_black, bl, x, a);
+    return _solPRBTree_make(t, s, _SolRBTreeCol_red, m, y,
+                            _solPRBTree_balance(t, s1, b, z, _solPRBTree_sub1(t, c), 1));
+}
+
+/**
+ * node of l, x and br where br is one black shorter than l
+ */
+SolPRBTreeNode* _solPRBTree_balright(SolPRBTree *t, SolPRBTreeNode *s,
+                                     SolPRBTreeNode *l, void *x, SolPRBTreeNode *br)
+{
+    SolPRBTreeNode *a, *b, *c, *m, *s1, *s2;
+    void *y, *z;
+    if (_solPRBTreeNode_is_red(br)) {
+        s1 = _solPRBTree_open(t, br, &b, &y, &c);
+        return _solPRBTree_make(t, s, _SolRBTreeCol_red, l, x, _solPRBTree_make(t, s1, _SolRBTreeCol_black, b, y, c));
+    }
+    if (_solPRBTreeNode_is_black(l)) {
+        s1 = _solPRBTree_open(t, l, &a, &y, &b);
+        return _solPRBTree_balance(t, s, _solPRBTree_make(t, s1, _SolRBTreeCol_red, a, y, b), x, br, 1);
+    }
+    // l is red over a black right child
+    s1 = _solPRBTree_open(t, l, &a, &y, &m);
+    s2 = _solPRBTree_open(t, m, &b, &z, &c);
+    m = _solPRBTree_make(t, s2, _SolRBTreeCol_black, c, x, br);
+    return _solPRBTree_make(t, s, _SolRBTreeCol_red,
+                            _solPRBTree_balance(t, s1, _solPRBTree_sub1(t, a), y, b, 1), z, m);
+}
+
+/**
+ * black node n turned red
+ */
+SolPRBTreeNode* _solPRBTree_sub1(SolPRBTree *t, SolPRBTreeNode *n)
+{
+    SolPRBTreeNode *l, *r, *s;
+    void *v;
+    s = _solPRBTree_open(t, n, &l, &v, &r);
+    return _solPRBTree_make(t, s, _SolRBTreeCol_red, l, v, r);
+}
+
+/**
+ * a and b glued together, every val of a is less than every val of b
+ */
+SolPRBTreeNode* _solPRBTree_app(SolPRBTree *t, SolPRBTreeNode *a, SolPRBTreeNode *b)
+{
+    SolPRBTreeNode *a1, *ab, *bc, *d, *m, *m1, *m2, *s1, *s2, *s3;
+    void *x, *y, *z;
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+    if (a->col == b->col) {
+        enum _SolRBTreeCol col = a->col;
+        s1 = _solPRBTree_open(t, a, &a1, &x, &ab);
+        s2 = _solPRBTree_open(t, b, &bc, &y, &d);
+        m = _solPRBTree_app(t, ab, bc);
+        if (_solPRBTreeNode_is_red(m)) {
+            s3 = _solPRBTree_open(t, m, &m1, &z, &m2);
+            return _solPRBTree_make(t, s3, _SolRBTreeCol_red,
+                                    _solPRBTree_make(t, s1, col, a1, x, m1), z,
+                                    _solPRBTree_make(t, s2, col, m2, y, d));
+        }
+        if (col == _SolRBTreeCol_red) {
+            return _solPRBTree_make(t, s1, _SolRBTreeCol_red, a1, x,
+                                    _solPRBTree_make(t, s2, _SolRBTreeCol_red, m, y, d));
+        }
+        return _solPRBTree_balleft(t, s1, a1, x, _solPRBTree_make(t, s2, _SolRBTreeCol_black, m, y, d));
+    }
+    if (b->col == _SolRBTreeCol_red) {
+        s1 = _solPRBTree_open(t, b, &bc, &y, &d);
+        return _solPRBTree_make(t, s1, _SolRBTreeCol_red, _solPRBTree_app(t, a, bc), y, d);
+    }
+    s1 = _solPRBTree_open(t, a, &a1, &x, &ab);
+    return _solPRBTree_make(t, s1, _SolRBTreeCol_red, a1, x, _solPRBTree_app(t, ab, b));
+}
@@ -0,0 +1,75 @@
+#ifndef _SOL_PRBTREE_H_
+#define _SOL_PRBTREE_H_ 1
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sol_common.h"
+#include "sol_allocator.h"
+#include "sol_rbtree.h"
+
+// nodes are never changed once another version can reach them
+typedef struct _SolPRBTreeNode {
+    struct _SolPRBTreeNode *l; // left, NULL for none
+    struct _SolPRBTreeNode *r; // right, NULL for none
+    void *val;
+    atomic_size_t rc; // parents and versions holding the node
+    enum _SolRBTreeCol col;
+} SolPRBTreeNode;
+
+/**
+ * one version of a persistent red black tree, versions share every node they have in common
+ * updates copy the path they change, a snapshot is a new handle on the same root
+ * vals belong to the caller, a deleted val may still be in older versions
+ */
+typedef struct _SolPRBTree {
+    size_t c; // count
+    SolPRBTreeNode *root;
+    SolPRBTreeNode *sp; // spare nodes linked through l, an update never runs out midway
+    size_t sc; // spare count
+    sol_f_cmp_ptr f_compare;
+    SolAllocator *a; // allocator, NULL for sol_alloc
+} SolPRBTree;
+
+typedef int (*solPRBTree_f_ptr_act)(SolPRBTree*, void*, void*);
+
+SolPRBTree* solPRBTree_new();
+SolPRBTree* solPRBTree_new_with_allocator(SolAllocator*);
+SolPRBTree* solPRBTree_snapshot(SolPRBTree*);
+void solPRBTree_free(SolPRBTree*);
+int solPRBTree_insert(SolPRBTree*, void*);
+int solPRBTree_del(SolPRBTree*, void*);
+void* solPRBTree_search(SolPRBTree*, void*);
+void* solPRBTree_min(SolPRBTree*);
+void* solPRBTree_max(SolPRBTree*);
+int solPRBTree_travelsal_inorder(SolPRBTree*, solPRBTree_f_ptr_act, void*);
+
+SolPRBTreeNode* _solPRBTree_find(SolPRBTree*, void*);
+int _solPRBTree_reserve(SolPRBTree*, size_t);
+size_t _solPRBTree_black_height(SolPRBTree*);
+SolPRBTreeNode* _solPRBTree_retain(SolPRBTreeNode*);
+void _solPRBTree_release(SolPRBTree*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_open(SolPRBTree*, SolPRBTreeNode*, SolPRBTreeNode**, void**, SolPRBTreeNode**);
+SolPRBTreeNode* _solPRBTree_make(SolPRBTree*, SolPRBTreeNode*, enum _SolRBTreeCol,
+                                 SolPRBTreeNode*, void*, SolPRBTreeNode*);
+void _solPRBTree_give(SolPRBTree*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_blacken(SolPRBTree*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_balance(SolPRBTree*, SolPRBTreeNode*, SolPRBTreeNode*, void*, SolPRBTreeNode*, int);
+SolPRBTreeNode* _solPRBTree_ins(SolPRBTree*, SolPRBTreeNode*, void*);
+SolPRBTreeNode* _solPRBTree_del(SolPRBTree*, SolPRBTreeNode*, void*);
+SolPRBTreeNode* _solPRBTree_balleft(SolPRBTree*, SolPRBTreeNode*, SolPRBTreeNode*, void*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_balright(SolPRBTree*, SolPRBTreeNode*, SolPRBTreeNode*, void*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_sub1(SolPRBTree*, SolPRBTreeNode*);
+SolPRBTreeNode* _solPRBTree_app(SolPRBTree*, SolPRBTreeNode*, SolPRBTreeNode*);
+
+#define solPRBTree_count(t) (t)->c
+#define solPRBTree_is_empty(t) ((t)->c == 0)
+#define solPRBTree_allocator(t) (t)->a
+
+#define solPRBTree_set_compare_func(t, f) (t)->f_compare = f
+#define solPRBTree_val_compare(t, v1, v2) (*(t)->f_compare)(v1, v2)
+
+#define _solPRBTreeNode_is_red(n) ((n) && (n)->col == _SolRBTreeCol_red)
+// a black node, NULL leaves do not count
+#define _solPRBTreeNode_is_black(n) ((n) && (n)->col == _SolRBTreeCol_black)
+
+#endif
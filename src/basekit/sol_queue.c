@@ -0,0 +1,465 @@
+#include <limits.h>
+#include "sol_queue.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#else
+#include <sched.h>
+#endif
+
+size_t _solQueue_round_size(size_t s)
+{
+    size_t r = SOL_QUEUE_MIN_SIZE;
+    while (r < s) {
+        r <<= 1;
+    }
+    return r;
+}
+
+void _solQueueEvent_init(SolQueueEvent *ev)
+{
+    atomic_init(&ev->e, 0);
+    atomic_init(&ev->w, 0);
+}
+
+/**
+ * register as a waiter before the last try on the queue
+ * return the event count to sleep on
+ */
+uint32_t _solQueueEvent_prepare(SolQueueEvent *ev)
+{
+    atomic_fetch_add_explicit(&ev->w, 1, memory_order_seq_cst);
+    atomic_thread_fence(memory_order_seq_cst);
+    return atomic_load_explicit(&ev->e, memory_order_acquire);
+}
+
+void _solQueueEvent_cancel(SolQueueEvent *ev)
+{
+    atomic_fetch_sub_explicit(&ev->w, 1, memory_order_relaxed);
+}
+
+/**
+ * sleep until the event count moves on from e
+ * returns at once if it already has
+ */
+void _solQueueEvent_sleep(SolQueueEvent *ev, uint32_t e)
+{
+#ifdef __linux__
+    syscall(SYS_futex, &ev->e, FUTEX_WAIT_PRIVATE, e, NULL, NULL, 0);
+#else
+    if (atomic_load_explicit(&ev->e, memory_order_acquire) == e) {
+        sched_yield();
+    }
+#endif
+    _solQueueEvent_cancel(ev);
+}
+
+/**
+ * wake up to n waiters, a fence and a load when nobody waits
+ */
+void _solQueueEvent_notify(SolQueueEvent *ev, size_t n)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ev->w, memory_order_relaxed) == 0) {
+        return;
+    }
+    atomic_fetch_add_explicit(&ev->e, 1, memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, &ev->e, FUTEX_WAKE_PRIVATE, n > INT_MAX ? INT_MAX : (int)n, NULL, NULL, 0);
+#endif
+}
+
+/**
+ * capacity is rounded up to a power of two
+ */
+SolMpmcQueue* solMpmcQueue_new(size_t s)
+{
+    SolMpmcQueue *q = sol_alloc(sizeof(SolMpmcQueue));
+    if (q == NULL) {
+        return NULL;
+    }
+    s = _solQueue_round_size(s);
+    q->b = sol_alloc(sizeof(SolMpmcQueueCell) * s);
+    if (q->b == NULL) {
+        sol_free(q);
+        return NULL;
+    }
+    size_t i;
+    for (i = 0; i < s; i++) {
+        atomic_init(&q->b[i].seq, i);
+        q->b[i].v = NULL;
+    }
+    q->m = s - 1;
+    atomic_init(&q->t, 0);
+    atomic_init(&q->h, 0);
+    _solQueueEvent_init(&q->ne);
+    _solQueueEvent_init(&q->nf);
+    return q;
+}
+
+void solMpmcQueue_free(SolMpmcQueue *q)
+{
+    sol_free(q->b);
+    sol_free(q);
+}
+
+/**
+ * return 1 when the queue is full
+ */
+int solMpmcQueue_enqueue(SolMpmcQueue *q, void *v)
+{
+    if (_solMpmcQueue_enqueue(q, v)) {
+        return 1;
+    }
+    _solQueueEvent_notify(&q->ne, 1);
+    return 0;
+}
+
+/**
+ * return 1 when the queue is empty
+ */
+int solMpmcQueue_dequeue(SolMpmcQueue *q, void **v)
+{
+    if (_solMpmcQueue_dequeue(q, v)) {
+        return 1;
+    }
+    _solQueueEvent_notify(&q->nf, 1);
+    return 0;
+}
+
+/**
+ * enqueue up to n vals with one claim of the tail
+ * return how many were enqueued, in order
+ */
+size_t solMpmcQueue_enqueue_batch(SolMpmcQueue *q, void **v, size_t n)
+{
+    size_t c = _solMpmcQueue_enqueue_batch(q, v, n);
+    if (c) {
+        _solQueueEvent_notify(&q->ne, c);
+    }
+    return c;
+}
+
+size_t solMpmcQueue_dequeue_batch(SolMpmcQueue *q, void **v, size_t n)
+{
+    size_t c = _solMpmcQueue_dequeue_batch(q, v, n);
+    if (c) {
+        _solQueueEvent_notify(&q->nf, c);
+    }
+    return c;
+}
+
+void solMpmcQueue_enqueue_wait(SolMpmcQueue *q, void *v)
+{
+    uint32_t e;
+    while (solMpmcQueue_enqueue(q, v)) {
+        e = _solQueueEvent_prepare(&q->nf);
+        if (solMpmcQueue_enqueue(q, v) == 0) {
+            _solQueueEvent_cancel(&q->nf);
+            return;
+        }
+        _solQueueEvent_sleep(&q->nf, e);
+    }
+}
+
+void* solMpmcQueue_dequeue_wait(SolMpmcQueue *q)
+{
+    void *v;
+    uint32_t e;
+    while (solMpmcQueue_dequeue(q, &v)) {
+        e = _solQueueEvent_prepare(&q->ne);
+        if (solMpmcQueue_dequeue(q, &v) == 0) {
+            _solQueueEvent_cancel(&q->ne);
+            break;
+        }
+        _solQueueEvent_sleep(&q->ne, e);
+    }
+    return v;
+}
+
+/**
+ * a cell is free for position pos when its sequence is pos,
+ * and holds the val of position pos when its sequence is pos + 1
+ */
+int _solMpmcQueue_enqueue(SolMpmcQueue *q, void *v)
+{
+    SolMpmcQueueCell *cell;
+    size_t pos = atomic_load_explicit(&q->t, memory_order_relaxed);
+    size_t seq;
+    for (;;) {
+        cell = &q->b[pos & q->m];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(&q->t, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - pos) < 0) {
+            return 1;
+        } else {
+            pos = atomic_load_explicit(&q->t, memory_order_relaxed);
+        }
+    }
+    cell->v = v;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return 0;
+}
+
+int _solMpmcQueue_dequeue(SolMpmcQueue *q, void **v)
+{
+    SolMpmcQueueCell *cell;
+    size_t pos = atomic_load_explicit(&q->h, memory_order_relaxed);
+    size_t seq;
+    for (;;) {
+        cell = &q->b[pos & q->m];
+        seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        if (seq == pos + 1) {
+            if (atomic_compare_exchange_weak_explicit(&q->h, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+            return 1;
+        } else {
+            pos = atomic_load_explicit(&q->h, memory_order_relaxed);
+        }
+    }
+    *v = cell->v;
+    atomic_store_explicit(&cell->seq, pos + q->m + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * count the run of free cells from the tail, then claim all of them
+ * with a single CAS, cells in the run can not be taken by anyone else
+ */
+size_t _solMpmcQueue_enqueue_batch(SolMpmcQueue *q, void **v, size_t n)
+{
+    size_t pos = atomic_load_explicit(&q->t, memory_order_relaxed);
+    size_t seq, c, i;
+    if (n == 0) {
+        return 0;
+    }
+    if (n > q->m + 1) {
+        n = q->m + 1;
+    }
+    for (;;) {
+        // n is at least 1, the first cell is always looked at
+        c = 0;
+        do {
+            seq = atomic_load_explicit(&q->b[(pos + c) & q->m].seq, memory_order_acquire);
+            if (seq != pos + c) {
+                break;
+            }
+        } while (++c < n);
+        if (c == 0) {
+            if ((ptrdiff_t)(seq - pos) < 0) {
+                return 0;
+            }
+            pos = atomic_load_explicit(&q->t, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&q->t, &pos, pos + c,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    for (i = 0; i < c; i++) {
+        q->b[(pos + i) & q->m].v = v[i];
+        atomic_store_explicit(&q->b[(pos + i) & q->m].seq, pos + i + 1, memory_order_release);
+    }
+    return c;
+}
+
+size_t _solMpmcQueue_dequeue_batch(SolMpmcQueue *q, void **v, size_t n)
+{
+    size_t pos = atomic_load_explicit(&q->h, memory_order_relaxed);
+    size_t seq, c, i;
+    if (n == 0) {
+        return 0;
+    }
+    if (n > q->m + 1) {
+        n = q->m + 1;
+    }
+    for (;;) {
+        // n is at least 1, the first cell is always looked at
+        c = 0;
+        do {
+            seq = atomic_load_explicit(&q->b[(pos + c) & q->m].seq, memory_order_acquire);
+            if (seq != pos + c + 1) {
+                break;
+            }
+        } while (++c < n);
+        if (c == 0) {
+            if ((ptrdiff_t)(seq - (pos + 1)) < 0) {
+                return 0;
+            }
+            pos = atomic_load_explicit(&q->h, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&q->h, &pos, pos + c,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+    for (i = 0; i < c; i++) {
+        v[i] = q->b[(pos + i) & q->m].v;
+        atomic_store_explicit(&q->b[(pos + i) & q->m].seq, pos + i + q->m + 1, memory_order_release);
+    }
+    return c;
+}
+
+/**
+ * capacity is rounded up to a power of two
+ * only one thread may enqueue and only one thread may dequeue
+ */
+SolSpscQueue* solSpscQueue_new(size_t s)
+{
+    SolSpscQueue *q = sol_alloc(sizeof(SolSpscQueue));
+    if (q == NULL) {
+        return NULL;
+    }
+    s = _solQueue_round_size(s);
+    q->b = sol_alloc(sizeof(void*) * s);
+    if (q->b == NULL) {
+        sol_free(q);
+        return NULL;
+    }
+    q->m = s - 1;
+    atomic_init(&q->t, 0);
+    atomic_init(&q->h, 0);
+    q->hc = 0;
+    q->tc = 0;
+    _solQueueEvent_init(&q->ne);
+    _solQueueEvent_init(&q->nf);
+    return q;
+}
+
+void solSpscQueue_free(SolSpscQueue *q)
+{
+    sol_free(q->b);
+    sol_free(q);
+}
+
+int solSpscQueue_enqueue(SolSpscQueue *q, void *v)
+{
+    size_t t = atomic_load_explicit(&q->t, memory_order_relaxed);
+    if (t - q->hc > q->m) {
+        q->hc = atomic_load_explicit(&q->h, memory_order_acquire);
+        if (t - q->hc > q->m) {
+            return 1;
+        }
+    }
+    q->b[t & q->m] = v;
+    atomic_store_explicit(&q->t, t + 1, memory_order_release);
+    _solQueueEvent_notify(&q->ne, 1);
+    return 0;
+}
+
+int solSpscQueue_dequeue(SolSpscQueue *q, void **v)
+{
+    size_t h = atomic_load_explicit(&q->h, memory_order_relaxed);
+    if (h == q->tc) {
+        q->tc = atomic_load_explicit(&q->t, memory_order_acquire);
+        if (h == q->tc) {
+            return 1;
+        }
+    }
+    *v = q->b[h & q->m];
+    atomic_store_explicit(&q->h, h + 1, memory_order_release);
+    _solQueueEvent_notify(&q->nf, 1);
+    return 0;
+}
+
+/**
+ * publish up to n vals with a single store of the tail
+ */
+size_t solSpscQueue_enqueue_batch(SolSpscQueue *q, void **v, size_t n)
+{
+    size_t c = _solSpscQueue_enqueue_batch(q, v, n);
+    if (c) {
+        _solQueueEvent_notify(&q->ne, 1);
+    }
+    return c;
+}
+
+size_t solSpscQueue_dequeue_batch(SolSpscQueue *q, void **v, size_t n)
+{
+    size_t c = _solSpscQueue_dequeue_batch(q, v, n);
+    if (c) {
+        _solQueueEvent_notify(&q->nf, 1);
+    }
+    return c;
+}
+
+void solSpscQueue_enqueue_wait(SolSpscQueue *q, void *v)
+{
+    uint32_t e;
+    while (solSpscQueue_enqueue(q, v)) {
+        e = _solQueueEvent_prepare(&q->nf);
+        if (solSpscQueue_enqueue(q, v) == 0) {
+            _solQueueEvent_cancel(&q->nf);
+            return;
+        }
+        _solQueueEvent_sleep(&q->nf, e);
+    }
+}
+
+void* solSpscQueue_dequeue_wait(SolSpscQueue *q)
+{
+    void *v;
+    uint32_t e;
+    while (solSpscQueue_dequeue(q, &v)) {
+        e = _solQueueEvent_prepare(&q->ne);
+        if (solSpscQueue_dequeue(q, &v) == 0) {
+            _solQueueEvent_cancel(&q->ne);
+            break;
+        }
+        _solQueueEvent_sleep(&q->ne, e);
+    }
+    return v;
+}
+
+size_t _solSpscQueue_enqueue_batch(SolSpscQueue *q, void **v, size_t n)
+{
+    size_t t = atomic_load_explicit(&q->t, memory_order_relaxed);
+    size_t c = q->m + 1 - (t - q->hc);
+    size_t i;
+    if (c < n) {
+        q->hc = atomic_load_explicit(&q->h, memory_order_acquire);
+        c = q->m + 1 - (t - q->hc);
+    }
+    if (c > n) {
+        c = n;
+    }
+    for (i = 0; i < c; i++) {
+        q->b[(t + i) & q->m] = v[i];
+    }
+    if (c) {
+        atomic_store_explicit(&q->t, t + c, memory_order_release);
+    }
+    return c;
+}
+
+size_t _solSpscQueue_dequeue_batch(SolSpscQueue *q, void **v, size_t n)
+{
+    size_t h = atomic_load_explicit(&q->h, memory_order_relaxed);
+    size_t c = q->tc - h;
+    size_t i;
+    if (c < n) {
+        q->tc = atomic_load_explicit(&q->t, memory_order_acquire);
+        c = q->tc - h;
+    }
+    if (c > n) {
+        c = n;
+    }
+    for (i = 0; i < c; i++) {
+        v[i] = q->b[(h + i) & q->m];
+    }
+    if (c) {
+        atomic_store_explicit(&q->h, h + c, memory_order_release);
+    }
+    return c;
+}
@@ -0,0 +1,90 @@
+#ifndef _SOL_QUEUE_H_
+#define _SOL_QUEUE_H_ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "sol_common.h"
+
+#define SOL_QUEUE_MIN_SIZE 2
+
+// wakes up threads blocked on a queue, futex word + number of sleepers
+typedef struct _SolQueueEvent {
+    _Atomic uint32_t e; // event count
+    _Atomic uint32_t w; // waiters
+} SolQueueEvent;
+
+size_t _solQueue_round_size(size_t);
+void _solQueueEvent_init(SolQueueEvent*);
+uint32_t _solQueueEvent_prepare(SolQueueEvent*);
+void _solQueueEvent_cancel(SolQueueEvent*);
+void _solQueueEvent_sleep(SolQueueEvent*, uint32_t);
+void _solQueueEvent_notify(SolQueueEvent*, size_t);
+
+typedef struct _SolMpmcQueueCell {
+    _Atomic size_t seq; // sequence
+    void *v; // val
+} SolMpmcQueueCell;
+
+// bounded multi producer multi consumer queue
+typedef struct _SolMpmcQueue {
+    SolMpmcQueueCell *b; // cells
+    size_t m; // mask, capacity - 1
+    char _p0[SOL_CACHE_LINE_SIZE];
+    _Atomic size_t t; // tail, next enqueue position
+    char _p1[SOL_CACHE_LINE_SIZE - sizeof(size_t)];
+    _Atomic size_t h; // head, next dequeue position
+    char _p2[SOL_CACHE_LINE_SIZE - sizeof(size_t)];
+    SolQueueEvent ne; // not empty
+    SolQueueEvent nf; // not full
+} SolMpmcQueue;
+
+SolMpmcQueue* solMpmcQueue_new(size_t);
+void solMpmcQueue_free(SolMpmcQueue*);
+int solMpmcQueue_enqueue(SolMpmcQueue*, void*);
+int solMpmcQueue_dequeue(SolMpmcQueue*, void**);
+size_t solMpmcQueue_enqueue_batch(SolMpmcQueue*, void**, size_t);
+size_t solMpmcQueue_dequeue_batch(SolMpmcQueue*, void**, size_t);
+void solMpmcQueue_enqueue_wait(SolMpmcQueue*, void*);
+void* solMpmcQueue_dequeue_wait(SolMpmcQueue*);
+int _solMpmcQueue_enqueue(SolMpmcQueue*, void*);
+int _solMpmcQueue_dequeue(SolMpmcQueue*, void**);
+size_t _solMpmcQueue_enqueue_batch(SolMpmcQueue*, void**, size_t);
+size_t _solMpmcQueue_dequeue_batch(SolMpmcQueue*, void**, size_t);
+
+#define solMpmcQueue_capacity(q) ((q)->m + 1)
+// only a snapshot when other threads are working on the queue
+#define solMpmcQueue_count(q) \
+    (atomic_load_explicit(&(q)->t, memory_order_relaxed) - atomic_load_explicit(&(q)->h, memory_order_relaxed))
+
+// bounded single producer single consumer queue
+typedef struct _SolSpscQueue {
+    void **b; // slots
+    size_t m; // mask, capacity - 1
+    char _p0[SOL_CACHE_LINE_SIZE];
+    _Atomic size_t t; // tail, written by producer
+    size_t hc; // head cached by producer
+    char _p1[SOL_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+    _Atomic size_t h; // head, written by consumer
+    size_t tc; // tail cached by consumer
+    char _p2[SOL_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+    SolQueueEvent ne; // not empty
+    SolQueueEvent nf; // not full
+} SolSpscQueue;
+
+SolSpscQueue* solSpscQueue_new(size_t);
+void solSpscQueue_free(SolSpscQueue*);
+int solSpscQueue_enqueue(SolSpscQueue*, void*);
+int solSpscQueue_dequeue(SolSpscQueue*, void**);
+size_t solSpscQueue_enqueue_batch(SolSpscQueue*, void**, size_t);
+size_t solSpscQueue_dequeue_batch(SolSpscQueue*, void**, size_t);
+void solSpscQueue_enqueue_wait(SolSpscQueue*, void*);
+void* solSpscQueue_dequeue_wait(SolSpscQueue*);
+size_t _solSpscQueue_enqueue_batch(SolSpscQueue*, void**, size_t);
+size_t _solSpscQueue_dequeue_batch(SolSpscQueue*, void**, size_t);
+
+#define solSpscQueue_capacity(q) ((q)->m + 1)
+#define solSpscQueue_count(q) \
+    (atomic_load_explicit(&(q)->t, memory_order_relaxed) - atomic_load_explicit(&(q)->h, memory_order_relaxed))
+
+#endif
@@ -3,27 +3,54 @@
 
 SolRBTree* solRBTree_new()
 {
-    SolRBTree *t = sol_calloc(1, sizeof(SolRBTree));
+    return solRBTree_new_with_allocator(NULL);
+}
+
+/**
+ * tree whose struct and nodes come from allocator a
+ */
+SolRBTree* solRBTree_new_with_allocator(SolAllocator *a)
+{
+    SolRBTree *t = solAllocator_calloc(a, 1, sizeof(SolRBTree));
     if (t == NULL) {
         return NULL;
     }
-    solRBTree_set_nil(t, sol_calloc(1, sizeof(SolRBTreeNode)));
+    t->a = a;
+    solRBTree_set_nil(t, solAllocator_calloc(a, 1, sizeof(SolRBTreeNil)));
     if (solRBTree_nil(t) == NULL) {
         solRBTree_free(t);
         return NULL;
     }
     solRBTreeNode_dye_black(solRBTree_nil(t));
+    atomic_init(&_solRBTree_nil_refs(t), 1);
     solRBTree_set_root(t, solRBTree_nil(t));
     return t;
 }
 
+/**
+ * empty tree sharing nil, allocator and funcs with t, so the two can be joined in O(log n)
+ */
+SolRBTree* solRBTree_new_sibling(SolRBTree *t)
+{
+    SolRBTree *s = solAllocator_calloc(solRBTree_allocator(t), 1, sizeof(SolRBTree));
+    if (s == NULL) {
+        return NULL;
+    }
+    *s = *t;
+    solRBTree_set_root(s, solRBTree_nil(s));
+    s->fg = NULL;
+    s->c = s->pc = 0;
+    atomic_fetch_add_explicit(&_solRBTree_nil_refs(s), 1, memory_order_relaxed);
+    return s;
+}
+
 int solRBTree_node_free(SolRBTree *t, SolRBTreeNode *n)
 {
     if (n) {
         if (solRBTree_node_val_free_func(t)) {
             solRBTree_node_val_free(solRBTreeNode_val(n));
         }
-        sol_free(n);
+        solAllocator_free(solRBTree_allocator(t), n);
     }
     return 0;
 }
@@ -35,9 +62,44 @@ int _solRBTree_node_free(SolRBTree *t, SolRBTreeNode *n, void *d)
 
 void solRBTree_free(SolRBTree *t)
 {
-    solRBTree_travelsal_backorder(t, solRBTree_root(t), &_solRBTree_node_free, NULL);
-    sol_free(solRBTree_nil(t));
-    sol_free(t);
+    if (solRBTree_nil(t)) {
+        _solRBTree_free_nodes(t, solRBTree_root(t), solRBTree_node_val_free_func(t));
+    }
+    SolAllocator *a = solRBTree_allocator(t);
+    // the last tree out frees the nil, after every other tree is done with it
+    if (solRBTree_nil(t) && atomic_fetch_sub_explicit(&_solRBTree_nil_refs(t), 1, memory_order_acq_rel) == 1) {
+        solAllocator_free(a, solRBTree_nil(t));
+    }
+    solAllocator_free(a, t);
+}
+
+/**
+ * free every node and val, the tree stays usable
+ */
+void solRBTree_wipe(SolRBTree *t)
+{
+    _solRBTree_free_nodes(t, solRBTree_root(t), solRBTree_node_val_free_func(t));
+    solRBTree_set_root(t, solRBTree_nil(t));
+    t->fg = NULL;
+    t->c = 0;
+}
+
+/**
+ * struct, nil and nodes of the tree, vals are not counted
+ */
+void solRBTree_memory_usage(SolRBTree *t, SolMemoryUsage *u)
+{
+    solMemoryUsage_init(u);
+    _solRBTree_memory_usage(t, u);
+    solMemoryUsage_sum(u);
+}
+
+void _solRBTree_memory_usage(SolRBTree *t, SolMemoryUsage *u)
+{
+    u->sb += sizeof(SolRBTree);
+    u->nb += solRBTree_node_bytes(t) * solRBTree_count(t) + sizeof(SolRBTreeNil);
+    u->pb += sizeof(SolRBTree) + solRBTree_node_bytes(t) * t->pc + sizeof(SolRBTreeNil);
+    u->n += solRBTree_count(t) + 2;
 }
 
 /**
@@ -77,6 +139,15 @@ int solRBTree_left_rorate(SolRBTree *tree, SolRBTreeNode *node)
     // change node and new node relation
     solRBTreeNode_set_left(replace2_node, node);
     solRBTreeNode_set_parent(node, replace2_node);
+    // new top takes over the whole subtree, node keeps what is left below it
+    if (solRBTree_is_sized(tree)) {
+        solRBTreeNode_set_size(replace2_node, solRBTreeNode_size(node));
+        solRBTreeNode_resize(node);
+    }
+    if (solRBTree_is_interval(tree)) {
+        solRBTreeNode_max(replace2_node) = solRBTreeNode_max(node);
+        _solRBTree_node_remax(tree, node);
+    }
     return 0;
 }
 /**
@@ -116,10 +187,22 @@ int solRBTree_right_rorate(SolRBTree *tree, SolRBTreeNode *node)
     // change node and new node relation
     solRBTreeNode_set_right(replace2_node, node);
     solRBTreeNode_set_parent(node, replace2_node);
+    // new top takes over the whole subtree, node keeps what is left below it
+    if (solRBTree_is_sized(tree)) {
+        solRBTreeNode_set_size(replace2_node, solRBTreeNode_size(node));
+        solRBTreeNode_resize(node);
+    }
+    if (solRBTree_is_interval(tree)) {
+        solRBTreeNode_max(replace2_node) = solRBTreeNode_max(node);
+        _solRBTree_node_remax(tree, node);
+    }
     return 0;
 }
 
-void solRBTree_insert_fixup(SolRBTree *tree, SolRBTreeNode *node)
+/**
+ * @return 1 when the black height of the tree grew by one
+ */
+int solRBTree_insert_fixup(SolRBTree *tree, SolRBTreeNode *node)
 {
     // only fixup when parent is red
     while (solRBTreeNode_parent_is_red(node)) {
@@ -164,49 +247,130 @@ void solRBTree_insert_fixup(SolRBTree *tree, SolRBTreeNode *node)
             }
         }
     }
+    // a red root turning black adds one to every path
+    int grew = solRBTreeNode_is_red(solRBTree_root(tree));
     solRBTreeNode_dye_black(solRBTree_root(tree));
+    return grew;
 }
 
+/**
+ * insert val, a val already in the tree is kept and the new one freed with the free val func
+ * @return node holding the val, NULL when out of memory
+ */
 SolRBTreeNode* solRBTree_insert(SolRBTree *tree, void *val)
 {
-    SolRBTreeNode *node;
-    node = sol_alloc(sizeof(SolRBTreeNode));
+    int is_new;
+    SolRBTreeNode *node = solRBTree_insert_or_get(tree, val, &is_new);
+    if (node && is_new == 0 && solRBTree_node_val_free_func(tree)) {
+        (*solRBTree_node_val_free_func(tree))(val);
+    }
+    return node;
+}
+
+/**
+ * node holding a val equal to val, linked in for val when there is none
+ * allocates only on a miss and leaves val to the caller on a hit
+ * @param is_new set to 1 when val was linked in, may be NULL
+ * @return the node, NULL when out of memory
+ */
+SolRBTreeNode* solRBTree_insert_or_get(SolRBTree *tree, void *val, int *is_new)
+{
+    return _solRBTree_insert_below(tree, solRBTree_root(tree), val, is_new);
+}
+
+/**
+ * insert val looking from hint instead of the root, a val already in the tree is freed as by solRBTree_insert
+ * hint is a node near val, NULL for the finger, the finger moves to the node of val
+ * a val right after the hint, as in a sorted run, skips the descent and takes two compares
+ * @return node holding the val, NULL when out of memory
+ */
+SolRBTreeNode* solRBTree_insert_hint(SolRBTree *tree, SolRBTreeNode *hint, void *val)
+{
+    int is_new;
+    SolRBTreeNode *node = _solRBTree_finger(tree, hint ? hint : solRBTree_finger(tree), val);
+    node = _solRBTree_insert_below(tree, node, val, &is_new);
     if (node == NULL) {
         return NULL;
     }
-    solRBTreeNode_dye_red(node);
-    solRBTreeNode_set_parent(node, solRBTree_nil(tree));
-    solRBTreeNode_set_left(node, solRBTree_nil(tree));
-    solRBTreeNode_set_right(node, solRBTree_nil(tree));
-    solRBTreeNode_set_val(node, val);
+    if (is_new == 0 && solRBTree_node_val_free_func(tree)) {
+        (*solRBTree_node_val_free_func(tree))(val);
+    }
+    tree->fg = node;
+    return node;
+}
+
+/**
+ * insert or get with the search starting at node, val must belong in its subtree
+ */
+SolRBTreeNode* _solRBTree_insert_below(SolRBTree *tree, SolRBTreeNode *node, void *val, int *is_new)
+{
     // find insert position
-    int w;
-    SolRBTreeNode *current_node = solRBTree_root(tree);
+    int w = 0;
+    SolRBTreeNode *current_node = node;
     SolRBTreeNode *pre_node = solRBTree_nil(tree);
     while (solRBTree_node_is_NOT_nil(tree, current_node)) {
-        pre_node = current_node;
-        w = solRBTree_node_compare(tree, node, current_node);
+        w = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(current_node));
         if (w == 0) {
             // has this node
-            solRBTree_node_free(tree, node);
+            if (is_new) {
+                *is_new = 0;
+            }
             return current_node;
-        } else if (w < 0) {
-            current_node = solRBTreeNode_left(current_node);
-        } else {
-            current_node = solRBTreeNode_right(current_node);
         }
+        pre_node = current_node;
+        current_node = w < 0 ? solRBTreeNode_left(current_node) : solRBTreeNode_right(current_node);
     }
+    if (is_new) {
+        *is_new = 1;
+    }
+    return _solRBTree_link(tree, pre_node, w, val);
+}
+
+/**
+ * link a new node for val below pre_node, on the left when w < 0, and rebalance
+ * @return the node, NULL when out of memory
+ */
+SolRBTreeNode* _solRBTree_link(SolRBTree *tree, SolRBTreeNode *pre_node, int w, void *val)
+{
+    SolRBTreeNode *node;
+    node = solAllocator_alloc(solRBTree_allocator(tree), solRBTree_node_bytes(tree));
+    if (node == NULL) {
+        return NULL;
+    }
+    solRBTreeNode_dye_red(node);
     solRBTreeNode_set_parent(node, pre_node);
+    solRBTreeNode_set_left(node, solRBTree_nil(tree));
+    solRBTreeNode_set_right(node, solRBTree_nil(tree));
+    solRBTreeNode_set_val(node, val);
+    if (solRBTree_is_sized(tree)) {
+        solRBTreeNode_set_size(node, 1);
+    }
+    if (solRBTree_is_interval(tree)) {
+        solRBTreeNode_max(node) = solRBTree_val_hi(tree, val);
+    }
     if (solRBTree_node_is_nil(tree, pre_node)) {
         // empty tree
         solRBTree_set_root(tree, node);
-    } else if (solRBTree_node_compare(tree, node, pre_node) < 0) {
+    } else if (w < 0) {
         // is left child
         solRBTreeNode_set_left(pre_node, node);
     } else {
         // is right child
         solRBTreeNode_set_right(pre_node, node);
     }
+    // every ancestor gains one, and may reach further, nothing to walk for a plain tree
+    if (solRBTree_is_sized(tree) || solRBTree_is_interval(tree)) {
+        for (; solRBTree_node_is_NOT_nil(tree, pre_node); pre_node = solRBTreeNode_parent(pre_node)) {
+            if (solRBTree_is_sized(tree)) {
+                solRBTreeNode_size(pre_node)++;
+            }
+            if (solRBTree_is_interval(tree)
+                && solRBTree_pos_compare(tree, solRBTreeNode_max(node), solRBTreeNode_max(pre_node)) > 0
+                ) {
+                solRBTreeNode_max(pre_node) = solRBTreeNode_max(node);
+            }
+        }
+    }
     solRBTree_insert_fixup(tree, node);
     solRBTree_count_inc(tree);
     return node;
@@ -222,16 +386,79 @@ SolRBTreeNode* solRBTree_insert(SolRBTree *tree, void *val)
  */
 SolRBTreeNode* solRBTree_search_node(SolRBTree *tree, void *val)
 {
+    int w;
     SolRBTreeNode *current_node = solRBTree_root(tree);
-    while (solRBTree_node_is_NOT_nil(tree, current_node)
-           && solRBTree_node_val_compare(tree, val, solRBTreeNode_val(current_node)) != 0
-        ) {
-        current_node = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(current_node)) < 0
-            ? solRBTreeNode_left(current_node)
-            : solRBTreeNode_right(current_node);
+    while (solRBTree_node_is_NOT_nil(tree, current_node)) {
+        // one three way compare per level
+        w = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(current_node));
+        if (w == 0) {
+            break;
+        }
+        current_node = w < 0 ? solRBTreeNode_left(current_node) : solRBTreeNode_right(current_node);
     }
     return current_node;
 }
+
+/**
+ * search looking from hint instead of the root, hint is a node near val, NULL for the finger
+ * the finger moves to the node found
+ * @return the node, nil when there is none
+ */
+SolRBTreeNode* solRBTree_search_hint(SolRBTree *tree, SolRBTreeNode *hint, void *val)
+{
+    int w;
+    SolRBTreeNode *node = _solRBTree_finger(tree, hint ? hint : solRBTree_finger(tree), val);
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        w = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(node));
+        if (w == 0) {
+            tree->fg = node;
+            break;
+        }
+        node = w < 0 ? solRBTreeNode_left(node) : solRBTreeNode_right(node);
+    }
+    return node;
+}
+
+/**
+ * lowest node at or above hint whose subtree holds val or the place for it
+ * walks up the spine on val's side of hint to the ancestor bounding it there, compares only with that one
+ * @return hint itself when val is next to it, the root without a hint
+ */
+SolRBTreeNode* _solRBTree_finger(SolRBTree *tree, SolRBTreeNode *hint, void *val)
+{
+    SolRBTreeNode *node, *p_node;
+    int w, pw;
+    if (hint == NULL || solRBTree_node_is_nil(tree, hint)) {
+        return solRBTree_root(tree);
+    }
+    w = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(hint));
+    while (w != 0) {
+        node = hint;
+        for (;;) {
+            p_node = solRBTreeNode_parent(node);
+            if (solRBTree_node_is_nil(tree, p_node)) {
+                // nothing bounds hint's subtree on that side
+                return hint;
+            }
+            if (w > 0 ? node == solRBTreeNode_left(p_node) : node == solRBTreeNode_right(p_node)) {
+                break;
+            }
+            node = p_node;
+        }
+        pw = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(p_node));
+        if (pw == 0) {
+            return p_node;
+        }
+        if ((pw < 0) == (w > 0)) {
+            // between hint and its bound
+            return hint;
+        }
+        hint = p_node;
+        w = pw;
+    }
+    return hint;
+}
+
 /**
  * find min node in node's sub tree
  * @params tree
@@ -280,6 +507,101 @@ void* solRBTree_max(SolRBTree *tree)
     return solRBTreeNode_val(node);
 }
 void* solRBTree_max(SolRBTree*);
+
+/**
+ * node holding the k-th smallest val, counting from 0
+ * O(log n) in a sized tree, else walks k nodes up from the min
+ * @return nil when k is out of range
+ */
+SolRBTreeNode* solRBTree_select_node(SolRBTree *tree, size_t k)
+{
+    SolRBTreeNode *node = solRBTree_root(tree);
+    if (!solRBTree_is_sized(tree)) {
+        node = solRBTree_search_min_node(tree, node);
+        for (; k && solRBTree_node_is_NOT_nil(tree, node); k--) {
+            node = solRBTree_search_successor(tree, node);
+        }
+        return node;
+    }
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        size_t ls = solRBTreeNode_size(solRBTreeNode_left(node));
+        if (k == ls) {
+            return node;
+        } else if (k < ls) {
+            node = solRBTreeNode_left(node);
+        } else {
+            k -= ls + 1;
+            node = solRBTreeNode_right(node);
+        }
+    }
+    return node;
+}
+
+/**
+ * the k-th smallest val, counting from 0, NULL when k is out of range
+ */
+void* solRBTree_select(SolRBTree *tree, size_t k)
+{
+    SolRBTreeNode *node = solRBTree_select_node(tree, k);
+    if (solRBTree_node_is_nil(tree, node)) {
+        return NULL;
+    }
+    return solRBTreeNode_val(node);
+}
+
+/**
+ * count of vals less than val, val need not be in the tree
+ * O(log n) in a sized tree, else walks the vals counted
+ */
+size_t solRBTree_rank(SolRBTree *tree, void *val)
+{
+    size_t r = 0;
+    int w;
+    SolRBTreeNode *node = solRBTree_root(tree);
+    if (!solRBTree_is_sized(tree)) {
+        for (node = solRBTree_search_min_node(tree, node);
+             solRBTree_node_is_NOT_nil(tree, node) && solRBTree_node_val_compare(tree, val, solRBTreeNode_val(node)) > 0;
+             node = solRBTree_search_successor(tree, node)) {
+            r++;
+        }
+        return r;
+    }
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        w = solRBTree_node_val_compare(tree, val, solRBTreeNode_val(node));
+        if (w == 0) {
+            return r + solRBTreeNode_size(solRBTreeNode_left(node));
+        } else if (w < 0) {
+            node = solRBTreeNode_left(node);
+        } else {
+            r += solRBTreeNode_size(solRBTreeNode_left(node)) + 1;
+            node = solRBTreeNode_right(node);
+        }
+    }
+    return r;
+}
+
+/**
+ * count of vals from lo up to but not including hi
+ * O(log n) in a sized tree, else walks the vals counted
+ */
+size_t solRBTree_count_range(SolRBTree *tree, void *lo, void *hi)
+{
+    if (solRBTree_node_val_compare(tree, lo, hi) >= 0) {
+        return 0;
+    }
+    if (!solRBTree_is_sized(tree)) {
+        size_t c = 0;
+        SolRBTreeNode *node;
+        for (node = solRBTree_lower_bound(tree, lo);
+             solRBTree_node_is_NOT_nil(tree, node) && solRBTree_node_val_compare(tree, solRBTreeNode_val(node), hi) < 0;
+             node = solRBTree_search_successor(tree, node)) {
+            c++;
+        }
+        return c;
+    }
+    return solRBTree_rank(tree, hi) - solRBTree_rank(tree, lo);
+}
+
 /**
  * find in order successor of the node in tree
  * when find in order successor:
@@ -304,7 +626,64 @@ SolRBTreeNode* solRBTree_search_successor(SolRBTree *tree, SolRBTreeNode *node)
         node = s_node;
         s_node = solRBTreeNode_parent(node);
     }
-    return node;
+    return s_node;
+}
+
+/**
+ * find in order predecessor of the node in tree, mirror of successor
+ */
+SolRBTreeNode* solRBTree_search_predecessor(SolRBTree *tree, SolRBTreeNode *node)
+{
+    if (solRBTree_node_is_nil(tree, node)) {
+        return solRBTree_nil(tree);
+    }
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_left(node))) {
+        return solRBTree_search_max_node(tree, solRBTreeNode_left(node));
+    }
+    SolRBTreeNode *p_node = solRBTreeNode_parent(node);
+    while (solRBTree_node_is_NOT_nil(tree, p_node) && node == solRBTreeNode_left(p_node)) {
+        node = p_node;
+        p_node = solRBTreeNode_parent(node);
+    }
+    return p_node;
+}
+
+/**
+ * first node whose val is not less than val
+ * @return nil when every val is less
+ */
+SolRBTreeNode* solRBTree_lower_bound(SolRBTree *tree, void *val)
+{
+    SolRBTreeNode *node = solRBTree_root(tree);
+    SolRBTreeNode *b_node = solRBTree_nil(tree);
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        if (solRBTree_node_val_compare(tree, solRBTreeNode_val(node), val) >= 0) {
+            b_node = node;
+            node = solRBTreeNode_left(node);
+        } else {
+            node = solRBTreeNode_right(node);
+        }
+    }
+    return b_node;
+}
+
+/**
+ * first node whose val is greater than val
+ * @return nil when no val is greater
+ */
+SolRBTreeNode* solRBTree_upper_bound(SolRBTree *tree, void *val)
+{
+    SolRBTreeNode *node = solRBTree_root(tree);
+    SolRBTreeNode *b_node = solRBTree_nil(tree);
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        if (solRBTree_node_val_compare(tree, solRBTreeNode_val(node), val) > 0) {
+            b_node = node;
+            node = solRBTreeNode_left(node);
+        } else {
+            node = solRBTreeNode_right(node);
+        }
+    }
+    return b_node;
 }
 
 /**
@@ -411,47 +790,766 @@ int solRBTree_delete_node(SolRBTree *tree, SolRBTreeNode *del_node)
         // rp_node is right child
         solRBTreeNode_set_right(solRBTreeNode_parent(rp_node), rp_child_node);
     }
-    // fix the key
+    // every ancestor of the spliced node loses one, before fixup rotates them
+    SolRBTreeNode *p_node;
+    if (solRBTree_is_sized(tree)) {
+        for (p_node = solRBTreeNode_parent(rp_node);
+             solRBTree_node_is_NOT_nil(tree, p_node);
+             p_node = solRBTreeNode_parent(p_node)) {
+            solRBTreeNode_size(p_node)--;
+        }
+    }
+    // fix the key, the spliced node takes the deleted val along to be freed
     if (del_node != rp_node) {
+        void *val = solRBTreeNode_val(del_node);
         solRBTreeNode_set_val(del_node, solRBTreeNode_val(rp_node));
+        solRBTreeNode_set_val(rp_node, val);
+    }
+    if (solRBTree_is_interval(tree)) {
+        for (p_node = solRBTreeNode_parent(rp_node);
+             solRBTree_node_is_NOT_nil(tree, p_node);
+             p_node = solRBTreeNode_parent(p_node)) {
+            _solRBTree_node_remax(tree, p_node);
+        }
     }
     // if deleted node is black, need to fixup
     if (solRBTreeNode_is_black(rp_node)) {
         solRBTree_delete_fixup(tree, rp_child_node);
     }
+    if (solRBTree_finger(tree) == rp_node) {
+        tree->fg = NULL;
+    }
     // delete the node
     solRBTree_node_free(tree, rp_node);
     solRBTree_count_dec(tree);
     return 0;
 }
 
+/**
+ * delete the vals from lo up to but not including hi
+ * @return count of vals deleted
+ */
+size_t solRBTree_delete_range(SolRBTree *tree, void *lo, void *hi)
+{
+    size_t c = 0;
+    SolRBTreeNode *node = solRBTree_lower_bound(tree, lo);
+    SolRBTreeNode *next_node;
+    while (solRBTree_node_is_NOT_nil(tree, node)
+           && solRBTree_node_val_compare(tree, solRBTreeNode_val(node), hi) < 0
+        ) {
+        // a node with two children survives and takes over its successor's val
+        next_node = solRBTree_node_left_is_nil(tree, node) || solRBTree_node_right_is_nil(tree, node)
+            ? solRBTree_search_successor(tree, node)
+            : node;
+        solRBTree_delete_node(tree, node);
+        node = next_node;
+        c++;
+    }
+    return c;
+}
+
+/**
+ * fill an empty tree from n vals sorted ascending without duplicates, in O(n)
+ * @return 0 success, -1 tree not empty or vals out of order, 1 out of memory
+ */
+int solRBTree_build_sorted(SolRBTree *tree, void **vals, size_t n)
+{
+    size_t i, rd = 0;
+    if (solRBTree_count(tree)) {
+        return -1;
+    }
+    for (i = 1; i < n; i++) {
+        if (solRBTree_node_val_compare(tree, vals[i - 1], vals[i]) >= 0) {
+            return -1;
+        }
+    }
+    // levels above rd are full, nodes on level rd are red
+    while ((((size_t)2 << rd) - 1) <= n) {
+        rd++;
+    }
+    SolRBTreeNode *root = _solRBTree_build(tree, vals, n, 0, rd);
+    if (root == NULL) {
+        return 1;
+    }
+    solRBTree_set_root(tree, root);
+    solRBTree_set_count(tree, n);
+    return 0;
+}
+
+/**
+ * balanced subtree of vals with its root at depth d
+ * @return NULL when out of memory, nothing is left allocated
+ */
+SolRBTreeNode* _solRBTree_build(SolRBTree *tree, void **vals, size_t n, size_t d, size_t rd)
+{
+    if (n == 0) {
+        return solRBTree_nil(tree);
+    }
+    size_t m = n / 2;
+    SolRBTreeNode *node = solAllocator_alloc(solRBTree_allocator(tree), solRBTree_node_bytes(tree));
+    if (node == NULL) {
+        return NULL;
+    }
+    solRBTreeNode_dye(node, d == rd ? _SolRBTreeCol_red : _SolRBTreeCol_black);
+    solRBTreeNode_set_parent(node, solRBTree_nil(tree));
+    solRBTreeNode_set_right(node, solRBTree_nil(tree));
+    solRBTreeNode_set_val(node, vals[m]);
+    if (solRBTree_is_sized(tree)) {
+        solRBTreeNode_set_size(node, n);
+    }
+    SolRBTreeNode *child = _solRBTree_build(tree, vals, m, d + 1, rd);
+    if (child == NULL) {
+        solAllocator_free(solRBTree_allocator(tree), node);
+        return NULL;
+    }
+    solRBTreeNode_set_left(node, child);
+    if (solRBTree_node_is_NOT_nil(tree, child)) {
+        solRBTreeNode_set_parent(child, node);
+    }
+    child = _solRBTree_build(tree, vals + m + 1, n - m - 1, d + 1, rd);
+    if (child == NULL) {
+        _solRBTree_free_nodes(tree, node, NULL);
+        return NULL;
+    }
+    solRBTreeNode_set_right(node, child);
+    if (solRBTree_node_is_NOT_nil(tree, child)) {
+        solRBTreeNode_set_parent(child, node);
+    }
+    if (solRBTree_is_interval(tree)) {
+        _solRBTree_node_remax(tree, node);
+    }
+    return node;
+}
+
+/**
+ * free the nodes of a subtree and their vals with f, vals are left alone when f is NULL
+ * right rotations at the top turn the subtree into a list as it goes, no stack and no recursion
+ */
+void _solRBTree_free_nodes(SolRBTree *tree, SolRBTreeNode *node, sol_f_free_ptr f)
+{
+    SolRBTreeNode *next_node;
+    while (solRBTree_node_is_NOT_nil(tree, node)) {
+        next_node = solRBTreeNode_left(node);
+        if (solRBTree_node_is_nil(tree, next_node)) {
+            next_node = solRBTreeNode_right(node);
+            if (f) {
+                (*f)(solRBTreeNode_val(node));
+            }
+            solAllocator_free(solRBTree_allocator(tree), node);
+        } else {
+            // lift the left child over node
+            solRBTreeNode_set_left(node, solRBTreeNode_right(next_node));
+            solRBTreeNode_set_right(next_node, node);
+        }
+        node = next_node;
+    }
+}
+
+/**
+ * black nodes on a path from node down to nil
+ */
+size_t _solRBTree_black_height(SolRBTree *tree, SolRBTreeNode *node)
+{
+    size_t h = 0;
+    for (; solRBTree_node_is_NOT_nil(tree, node); node = solRBTreeNode_left(node)) {
+        if (solRBTreeNode_is_black(node)) {
+            h++;
+        }
+    }
+    return h;
+}
+
+/**
+ * join subtrees l and r, black roots of black heights lh and rh, with node x between them
+ * takes O(|lh - rh| + 1), the tree root is used as scratch
+ * @return root of the joined subtree, its black height in h
+ */
+SolRBTreeNode* _solRBTree_join(SolRBTree *tree, SolRBTreeNode *l, size_t lh, SolRBTreeNode *x,
+                               SolRBTreeNode *r, size_t rh, size_t *h)
+{
+    SolRBTreeNode *root, *y, *p_node = solRBTree_nil(tree);
+    size_t yh;
+    if (lh == rh) {
+        solRBTreeNode_dye_black(x);
+        solRBTreeNode_set_parent(x, p_node);
+        solRBTreeNode_set_left(x, l);
+        solRBTreeNode_set_right(x, r);
+        if (solRBTree_is_sized(tree)) {
+            solRBTreeNode_resize(x);
+        }
+        if (solRBTree_node_is_NOT_nil(tree, l)) {
+            solRBTreeNode_set_parent(l, x);
+        }
+        if (solRBTree_node_is_NOT_nil(tree, r)) {
+            solRBTreeNode_set_parent(r, x);
+        }
+        if (solRBTree_is_interval(tree)) {
+            _solRBTree_node_remax(tree, x);
+        }
+        *h = lh + 1;
+        return x;
+    }
+    solRBTreeNode_dye_red(x);
+    if (lh > rh) {
+        // down the right spine of l to a black node as high as r
+        root = y = l;
+        yh = lh;
+        while (solRBTreeNode_is_red(y) || yh > rh) {
+            if (solRBTreeNode_is_black(y)) {
+                yh--;
+            }
+            if (solRBTree_is_sized(tree)) {
+                solRBTreeNode_size(y) += solRBTreeNode_size(r) + 1;
+            }
+            p_node = y;
+            y = solRBTreeNode_right(y);
+        }
+        solRBTreeNode_set_right(p_node, x);
+        solRBTreeNode_set_left(x, y);
+        solRBTreeNode_set_right(x, r);
+        *h = lh;
+    } else {
+        root = y = r;
+        yh = rh;
+        while (solRBTreeNode_is_red(y) || yh > lh) {
+            if (solRBTreeNode_is_black(y)) {
+                yh--;
+            }
+            if (solRBTree_is_sized(tree)) {
+                solRBTreeNode_size(y) += solRBTreeNode_size(l) + 1;
+            }
+            p_node = y;
+            y = solRBTreeNode_left(y);
+        }
+        solRBTreeNode_set_left(p_node, x);
+        solRBTreeNode_set_left(x, l);
+        solRBTreeNode_set_right(x, y);
+        *h = rh;
+    }
+    solRBTreeNode_set_parent(x, p_node);
+    if (solRBTree_is_sized(tree)) {
+        solRBTreeNode_resize(x);
+    }
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_left(x))) {
+        solRBTreeNode_set_left_parent(x, x);
+    }
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(x))) {
+        solRBTreeNode_set_right_parent(x, x);
+    }
+    if (solRBTree_is_interval(tree)) {
+        // x and the spine above it took in the other subtree
+        for (y = x; solRBTree_node_is_NOT_nil(tree, y); y = solRBTreeNode_parent(y)) {
+            _solRBTree_node_remax(tree, y);
+        }
+    }
+    solRBTree_set_root(tree, root);
+    *h += solRBTree_insert_fixup(tree, x);
+    return solRBTree_root(tree);
+}
+
+/**
+ * move the vals of t2 and pivot into t1, every val of t1 < pivot < every val of t2
+ * O(log n) when the trees share a nil, see solRBTree_new_sibling, else t2 is relinked in O(n2)
+ * t2 is left empty
+ * @return 0 success, -1 vals out of order, allocators differ or only one is an interval or sized tree,
+ *         1 out of memory
+ */
+int solRBTree_join(SolRBTree *t1, void *pivot, SolRBTree *t2)
+{
+    if (solRBTree_allocator(t1) != solRBTree_allocator(t2) || t1->f_hi != t2->f_hi
+        || solRBTree_is_sized(t1) != solRBTree_is_sized(t2)
+        || (solRBTree_count(t1) && solRBTree_node_val_compare(t1, solRBTree_max(t1), pivot) >= 0)
+        || (solRBTree_count(t2) && solRBTree_node_val_compare(t1, pivot, solRBTree_min(t2)) >= 0)
+        ) {
+        return -1;
+    }
+    SolRBTreeNode *x = solAllocator_alloc(solRBTree_allocator(t1), solRBTree_node_bytes(t1));
+    if (x == NULL) {
+        return 1;
+    }
+    solRBTreeNode_set_val(x, pivot);
+    if (solRBTree_nil(t1) != solRBTree_nil(t2)) {
+        _solRBTree_adopt(t1, t2, solRBTree_root(t2));
+        if (solRBTree_node_is_NOT_nil(t2, solRBTree_root(t2))) {
+            solRBTreeNode_set_parent(solRBTree_root(t2), solRBTree_nil(t1));
+        } else {
+            solRBTree_set_root(t2, solRBTree_nil(t1));
+        }
+    }
+    size_t h;
+    size_t c = solRBTree_count(t1) + solRBTree_count(t2) + 1;
+    solRBTree_set_root(t1, _solRBTree_join(t1,
+                                           solRBTree_root(t1), _solRBTree_black_height(t1, solRBTree_root(t1)),
+                                           x,
+                                           solRBTree_root(t2), _solRBTree_black_height(t1, solRBTree_root(t2)),
+                                           &h));
+    solRBTree_set_count(t1, c);
+    solRBTree_set_root(t2, solRBTree_nil(t2));
+    t2->fg = NULL;
+    t2->c = 0;
+    return 0;
+}
+
+/**
+ * point the nil children of t2's subtree at t1's nil
+ */
+void _solRBTree_adopt(SolRBTree *t1, SolRBTree *t2, SolRBTreeNode *node)
+{
+    if (solRBTree_node_is_nil(t2, node)) {
+        return;
+    }
+    if (solRBTree_node_left_is_nil(t2, node)) {
+        solRBTreeNode_set_left(node, solRBTree_nil(t1));
+    } else {
+        _solRBTree_adopt(t1, t2, solRBTreeNode_left(node));
+    }
+    if (solRBTree_node_right_is_nil(t2, node)) {
+        solRBTreeNode_set_right(node, solRBTree_nil(t1));
+    } else {
+        _solRBTree_adopt(t1, t2, solRBTreeNode_right(node));
+    }
+}
+
+/**
+ * move the vals not less than val into a new sibling tree
+ * O(log n) in a sized tree, else the vals moved are counted too
+ * @return the new tree, NULL when out of memory and tree is untouched
+ */
+SolRBTree* solRBTree_split(SolRBTree *tree, void *val)
+{
+    SolRBTree *t2 = solRBTree_new_sibling(tree);
+    if (t2 == NULL) {
+        return NULL;
+    }
+    SolRBTreeNode *root = solRBTree_root(tree);
+    if (solRBTree_node_is_nil(tree, root)) {
+        return t2;
+    }
+    SolRBTreeNode *l, *r;
+    size_t lh, rh;
+    tree->fg = NULL;
+    _solRBTree_split(tree, root, _solRBTree_black_height(tree, root), val, &l, &lh, &r, &rh);
+    size_t c = 0;
+    if (solRBTree_is_sized(tree)) {
+        c = solRBTreeNode_size(r);
+    } else {
+        solRBTree_travelsal_inorder(tree, r, &_solRBTree_count_node, &c);
+    }
+    solRBTree_set_root(tree, l);
+    tree->c -= c;
+    solRBTree_set_root(t2, r);
+    solRBTree_set_count(t2, c);
+    return t2;
+}
+
+/**
+ * split the subtree at node, black root of black height h, into vals less than val in l
+ * and the rest in r, both come back with black roots
+ * the nodes on the search path are reused as join pivots, nothing is allocated
+ */
+void _solRBTree_split(SolRBTree *tree, SolRBTreeNode *node, size_t h, void *val,
+                      SolRBTreeNode **l, size_t *lh, SolRBTreeNode **r, size_t *rh)
+{
+    if (solRBTree_node_is_nil(tree, node)) {
+        *l = *r = node;
+        *lh = *rh = 0;
+        return;
+    }
+    SolRBTreeNode *ln = solRBTreeNode_left(node);
+    SolRBTreeNode *rn = solRBTreeNode_right(node);
+    size_t ch = h - (solRBTreeNode_is_black(node) ? 1 : 0);
+    size_t lch = _solRBTree_detach(tree, ln, ch);
+    size_t rch = _solRBTree_detach(tree, rn, ch);
+    SolRBTreeNode *m;
+    size_t mh;
+    if (solRBTree_node_val_compare(tree, val, solRBTreeNode_val(node)) <= 0) {
+        _solRBTree_split(tree, ln, lch, val, l, lh, &m, &mh);
+        *r = _solRBTree_join(tree, m, mh, node, rn, rch, rh);
+    } else {
+        _solRBTree_split(tree, rn, rch, val, &m, &mh, r, rh);
+        *l = _solRBTree_join(tree, ln, lch, node, m, mh, lh);
+    }
+}
+
+/**
+ * cut a child loose as a subtree of its own, a red root turns black
+ * @return its black height
+ */
+size_t _solRBTree_detach(SolRBTree *tree, SolRBTreeNode *node, size_t h)
+{
+    if (solRBTree_node_is_nil(tree, node)) {
+        return h;
+    }
+    solRBTreeNode_set_parent(node, solRBTree_nil(tree));
+    if (solRBTreeNode_is_red(node)) {
+        solRBTreeNode_dye_black(node);
+        return h + 1;
+    }
+    return h;
+}
+
+/**
+ * whole subtree traversals keep the path in a bounded array on the c stack, never recurse
+ * a red black tree is never deeper than the array, a deeper subtree goes on by parent pointers
+ * the next node is found before f runs, so f may free the node it is handed in backorder
+ * stop at the first f returning non 0 and return that, 1 for an empty subtree
+ */
 int solRBTree_travelsal_inorder(SolRBTree *tree, SolRBTreeNode *node, solRBTree_f_ptr_act f, void *d)
 {
     if (solRBTree_node_is_nil(tree, node)) return 1;
-    solRBTree_travelsal_inorder(tree, solRBTreeNode_left(node), f, d);
-    int r = (*f)(tree, node, d);
-    if (r != 0) return r;
-    solRBTree_travelsal_inorder(tree, solRBTreeNode_right(node), f, d);
-    return 0;
+    SolRBTreeNode *s[SOL_RBTREE_MAX_HEIGHT];
+    SolRBTreeNode *root = node, *next_node;
+    size_t k = 0;
+    int r;
+    for (;;) {
+        for (; solRBTree_node_is_NOT_nil(tree, node); node = solRBTreeNode_left(node)) {
+            if (k == SOL_RBTREE_MAX_HEIGHT) {
+                return _solRBTree_travelsal_walk(tree, root, solRBTree_search_min_node(tree, node),
+                                                 &_solRBTree_inorder_next, f, d);
+            }
+            s[k++] = node;
+        }
+        if (k == 0) return 0;
+        node = s[--k];
+        next_node = solRBTreeNode_right(node);
+        r = (*f)(tree, node, d);
+        if (r != 0) return r;
+        node = next_node;
+    }
 }
 
 int solRBTree_travelsal_preorder(SolRBTree *tree, SolRBTreeNode *node, solRBTree_f_ptr_act f, void *d)
 {
     if (solRBTree_node_is_nil(tree, node)) return 1;
-    int r = (*f)(tree, node, d);
-    if (r != 0) return r;
-    solRBTree_travelsal_preorder(tree, solRBTreeNode_left(node), f, d);
-    solRBTree_travelsal_preorder(tree, solRBTreeNode_right(node), f, d);
-    return 0;
+    // right branches waiting for their turn
+    SolRBTreeNode *s[SOL_RBTREE_MAX_HEIGHT];
+    SolRBTreeNode *root = node, *next_node;
+    size_t k = 0;
+    int r;
+    for (;;) {
+        if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(node))) {
+            if (k == SOL_RBTREE_MAX_HEIGHT) {
+                return _solRBTree_travelsal_walk(tree, root, node, &_solRBTree_preorder_next, f, d);
+            }
+            s[k++] = solRBTreeNode_right(node);
+        }
+        next_node = solRBTreeNode_left(node);
+        r = (*f)(tree, node, d);
+        if (r != 0) return r;
+        if (solRBTree_node_is_NOT_nil(tree, next_node)) {
+            node = next_node;
+        } else if (k) {
+            node = s[--k];
+        } else {
+            return 0;
+        }
+    }
 }
 
-
 int solRBTree_travelsal_backorder(SolRBTree *tree, SolRBTreeNode *node, solRBTree_f_ptr_act f, void *d)
 {
     if (solRBTree_node_is_nil(tree, node)) return 1;
-    solRBTree_travelsal_backorder(tree, solRBTreeNode_left(node), f, d);
-    solRBTree_travelsal_backorder(tree, solRBTreeNode_right(node), f, d);
-    int r = (*f)(tree, node, d);
-    if (r != 0) return r;
+    SolRBTreeNode *s[SOL_RBTREE_MAX_HEIGHT];
+    SolRBTreeNode *root = node, *done_node = NULL, *top_node;
+    size_t k = 0;
+    int r;
+    for (;;) {
+        for (; solRBTree_node_is_NOT_nil(tree, node); node = solRBTreeNode_left(node)) {
+            if (k == SOL_RBTREE_MAX_HEIGHT) {
+                return _solRBTree_travelsal_walk(tree, root, _solRBTree_backorder_first(tree, node),
+                                                 &_solRBTree_backorder_next, f, d);
+            }
+            s[k++] = node;
+        }
+        if (k == 0) return 0;
+        top_node = s[k - 1];
+        if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(top_node))
+            && solRBTreeNode_right(top_node) != done_node
+            ) {
+            // right branch first, the node stays on the stack
+            node = solRBTreeNode_right(top_node);
+            continue;
+        }
+        k--;
+        // only the address is kept, f may free the node
+        done_node = top_node;
+        r = (*f)(tree, top_node, d);
+        if (r != 0) return r;
+    }
+}
+
+/**
+ * rest of a traversal of root's subtree from node on, stepping by parent pointers
+ */
+int _solRBTree_travelsal_walk(SolRBTree *tree, SolRBTreeNode *root, SolRBTreeNode *node,
+                              SolRBTreeNode* (*next)(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*),
+                              solRBTree_f_ptr_act f, void *d)
+{
+    SolRBTreeNode *next_node;
+    int r;
+    for (; solRBTree_node_is_NOT_nil(tree, node); node = next_node) {
+        next_node = (*next)(tree, root, node);
+        r = (*f)(tree, node, d);
+        if (r != 0) return r;
+    }
     return 0;
 }
+
+/**
+ * node after n in preorder, nil past the end of root's subtree
+ */
+SolRBTreeNode* _solRBTree_preorder_next(SolRBTree *tree, SolRBTreeNode *root, SolRBTreeNode *n)
+{
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_left(n))) {
+        return solRBTreeNode_left(n);
+    }
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(n))) {
+        return solRBTreeNode_right(n);
+    }
+    // climb until coming up a left branch with a right sibling waiting
+    while (n != root) {
+        SolRBTreeNode *p = solRBTreeNode_parent(n);
+        if (n == solRBTreeNode_left(p) && solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(p))) {
+            return solRBTreeNode_right(p);
+        }
+        n = p;
+    }
+    return solRBTree_nil(tree);
+}
+
+/**
+ * node after n in inorder, nil past the end of root's subtree
+ */
+SolRBTreeNode* _solRBTree_inorder_next(SolRBTree *tree, SolRBTreeNode *root, SolRBTreeNode *n)
+{
+    if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(n))) {
+        return solRBTree_search_min_node(tree, solRBTreeNode_right(n));
+    }
+    // climb out of right branches, the first parent reached from the left is next
+    while (n != root && n == solRBTreeNode_right(solRBTreeNode_parent(n))) {
+        n = solRBTreeNode_parent(n);
+    }
+    return n == root ? solRBTree_nil(tree) : solRBTreeNode_parent(n);
+}
+
+/**
+ * first node of n's subtree in backorder, down left where possible, else right
+ */
+SolRBTreeNode* _solRBTree_backorder_first(SolRBTree *tree, SolRBTreeNode *n)
+{
+    for (;;) {
+        if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_left(n))) {
+            n = solRBTreeNode_left(n);
+        } else if (solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(n))) {
+            n = solRBTreeNode_right(n);
+        } else {
+            return n;
+        }
+    }
+}
+
+/**
+ * node after n in backorder, nil past the end of root's subtree
+ */
+SolRBTreeNode* _solRBTree_backorder_next(SolRBTree *tree, SolRBTreeNode *root, SolRBTreeNode *n)
+{
+    if (n == root) {
+        return solRBTree_nil(tree);
+    }
+    // parent comes after its right branch, which comes after the left one
+    SolRBTreeNode *p = solRBTreeNode_parent(n);
+    if (n == solRBTreeNode_left(p) && solRBTree_node_is_NOT_nil(tree, solRBTreeNode_right(p))) {
+        return _solRBTree_backorder_first(tree, solRBTreeNode_right(p));
+    }
+    return p;
+}
+
+/**
+ * keep subtree sizes in the nodes for select, rank and count_range in O(log n)
+ * costs a size_t a node and a walk to the root on every insert and delete
+ * @return 0 success, -1 tree not empty
+ */
+int solRBTree_set_sized(SolRBTree *tree)
+{
+    if (solRBTree_count(tree)) {
+        return -1;
+    }
+    tree->sz = 1;
+    return 0;
+}
+
+int _solRBTree_count_node(SolRBTree *tree, SolRBTreeNode *node, void *d)
+{
+    (*(size_t*)d)++;
+    return 0;
+}
+
+/**
+ * make an empty tree an interval tree, lo and hi give the start and end of a val, cmp compares them
+ * vals must be ordered by their starts first, every call keeps the largest end of each subtree
+ * @return 0 success, -1 tree not empty
+ */
+int solRBTree_set_interval_funcs(SolRBTree *tree, void* (*lo)(void*), void* (*hi)(void*), sol_f_cmp_ptr cmp)
+{
+    if (solRBTree_count(tree)) {
+        return -1;
+    }
+    tree->f_lo = lo;
+    tree->f_hi = hi;
+    tree->f_pos_compare = cmp;
+    return 0;
+}
+
+/**
+ * largest end below node from its own val and its children
+ */
+void _solRBTree_node_remax(SolRBTree *tree, SolRBTreeNode *node)
+{
+    void *m = solRBTree_val_hi(tree, solRBTreeNode_val(node));
+    SolRBTreeNode *c = solRBTreeNode_left(node);
+    if (solRBTree_node_is_NOT_nil(tree, c) && solRBTree_pos_compare(tree, solRBTreeNode_max(c), m) > 0) {
+        m = solRBTreeNode_max(c);
+    }
+    c = solRBTreeNode_right(node);
+    if (solRBTree_node_is_NOT_nil(tree, c) && solRBTree_pos_compare(tree, solRBTreeNode_max(c), m) > 0) {
+        m = solRBTreeNode_max(c);
+    }
+    solRBTreeNode_max(node) = m;
+}
+
+/**
+ * f on every node overlapping [lo, hi) in order, or holding lo when lo equals hi
+ * stop at the first f returning non 0 and return that
+ */
+int solRBTree_overlap_iter(SolRBTree *tree, void *lo, void *hi, solRBTree_f_ptr_act f, void *d)
+{
+    SolRBTreeOverlap o;
+    SolRBTreeNode *node;
+    int r;
+    solRBTreeOverlap_init(&o, tree, lo, hi);
+    while ((node = solRBTreeOverlap_next(&o))) {
+        r = (*f)(tree, node, d);
+        if (r != 0) {
+            return r;
+        }
+    }
+    return 0;
+}
+
+void solRBTreeOverlap_init(SolRBTreeOverlap *o, SolRBTree *tree, void *lo, void *hi)
+{
+    o->t = tree;
+    o->lo = lo;
+    o->hi = hi;
+    o->pt = solRBTree_pos_compare(tree, lo, hi) == 0;
+    o->n = _solRBTreeOverlap_first(o, solRBTree_root(tree));
+}
+
+/**
+ * next overlapping node, NULL past the last one
+ */
+SolRBTreeNode* solRBTreeOverlap_next(SolRBTreeOverlap *o)
+{
+    SolRBTreeNode *node = o->n;
+    if (solRBTree_node_is_nil(o->t, node)) {
+        return NULL;
+    }
+    o->n = _solRBTreeOverlap_after(o, node);
+    return node;
+}
+
+void* solRBTreeOverlap_next_val(SolRBTreeOverlap *o)
+{
+    SolRBTreeNode *node = solRBTreeOverlap_next(o);
+    return node ? solRBTreeNode_val(node) : NULL;
+}
+
+// some val below n ends after lo
+#define _solRBTreeOverlap_reaches(o, n) \
+    (solRBTree_node_is_NOT_nil((o)->t, n) && solRBTree_pos_compare((o)->t, solRBTreeNode_max(n), (o)->lo) > 0)
+// val v starts too late, and so does every val after it
+#define _solRBTreeOverlap_past(o, v) \
+    (solRBTree_pos_compare((o)->t, solRBTree_val_lo((o)->t, v), (o)->hi) > ((o)->pt ? 0 : -1))
+#define _solRBTreeOverlap_ends_after(o, v) \
+    (solRBTree_pos_compare((o)->t, solRBTree_val_hi((o)->t, v), (o)->lo) > 0)
+
+/**
+ * first overlapping node of the subtree at node in order, nil when none is left in the whole tree
+ * a left subtree reaching past lo either overlaps or starts past hi, then nothing after it overlaps
+ */
+SolRBTreeNode* _solRBTreeOverlap_first(SolRBTreeOverlap *o, SolRBTreeNode *node)
+{
+    if (!_solRBTreeOverlap_reaches(o, node)) {
+        return solRBTree_nil(o->t);
+    }
+    for (;;) {
+        if (_solRBTreeOverlap_reaches(o, solRBTreeNode_left(node))) {
+            node = solRBTreeNode_left(node);
+            continue;
+        }
+        if (_solRBTreeOverlap_past(o, solRBTreeNode_val(node))) {
+            return solRBTree_nil(o->t);
+        }
+        if (_solRBTreeOverlap_ends_after(o, solRBTreeNode_val(node))) {
+            return node;
+        }
+        // one of the three reaches past lo, only the right one is left
+        node = solRBTreeNode_right(node);
+    }
+}
+
+/**
+ * next overlapping node after node in order, nil when none
+ */
+SolRBTreeNode* _solRBTreeOverlap_after(SolRBTreeOverlap *o, SolRBTreeNode *node)
+{
+    SolRBTree *tree = o->t;
+    SolRBTreeNode *p;
+    if (_solRBTreeOverlap_reaches(o, solRBTreeNode_right(node))) {
+        return _solRBTreeOverlap_first(o, solRBTreeNode_right(node));
+    }
+    // up to the first ancestor still ahead, it and its right subtree come next
+    for (p = solRBTreeNode_parent(node); solRBTree_node_is_NOT_nil(tree, p); p = solRBTreeNode_parent(node)) {
+        if (node == solRBTreeNode_left(p)) {
+            if (_solRBTreeOverlap_past(o, solRBTreeNode_val(p))) {
+                return solRBTree_nil(tree);
+            }
+            if (_solRBTreeOverlap_ends_after(o, solRBTreeNode_val(p))) {
+                return p;
+            }
+            if (_solRBTreeOverlap_reaches(o, solRBTreeNode_right(p))) {
+                return _solRBTreeOverlap_first(o, solRBTreeNode_right(p));
+            }
+        }
+        node = p;
+    }
+    return solRBTree_nil(tree);
+}
+
+void solRBTreeRange_init(SolRBTreeRange *r, SolRBTree *tree, void *lo, void *hi)
+{
+    r->t = tree;
+    r->n = solRBTree_lower_bound(tree, lo);
+    r->hi = hi;
+}
+
+/**
+ * next node in the range, NULL past the end
+ */
+SolRBTreeNode* solRBTreeRange_next(SolRBTreeRange *r)
+{
+    SolRBTreeNode *node = r->n;
+    if (solRBTree_node_is_nil(r->t, node)
+        || solRBTree_node_val_compare(r->t, solRBTreeNode_val(node), r->hi) >= 0
+        ) {
+        return NULL;
+    }
+    r->n = solRBTree_search_successor(r->t, node);
+    return node;
+}
+
+void* solRBTreeRange_next_val(SolRBTreeRange *r)
+{
+    SolRBTreeNode *node = solRBTreeRange_next(r);
+    return node ? solRBTreeNode_val(node) : NULL;
+}
@@ -1,7 +1,14 @@
 #ifndef _SOL_BRTREE_H_
 #define _SOL_BRTREE_H_ 1
 
+#include <stdatomic.h>
 #include "sol_common.h"
+#include "sol_allocator.h"
+
+// deeper than any red black tree addressable memory can hold, 2 * log2(n + 1)
+#ifndef SOL_RBTREE_MAX_HEIGHT
+#define SOL_RBTREE_MAX_HEIGHT 128
+#endif
 
 enum _SolRBTreeCol {
     _SolRBTreeCol_red = 1,
@@ -16,52 +23,153 @@ typedef struct _SolRBTreeNode {
     void *val;
 } SolRBTreeNode;
 
+// node of a tree keeping subtree sizes, see solRBTree_set_sized
+typedef struct _SolRBTreeSNode {
+    SolRBTreeNode n;
+    size_t s; // nodes in the subtree, 0 for nil
+} SolRBTreeSNode;
+
+// node of an interval tree, s is only kept up when the tree is sized too
+typedef struct _SolRBTreeINode {
+    SolRBTreeSNode n;
+    void *m; // largest interval end in the subtree
+} SolRBTreeINode;
+
+// sentinel, shared by the trees split off one another, read as a node of any kind
+typedef struct _SolRBTreeNil {
+    SolRBTreeINode n;
+    atomic_size_t r; // trees using it
+} SolRBTreeNil;
+
+// trees sharing a nil may sit on different threads, but deletes on them must not overlap, delete writes nil->p
 typedef struct _SolRBTree {
     size_t c; // count
+    size_t pc; // peak count
     SolRBTreeNode *nil;
     SolRBTreeNode *root;
+    SolRBTreeNode *fg; // finger, last node reached through a hint, NULL for none
     sol_f_cmp_ptr f_compare;
     sol_f_free_ptr f_free; // free node val func
     int (*f_insert)(struct _SolRBTree*, SolRBTreeNode*);
+    void* (*f_lo)(void*); // start of an interval val
+    void* (*f_hi)(void*); // end of an interval val, NULL unless an interval tree
+    sol_f_cmp_ptr f_pos_compare; // compares starts and ends
+    int sz; // keeps subtree sizes
+    SolAllocator *a; // allocator, NULL for sol_alloc
 } SolRBTree;
 
+// cursor over the vals from lo up to but not including hi, keep it on the stack
+typedef struct _SolRBTreeRange {
+    SolRBTree *t;
+    SolRBTreeNode *n; // next node to hand out
+    void *hi;
+} SolRBTreeRange;
+
+// cursor over the vals of an interval tree overlapping [lo, hi), in order, keep it on the stack
+typedef struct _SolRBTreeOverlap {
+    SolRBTree *t;
+    SolRBTreeNode *n; // next node to hand out
+    void *lo;
+    void *hi;
+    int pt; // lo equal to hi, the vals holding the point lo
+} SolRBTreeOverlap;
+
 typedef int (*solRBTree_f_ptr_act)(SolRBTree*, SolRBTreeNode*, void*);
 
 SolRBTree* solRBTree_new();
+SolRBTree* solRBTree_new_with_allocator(SolAllocator*);
+SolRBTree* solRBTree_new_sibling(SolRBTree*);
 void solRBTree_free(SolRBTree*);
+void solRBTree_wipe(SolRBTree*);
 SolRBTreeNode* solRBTree_insert(SolRBTree*, void*);
+SolRBTreeNode* solRBTree_insert_or_get(SolRBTree*, void*, int*);
+SolRBTreeNode* solRBTree_insert_hint(SolRBTree*, SolRBTreeNode*, void*);
+SolRBTreeNode* _solRBTree_insert_below(SolRBTree*, SolRBTreeNode*, void*, int*);
+SolRBTreeNode* _solRBTree_link(SolRBTree*, SolRBTreeNode*, int, void*);
 int solRBTree_delete_node(SolRBTree*, SolRBTreeNode*);
 int solRBTree_del(SolRBTree*, void*);
+size_t solRBTree_delete_range(SolRBTree*, void*, void*);
+int solRBTree_build_sorted(SolRBTree*, void**, size_t);
+int solRBTree_join(SolRBTree*, void*, SolRBTree*);
+SolRBTree* solRBTree_split(SolRBTree*, void*);
 int solRBTree_node_free(SolRBTree*, SolRBTreeNode*);
 int _solRBTree_node_free(SolRBTree*, SolRBTreeNode*, void*);
 
 SolRBTreeNode* solRBTree_search_node(SolRBTree*, void*);
+SolRBTreeNode* solRBTree_search_hint(SolRBTree*, SolRBTreeNode*, void*);
+SolRBTreeNode* _solRBTree_finger(SolRBTree*, SolRBTreeNode*, void*);
 SolRBTreeNode* solRBTree_search_min_node(SolRBTree*, SolRBTreeNode*);
 SolRBTreeNode* solRBTree_search_max_node(SolRBTree*, SolRBTreeNode*);
 SolRBTreeNode* solRBTree_search_successor(SolRBTree*, SolRBTreeNode*);
+SolRBTreeNode* solRBTree_search_predecessor(SolRBTree*, SolRBTreeNode*);
+SolRBTreeNode* solRBTree_lower_bound(SolRBTree*, void*);
+SolRBTreeNode* solRBTree_upper_bound(SolRBTree*, void*);
+SolRBTreeNode* solRBTree_select_node(SolRBTree*, size_t);
 
 void* solRBTree_min(SolRBTree*);
 void* solRBTree_max(SolRBTree*);
+void* solRBTree_select(SolRBTree*, size_t);
+size_t solRBTree_rank(SolRBTree*, void*);
+size_t solRBTree_count_range(SolRBTree*, void*, void*);
 
 int solRBTree_left_rorate(SolRBTree*, SolRBTreeNode*);
 int solRBTree_right_rorate(SolRBTree*, SolRBTreeNode*);
-void solRBTree_insert_fixup(SolRBTree*, SolRBTreeNode*);
+int solRBTree_insert_fixup(SolRBTree*, SolRBTreeNode*);
 void solRBTree_delete_fixup(SolRBTree*, SolRBTreeNode*);
 
+SolRBTreeNode* _solRBTree_build(SolRBTree*, void**, size_t, size_t, size_t);
+size_t _solRBTree_black_height(SolRBTree*, SolRBTreeNode*);
+SolRBTreeNode* _solRBTree_join(SolRBTree*, SolRBTreeNode*, size_t, SolRBTreeNode*, SolRBTreeNode*, size_t, size_t*);
+void _solRBTree_split(SolRBTree*, SolRBTreeNode*, size_t, void*,
+                      SolRBTreeNode**, size_t*, SolRBTreeNode**, size_t*);
+size_t _solRBTree_detach(SolRBTree*, SolRBTreeNode*, size_t);
+void _solRBTree_adopt(SolRBTree*, SolRBTree*, SolRBTreeNode*);
+void _solRBTree_free_nodes(SolRBTree*, SolRBTreeNode*, sol_f_free_ptr);
+
+void solRBTree_memory_usage(SolRBTree*, SolMemoryUsage*);
+void _solRBTree_memory_usage(SolRBTree*, SolMemoryUsage*);
+
 int solRBTree_travelsal_inorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_act, void*);
 int solRBTree_travelsal_preorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_act, void*);
 int solRBTree_travelsal_backorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_act, void*);
+int _solRBTree_travelsal_walk(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*,
+                              SolRBTreeNode* (*)(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*),
+                              solRBTree_f_ptr_act, void*);
+SolRBTreeNode* _solRBTree_preorder_next(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*);
+SolRBTreeNode* _solRBTree_inorder_next(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*);
+SolRBTreeNode* _solRBTree_backorder_first(SolRBTree*, SolRBTreeNode*);
+SolRBTreeNode* _solRBTree_backorder_next(SolRBTree*, SolRBTreeNode*, SolRBTreeNode*);
+
+int solRBTree_set_sized(SolRBTree*);
+int _solRBTree_count_node(SolRBTree*, SolRBTreeNode*, void*);
+
+int solRBTree_set_interval_funcs(SolRBTree*, void* (*)(void*), void* (*)(void*), sol_f_cmp_ptr);
+void _solRBTree_node_remax(SolRBTree*, SolRBTreeNode*);
+int solRBTree_overlap_iter(SolRBTree*, void*, void*, solRBTree_f_ptr_act, void*);
+void solRBTreeOverlap_init(SolRBTreeOverlap*, SolRBTree*, void*, void*);
+SolRBTreeNode* solRBTreeOverlap_next(SolRBTreeOverlap*);
+void* solRBTreeOverlap_next_val(SolRBTreeOverlap*);
+SolRBTreeNode* _solRBTreeOverlap_first(SolRBTreeOverlap*, SolRBTreeNode*);
+SolRBTreeNode* _solRBTreeOverlap_after(SolRBTreeOverlap*, SolRBTreeNode*);
+
+void solRBTreeRange_init(SolRBTreeRange*, SolRBTree*, void*, void*);
+SolRBTreeNode* solRBTreeRange_next(SolRBTreeRange*);
+void* solRBTreeRange_next_val(SolRBTreeRange*);
 
 #define solRBTree_root(t) (t)->root
 #define solRBTree_nil(t) (t)->nil
 #define solRBTree_count(t) (t)->c
+#define solRBTree_finger(t) (t)->fg
+#define solRBTree_allocator(t) (t)->a
 
 #define solRBTree_set_root(t, n) (t)->root = n
 #define solRBTree_set_nil(t, n) (t)->nil = n
 #define solRBTree_node_is_nil(t, n) ((t)->nil == n)
 #define solRBTree_node_is_NOT_nil(t, n) ((t)->nil != n)
-#define solRBTree_count_inc(t) (t)->c++
+#define solRBTree_count_inc(t) ((t)->pc = ++(t)->c > (t)->pc ? (t)->c : (t)->pc)
 #define solRBTree_count_dec(t) (t)->c--
+#define solRBTree_set_count(t, x) ((t)->pc = ((t)->c = x) > (t)->pc ? (t)->c : (t)->pc)
+#define _solRBTree_nil_refs(t) ((SolRBTreeNil*)(t)->nil)->r
 
 #define solRBTree_set_val_free_func(t, f) (t)->f_free = f
 #define solRBTree_node_val_free_func(t) (t)->f_free
@@ -71,6 +179,14 @@ int solRBTree_travelsal_backorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_ac
 #define solRBTree_insert_func(t) (t)->f_insert
 #define solRBTree_insert_val(v) (*(t)->f_insert)(v)
 
+#define solRBTree_is_sized(t) (t)->sz
+#define solRBTree_is_interval(t) ((t)->f_hi != NULL)
+#define solRBTree_node_bytes(t) (solRBTree_is_interval(t) ? sizeof(SolRBTreeINode) \
+                                 : solRBTree_is_sized(t) ? sizeof(SolRBTreeSNode) : sizeof(SolRBTreeNode))
+#define solRBTree_val_lo(t, v) (*(t)->f_lo)(v)
+#define solRBTree_val_hi(t, v) (*(t)->f_hi)(v)
+#define solRBTree_pos_compare(t, p1, p2) (*(t)->f_pos_compare)(p1, p2)
+
 #define solRBTree_set_compare_func(t, f) (t)->f_compare = f
 #define solRBTree_node_val_compare_func(t) (t)->f_compare
 #define solRBTree_node_val_compare(t, v1, v2) (*(t)->f_compare)(v1, v2)
@@ -81,12 +197,18 @@ int solRBTree_travelsal_backorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_ac
 #define solRBTreeNode_parent(n) n->p
 #define solRBTreeNode_val(n) n->val
 #define solRBTreeNode_color(n) n->col
+// only in a sized tree
+#define solRBTreeNode_size(n) ((SolRBTreeSNode*)(n))->s
+#define solRBTreeNode_max(n) ((SolRBTreeINode*)(n))->m
 
 #define solRBTreeNode_set_left(n, x) n->l = x
 #define solRBTreeNode_set_right(n, x) n->r = x
 #define solRBTreeNode_set_parent(n, x) n->p = x
 #define solRBTreeNode_set_val(n, v) n->val = v
 #define solRBTreeNode_set_color(n, x) n->col = x
+#define solRBTreeNode_set_size(n, x) solRBTreeNode_size(n) = x
+// recount n from its children
+#define solRBTreeNode_resize(n) solRBTreeNode_size(n) = solRBTreeNode_size(n->l) + solRBTreeNode_size(n->r) + 1
 
 #define solRBTreeNode_dye(n, x) solRBTreeNode_set_color(n, x)
 #define solRBTreeNode_dye_red(n) solRBTreeNode_set_color(n, _SolRBTreeCol_red)
@@ -114,4 +236,45 @@ int solRBTree_travelsal_backorder(SolRBTree*, SolRBTreeNode*, solRBTree_f_ptr_ac
 #define solRBTree_node_left_is_nil(t, n) solRBTree_node_is_nil(t, solRBTreeNode_left(n))
 #define solRBTree_node_right_is_nil(t, n) solRBTree_node_is_nil(t, solRBTreeNode_right(n))
 
+/**
+ * typed search and insert for a tree of type vals, cmp(v1, v2) is a three way compare
+ * taking two type vals, a macro or inline func so it is inlined into the descent
+ * the tree itself, its rebalancing and every other call stay the shared ones
+ */
+#define SOL_RBTREE_DEFINE(name, type, cmp) \
+static inline SolRBTreeNode* name##_search_node(SolRBTree *t, type v) \
+{ \
+    int w; \
+    SolRBTreeNode *n = solRBTree_root(t); \
+    while (solRBTree_node_is_NOT_nil(t, n)) { \
+        w = cmp(v, (type)solRBTreeNode_val(n)); \
+        if (w == 0) { \
+            break; \
+        } \
+        n = w < 0 ? solRBTreeNode_left(n) : solRBTreeNode_right(n); \
+    } \
+    return n; \
+} \
+static inline SolRBTreeNode* name##_insert_or_get(SolRBTree *t, type v, int *is_new) \
+{ \
+    int w = 0; \
+    SolRBTreeNode *n = solRBTree_root(t); \
+    SolRBTreeNode *p = solRBTree_nil(t); \
+    while (solRBTree_node_is_NOT_nil(t, n)) { \
+        w = cmp(v, (type)solRBTreeNode_val(n)); \
+        if (w == 0) { \
+            if (is_new) { \
+                *is_new = 0; \
+            } \
+            return n; \
+        } \
+        p = n; \
+        n = w < 0 ? solRBTreeNode_left(n) : solRBTreeNode_right(n); \
+    } \
+    if (is_new) { \
+        *is_new = 1; \
+    } \
+    return _solRBTree_link(t, p, w, (void*)v); \
+}
+
 #endif
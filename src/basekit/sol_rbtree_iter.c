@@ -137,3 +137,45 @@ void* solRBTreeIter_next_val(SolRBTreeIter *i)
     solRBTreeIter_next(i);
     return solRBTreeIter_current_val(i);
 }
+
+/**
+ * walk the subtree under n, never climbs above n
+ */
+void solRBTreeWalk_init(SolRBTreeWalk *w, SolRBTree *t, SolRBTreeNode *n, SolRBTreeIterTravelsalType tt)
+{
+    w->tt = tt;
+    w->t = t;
+    w->n = n;
+    w->cn = NULL;
+}
+
+SolRBTreeNode* solRBTreeWalk_next(SolRBTreeWalk *w)
+{
+    SolRBTreeNode *n = w->cn;
+    if (n && solRBTree_node_is_nil(w->t, n)) {
+        return NULL;
+    }
+    if (n == NULL && solRBTree_node_is_nil(w->t, w->n)) {
+        n = w->n;
+    } else {
+        switch (w->tt) {
+        case SolRBTreeIterTT_preorder:
+            n = n ? _solRBTree_preorder_next(w->t, w->n, n) : w->n;
+            break;
+        case SolRBTreeIterTT_inorder:
+            n = n ? _solRBTree_inorder_next(w->t, w->n, n) : solRBTree_search_min_node(w->t, w->n);
+            break;
+        case SolRBTreeIterTT_backorder:
+            n = n ? _solRBTree_backorder_next(w->t, w->n, n) : _solRBTree_backorder_first(w->t, w->n);
+            break;
+        }
+    }
+    w->cn = n;
+    return solRBTree_node_is_nil(w->t, n) ? NULL : n;
+}
+
+void* solRBTreeWalk_next_val(SolRBTreeWalk *w)
+{
+    SolRBTreeNode *n = solRBTreeWalk_next(w);
+    return n ? solRBTreeNode_val(n) : NULL;
+}
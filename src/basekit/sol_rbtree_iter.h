@@ -19,6 +19,14 @@ typedef struct _SolRBTreeIter {
     SolStack *s;
 } SolRBTreeIter;
 
+// walk along the parent pointers, keep it on the stack, allocates nothing
+typedef struct _SolRBTreeWalk {
+    SolRBTreeIterTravelsalType tt;
+    SolRBTree *t;
+    SolRBTreeNode *n; // root of the walk
+    SolRBTreeNode *cn; // current node, NULL before the first, nil past the last
+} SolRBTreeWalk;
+
 SolRBTreeIter* solRBTreeIter_new(SolRBTree*, SolRBTreeNode*, SolRBTreeIterTravelsalType);
 SolRBTreeNode* solRBTreeIter_current(SolRBTreeIter*);
 void* solRBTreeIter_current_val(SolRBTreeIter*);
@@ -31,4 +39,8 @@ SolRBTreeNode* solRBTreeIter_next_preorder(SolRBTreeIter*);
 SolRBTreeNode* solRBTreeIter_next_inorder(SolRBTreeIter*);
 SolRBTreeNode* solRBTreeIter_next_backorder(SolRBTreeIter*);
 
+void solRBTreeWalk_init(SolRBTreeWalk*, SolRBTree*, SolRBTreeNode*, SolRBTreeIterTravelsalType);
+SolRBTreeNode* solRBTreeWalk_next(SolRBTreeWalk*);
+void* solRBTreeWalk_next_val(SolRBTreeWalk*);
+
 #endif
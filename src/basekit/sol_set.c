@@ -2,9 +2,14 @@
 
 SolSet* solSet_new()
 {
-    SolHash *hash = solHash_new();
+    return solSet_new_with_allocator(NULL);
+}
+
+SolSet* solSet_new_with_allocator(SolAllocator *a)
+{
+    SolHash *hash = solHash_new_with_allocator(a);
     SolHashIter *iter = solHashIter_new(hash);
-    SolSet *s = sol_alloc(sizeof(SolSet));
+    SolSet *s = solAllocator_alloc(a, sizeof(SolSet));
     s->hash = hash;
     s->iter = iter;
     return s;
@@ -12,9 +17,22 @@ SolSet* solSet_new()
 
 void solSet_free(SolSet *s)
 {
+    SolAllocator *a = solHash_allocator(s->hash);
     solHashIter_free(s->iter);
     solHash_free(s->hash);
-    sol_free(s);
+    solAllocator_free(a, s);
+}
+
+/**
+ * add struct, iter and hash of the set to u
+ */
+void _solSet_memory_usage(SolSet *s, SolMemoryUsage *u)
+{
+    solMemoryUsage_add(u, sb, sizeof(SolSet));
+    if (s->iter) {
+        solMemoryUsage_add(u, sb, sizeof(SolHashIter));
+    }
+    _solHash_memory_usage(s->hash, u);
 }
 
 inline void* solSet_current(SolSet *s)
@@ -35,11 +53,21 @@ void* solSet_get(SolSet *s)
     return r->k;
 }
 
+void* solSetIter_get(SolSetIter *i)
+{
+    SolHashRecord *r = solHashIter_get(i);
+    if (r == NULL) {
+        return NULL;
+    }
+    return r->k;
+}
+
 int solSet_is_subset(SolSet *s1, SolSet *s2)
 {
     void *v;
-    solSet_rewind(s2);
-    while ((v = solSet_get(s2))) {
+    SolSetIter i;
+    solSetIter_init(&i, s2);
+    while ((v = solSetIter_get(&i))) {
         if (solSet_in_set(s1, v) == 1) {
             return 1;
         }
@@ -50,8 +78,9 @@ int solSet_is_subset(SolSet *s1, SolSet *s2)
 int solSet_has_intersection(SolSet *s1, SolSet *s2)
 {
     void *v;
-    solSet_rewind(s1);
-    while ((v = solSet_get(s1))) {
+    SolSetIter i;
+    solSetIter_init(&i, s1);
+    while ((v = solSetIter_get(&i))) {
         if (solSet_in_set(s2, v) == 0) {
             return 0;
         }
@@ -76,15 +105,18 @@ void* solSet_get_value_of_intersection(SolSet *s1, SolSet *s2)
 
 SolSet* solSet_get_intersection(SolSet *s1, SolSet *s2)
 {
-    SolSet *s = solSet_new();
+    SolSet *s = solSet_new_with_allocator(solHash_allocator(s1->hash));
     solSet_set_hash_func1(s, solSet_hash_func1(s1));
     solSet_set_hash_func2(s, solSet_hash_func2(s1));
     solSet_set_equal_func(s, solSet_equal_func(s1));
     solSet_set_free_func(s, solSet_free_func(s1));
-    solSet_rewind(s1);
     void *v;
-    while ((v = solSet_get_value_of_intersection(s1, s2))) {
-        solSet_add(s, v);
+    SolSetIter i;
+    solSetIter_init(&i, s1);
+    while ((v = solSetIter_get(&i))) {
+        if (solSet_in_set(s2, v) == 0) {
+            solSet_add(s, v);
+        }
     }
     return s;
 }
@@ -108,8 +140,9 @@ int solSet_merge(SolSet *s, SolSet *s1)
     }
     int rtn = 0;
     void *v;
-    solSet_rewind(s1);
-    while ((v = solSet_get(s1))) {
+    SolSetIter i;
+    solSetIter_init(&i, s1);
+    while ((v = solSetIter_get(&i))) {
         rtn = solSet_add(s, v);
         if (rtn != 0) {
             return rtn;
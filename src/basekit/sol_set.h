@@ -10,8 +10,13 @@ typedef struct SolSet {
     SolHashIter *iter;
 } SolSet;
 
+// cursor over a set, keep it on the stack, the set is left untouched
+typedef SolHashIter SolSetIter;
+
 SolSet* solSet_new();
+SolSet* solSet_new_with_allocator(SolAllocator*);
 void solSet_free(SolSet*);
+void _solSet_memory_usage(SolSet*, SolMemoryUsage*);
 
 #define solSet_size(s) solHash_size(s->hash)
 #define solSet_set_hash_func1(s, f) solHash_set_hash_func1(s->hash, f)
@@ -41,7 +46,11 @@ SolSet* solSet_get_intersection(SolSet*, SolSet*);
 #define solSet_rewind(s) solHashIter_rewind(s->iter)
 #define solSet_next(s) solHashIter_next(s->iter)
 #define solSetIter_current_count(s) s->iter->c
-inline void* solSet_current(SolSet*);
+void* solSet_current(SolSet*);
+
+#define solSetIter_init(i, s) solHashIter_init(i, (s)->hash)
+#define solSetIter_rewind(i) solHashIter_rewind(i)
+void* solSetIter_get(SolSetIter*);
 
 void solSet_wipe(SolSet*);
 int solSet_dup(SolSet*, SolSet*);
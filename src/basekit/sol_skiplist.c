@@ -0,0 +1,400 @@
+#include "sol_skiplist.h"
+
+static _Thread_local SolSkipListThread _sol_skiplist_thread;
+
+SolSkipListThread* _solSkipList_thread()
+{
+    SolSkipListThread *th = &_sol_skiplist_thread;
+    if (th->s == 0) {
+        // every thread has its own copy, its address tells threads apart
+        th->s = (uint32_t)(((uintptr_t)th >> 4) * 2654435761u) | 1;
+    }
+    return th;
+}
+
+SolSkipList* solSkipList_new()
+{
+    return solSkipList_new_with_allocator(NULL);
+}
+
+SolSkipList* solSkipList_new_with_allocator(SolAllocator *a)
+{
+    SolSkipList *l = solAllocator_calloc(a, 1, sizeof(SolSkipList));
+    if (l == NULL) {
+        return NULL;
+    }
+    l->a = a;
+    l->hd = _solSkipListNode_new(l, NULL, SOL_SKIPLIST_MAX_LEVEL);
+    if (l->hd == NULL) {
+        solAllocator_free(a, l);
+        return NULL;
+    }
+    atomic_init(&l->c, 0);
+    atomic_init(&l->rt, NULL);
+    return l;
+}
+
+/**
+ * no other thread may touch the list any more, threads that deleted from it must have ended
+ * or called sol_epoch_flush, and the calling thread must not be inside sol_epoch_enter
+ */
+void solSkipList_free(SolSkipList *l)
+{
+    SolSkipListNode *n, *nx;
+    // deleted nodes still waiting point back at the list
+    sol_epoch_barrier();
+    n = _solSkipList_ptr(atomic_load_explicit(&l->hd->n[0], memory_order_acquire));
+    while (n) {
+        nx = _solSkipList_ptr(atomic_load_explicit(&n->n[0], memory_order_relaxed));
+        if (l->f_free) {
+            (*l->f_free)(n->val);
+        }
+        solAllocator_free(solSkipList_allocator(l), n);
+        n = nx;
+    }
+    _solSkipList_free_nodes(l, atomic_load_explicit(&l->rt, memory_order_acquire));
+    solAllocator_free(solSkipList_allocator(l), l->hd);
+    solAllocator_free(solSkipList_allocator(l), l);
+}
+
+/**
+ * @return 0 inserted, -1 an equal val is already there, 1 out of memory
+ */
+int solSkipList_insert(SolSkipList *l, void *val)
+{
+    SolSkipListNode *preds[SOL_SKIPLIST_MAX_LEVEL], *succs[SOL_SKIPLIST_MAX_LEVEL];
+    SolSkipListNode *n = NULL;
+    unsigned int h = _solSkipList_random_level(), i;
+    uintptr_t x;
+    sol_epoch_enter();
+    for (;;) {
+        if (_solSkipList_find(l, val, 0, preds, succs)) {
+            sol_epoch_exit();
+            if (n) {
+                solAllocator_free(solSkipList_allocator(l), n);
+            }
+            return -1;
+        }
+        if (n == NULL) {
+            n = _solSkipListNode_new(l, val, h);
+            if (n == NULL) {
+                sol_epoch_exit();
+                return 1;
+            }
+        }
+        for (i = 0; i < h; i++) {
+            atomic_store_explicit(&n->n[i], (uintptr_t)succs[i], memory_order_relaxed);
+        }
+        // in at the bottom level is in the list
+        x = (uintptr_t)succs[0];
+        if (atomic_compare_exchange_strong_explicit(&preds[0]->n[0], &x, (uintptr_t)n,
+                                                    memory_order_seq_cst, memory_order_relaxed)) {
+            break;
+        }
+    }
+    atomic_fetch_add_explicit(&l->c, 1, memory_order_relaxed);
+    for (i = 1; i < h; i++) {
+        for (;;) {
+            x = atomic_load_explicit(&n->n[i], memory_order_acquire);
+            if (_solSkipList_marked(x)) {
+                goto done;
+            }
+            // a failed exchange means a deleter has marked the level
+            if (_solSkipList_ptr(x) != succs[i]
+                && !atomic_compare_exchange_strong_explicit(&n->n[i], &x, (uintptr_t)succs[i],
+                                                            memory_order_seq_cst, memory_order_relaxed)) {
+                goto done;
+            }
+            x = (uintptr_t)succs[i];
+            if (atomic_compare_exchange_strong_explicit(&preds[i]->n[i], &x, (uintptr_t)n,
+                                                        memory_order_seq_cst, memory_order_relaxed)) {
+                break;
+            }
+            if (!_solSkipList_find(l, val, 0, preds, succs) || succs[0] != n) {
+                goto done;
+            }
+        }
+    }
+done:
+    _solSkipList_done(l, n);
+    sol_epoch_exit();
+    return 0;
+}
+
+/**
+ * @return 0 deleted, -1 no equal val
+ */
+int solSkipList_del(SolSkipList *l, void *val)
+{
+    SolSkipListNode *preds[SOL_SKIPLIST_MAX_LEVEL], *succs[SOL_SKIPLIST_MAX_LEVEL];
+    SolSkipListNode *n;
+    uintptr_t x;
+    int i;
+    sol_epoch_enter();
+    if (!_solSkipList_find(l, val, 0, preds, succs)) {
+        sol_epoch_exit();
+        return -1;
+    }
+    n = succs[0];
+    // mark from the top down, marking the bottom level deletes the val
+    for (i = n->h - 1; i > 0; i--) {
+        atomic_fetch_or_explicit(&n->n[i], 1, memory_order_seq_cst);
+    }
+    x = atomic_fetch_or_explicit(&n->n[0], 1, memory_order_seq_cst);
+    if (_solSkipList_marked(x)) {
+        // another thread deleted it first
+        sol_epoch_exit();
+        return -1;
+    }
+    atomic_fetch_sub_explicit(&l->c, 1, memory_order_relaxed);
+    _solSkipList_done(l, n);
+    sol_epoch_exit();
+    return 0;
+}
+
+void* solSkipList_search(SolSkipList *l, void *val)
+{
+    sol_epoch_enter();
+    SolSkipListNode *n = _solSkipList_seek(l, val, 0);
+    void *v = n && solSkipList_val_compare(l, n->val, val) == 0 ? n->val : NULL;
+    sol_epoch_exit();
+    return v;
+}
+
+/**
+ * first val not less than val, NULL when none
+ */
+void* solSkipList_lower_bound(SolSkipList *l, void *val)
+{
+    sol_epoch_enter();
+    SolSkipListNode *n = _solSkipList_seek(l, val, 0);
+    void *v = n ? n->val : NULL;
+    sol_epoch_exit();
+    return v;
+}
+
+/**
+ * first val greater than val, NULL when none
+ */
+void* solSkipList_upper_bound(SolSkipList *l, void *val)
+{
+    sol_epoch_enter();
+    SolSkipListNode *n = _solSkipList_seek(l, val, 1);
+    void *v = n ? n->val : NULL;
+    sol_epoch_exit();
+    return v;
+}
+
+void* solSkipList_min(SolSkipList *l)
+{
+    SolSkipListIter i;
+    void *v;
+    solSkipListIter_init(&i, l);
+    v = solSkipListIter_next(&i);
+    solSkipListIter_end(&i);
+    return v;
+}
+
+/**
+ * vals in order, stop at the first f returning non 0 and return that
+ * vals inserted or deleted meanwhile may or may not be seen
+ */
+int solSkipList_travelsal_inorder(SolSkipList *l, solSkipList_f_ptr_act f, void *d)
+{
+    SolSkipListIter i;
+    void *v;
+    int r = 0;
+    solSkipListIter_init(&i, l);
+    while (r == 0 && (v = solSkipListIter_next(&i))) {
+        r = (*f)(l, v, d);
+    }
+    solSkipListIter_end(&i);
+    return r;
+}
+
+void solSkipListIter_init(SolSkipListIter *i, SolSkipList *l)
+{
+    i->l = l;
+    sol_epoch_enter();
+    i->n = _solSkipList_ptr(atomic_load_explicit(&l->hd->n[0], memory_order_acquire));
+    while (i->n && _solSkipList_marked(atomic_load_explicit(&i->n->n[0], memory_order_acquire))) {
+        i->n = _solSkipList_ptr(atomic_load_explicit(&i->n->n[0], memory_order_acquire));
+    }
+}
+
+/**
+ * start at the first val not less than val
+ */
+void solSkipListIter_seek(SolSkipListIter *i, SolSkipList *l, void *val)
+{
+    i->l = l;
+    sol_epoch_enter();
+    i->n = _solSkipList_seek(l, val, 0);
+}
+
+void* solSkipListIter_next(SolSkipListIter *i)
+{
+    SolSkipListNode *n = i->n;
+    uintptr_t x;
+    if (n == NULL) {
+        return NULL;
+    }
+    x = atomic_load_explicit(&n->n[0], memory_order_acquire);
+    do {
+        i->n = _solSkipList_ptr(x);
+    } while (i->n && _solSkipList_marked(x = atomic_load_explicit(&i->n->n[0], memory_order_acquire)));
+    return n->val;
+}
+
+/**
+ * let nodes passed by go, the iterator can not be used afterwards
+ */
+void solSkipListIter_end(SolSkipListIter *i)
+{
+    sol_epoch_exit();
+    i->n = NULL;
+}
+
+SolSkipListNode* _solSkipListNode_new(SolSkipList *l, void *val, unsigned int h)
+{
+    SolSkipListNode *n = solAllocator_alloc(solSkipList_allocator(l),
+                                            sizeof(SolSkipListNode) + h * sizeof(_Atomic uintptr_t));
+    unsigned int i;
+    if (n == NULL) {
+        return NULL;
+    }
+    n->val = val;
+    n->rl = NULL;
+    n->h = h;
+    atomic_init(&n->lk, 2);
+    for (i = 0; i < h; i++) {
+        atomic_init(&n->n[i], 0);
+    }
+    return n;
+}
+
+unsigned int _solSkipList_random_level()
+{
+    SolSkipListThread *th = _solSkipList_thread();
+    uint32_t x = th->s;
+    unsigned int h = 1;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    th->s = x;
+    while (h < SOL_SKIPLIST_MAX_LEVEL && (x & 3) == 0) {
+        h++;
+        x >>= 2;
+    }
+    return h;
+}
+
+/**
+ * preds and succs around val on every level, unlinking deleted nodes on the way
+ * up looks past vals equal to val, which unlinks every deleted node holding it
+ * @return 1 when succs[0] holds val
+ */
+int _solSkipList_find(SolSkipList *l, void *val, int up, SolSkipListNode **preds, SolSkipListNode **succs)
+{
+    SolSkipListNode *pred, *curr;
+    uintptr_t succ, x;
+    int i, w = 1;
+retry:
+    pred = l->hd;
+    for (i = SOL_SKIPLIST_MAX_LEVEL - 1; i >= 0; i--) {
+        curr = _solSkipList_ptr(atomic_load_explicit(&pred->n[i], memory_order_acquire));
+        while (curr) {
+            succ = atomic_load_explicit(&curr->n[i], memory_order_acquire);
+            if (_solSkipList_marked(succ)) {
+                x = (uintptr_t)curr;
+                if (!atomic_compare_exchange_strong_explicit(&pred->n[i], &x, succ & ~(uintptr_t)1,
+                                                            memory_order_seq_cst, memory_order_relaxed)) {
+                    // pred changed or got deleted itself
+                    goto retry;
+                }
+                curr = _solSkipList_ptr(succ);
+                continue;
+            }
+            w = solSkipList_val_compare(l, curr->val, val);
+            if (w > 0 || (w == 0 && !up)) {
+                break;
+            }
+            pred = curr;
+            curr = _solSkipList_ptr(succ);
+        }
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+    return curr != NULL && w == 0;
+}
+
+/**
+ * first live node not less than val, or greater than it when up, nothing is written
+ */
+SolSkipListNode* _solSkipList_seek(SolSkipList *l, void *val, int up)
+{
+    SolSkipListNode *pred = l->hd, *curr = NULL;
+    uintptr_t succ;
+    int i, w;
+    for (i = SOL_SKIPLIST_MAX_LEVEL - 1; i >= 0; i--) {
+        curr = _solSkipList_ptr(atomic_load_explicit(&pred->n[i], memory_order_acquire));
+        while (curr) {
+            succ = atomic_load_explicit(&curr->n[i], memory_order_acquire);
+            if (!_solSkipList_marked(succ)) {
+                w = solSkipList_val_compare(l, curr->val, val);
+                if (w > 0 || (w == 0 && !up)) {
+                    break;
+                }
+                pred = curr;
+            }
+            curr = _solSkipList_ptr(succ);
+        }
+    }
+    return curr;
+}
+
+/**
+ * inserter and deleter both end here, the last one out retires a deleted node
+ */
+void _solSkipList_done(SolSkipList *l, SolSkipListNode *n)
+{
+    SolSkipListNode *preds[SOL_SKIPLIST_MAX_LEVEL], *succs[SOL_SKIPLIST_MAX_LEVEL];
+    if (_solSkipList_marked(atomic_load_explicit(&n->n[0], memory_order_acquire))) {
+        // marked on every level, no level is linked any more after this
+        _solSkipList_find(l, n->val, 1, preds, succs);
+    }
+    if (atomic_fetch_sub_explicit(&n->lk, 1, memory_order_acq_rel) == 1) {
+        _solSkipList_retire(l, n);
+    }
+}
+
+/**
+ * n is unlinked, free it once no thread inside may still hold it
+ */
+void _solSkipList_retire(SolSkipList *l, SolSkipListNode *n)
+{
+    if (sol_epoch_defer(&_solSkipList_f_reclaim, l, n)) {
+        // out of memory, keep it until the list goes
+        n->rl = atomic_load_explicit(&l->rt, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&l->rt, &n->rl, n, memory_order_release, memory_order_relaxed));
+    }
+}
+
+void _solSkipList_f_reclaim(void *l, void *n)
+{
+    ((SolSkipListNode*)n)->rl = NULL;
+    _solSkipList_free_nodes(l, n);
+}
+
+void _solSkipList_free_nodes(SolSkipList *l, SolSkipListNode *n)
+{
+    SolSkipListNode *nx;
+    while (n) {
+        nx = n->rl;
+        if (l->f_free) {
+            (*l->f_free)(n->val);
+        }
+        solAllocator_free(solSkipList_allocator(l), n);
+        n = nx;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef _SOL_SKIPLIST_H_
+#define _SOL_SKIPLIST_H_ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "sol_common.h"
+#include "sol_allocator.h"
+#include "sol_epoch.h"
+
+// a level more for one in four nodes, 16 levels cover 4G vals
+#ifndef SOL_SKIPLIST_MAX_LEVEL
+#define SOL_SKIPLIST_MAX_LEVEL 16
+#endif
+
+typedef struct _SolSkipListNode {
+    void *val;
+    struct _SolSkipListNode *rl; // next node sol_epoch_defer had no room for
+    _Atomic unsigned int lk; // inserter and deleter still at work on the node
+    unsigned int h; // levels
+    _Atomic uintptr_t n[]; // next node per level, low bit set once the node is deleted at that level
+} SolSkipListNode;
+
+// level generator of a thread
+typedef struct _SolSkipListThread {
+    uint32_t s; // xorshift state, 0 until first use
+} SolSkipListThread;
+
+/**
+ * lock free ordered set, any thread may insert, delete and search at the same time
+ * every call runs inside sol_epoch_enter, deleted nodes go to sol_epoch_defer
+ * and are freed once no thread that may still see them is inside
+ * with a val free func set, a val handed out may go with a concurrent delete,
+ * look at it through a SolSkipListIter then
+ */
+typedef struct _SolSkipList {
+    SolSkipListNode *hd; // head, holds no val
+    _Atomic size_t c; // count
+    sol_f_cmp_ptr f_compare;
+    sol_f_free_ptr f_free; // free val func, called when the node is reclaimed
+    SolAllocator *a; // allocator, NULL for sol_alloc
+    _Atomic(SolSkipListNode*) rt; // deleted nodes sol_epoch_defer had no room for, freed with the list
+} SolSkipList;
+
+// ordered cursor, stays inside sol_epoch_enter until solSkipListIter_end
+typedef struct _SolSkipListIter {
+    SolSkipList *l;
+    SolSkipListNode *n; // next node to return
+} SolSkipListIter;
+
+typedef int (*solSkipList_f_ptr_act)(SolSkipList*, void*, void*);
+
+SolSkipList* solSkipList_new();
+SolSkipList* solSkipList_new_with_allocator(SolAllocator*);
+void solSkipList_free(SolSkipList*);
+int solSkipList_insert(SolSkipList*, void*);
+int solSkipList_del(SolSkipList*, void*);
+void* solSkipList_search(SolSkipList*, void*);
+void* solSkipList_lower_bound(SolSkipList*, void*);
+void* solSkipList_upper_bound(SolSkipList*, void*);
+void* solSkipList_min(SolSkipList*);
+int solSkipList_travelsal_inorder(SolSkipList*, solSkipList_f_ptr_act, void*);
+
+void solSkipListIter_init(SolSkipListIter*, SolSkipList*);
+void solSkipListIter_seek(SolSkipListIter*, SolSkipList*, void*);
+void* solSkipListIter_next(SolSkipListIter*);
+void solSkipListIter_end(SolSkipListIter*);
+
+SolSkipListThread* _solSkipList_thread();
+SolSkipListNode* _solSkipListNode_new(SolSkipList*, void*, unsigned int);
+unsigned int _solSkipList_random_level();
+int _solSkipList_find(SolSkipList*, void*, int, SolSkipListNode**, SolSkipListNode**);
+SolSkipListNode* _solSkipList_seek(SolSkipList*, void*, int);
+void _solSkipList_done(SolSkipList*, SolSkipListNode*);
+void _solSkipList_retire(SolSkipList*, SolSkipListNode*);
+void _solSkipList_f_reclaim(void*, void*);
+void _solSkipList_free_nodes(SolSkipList*, SolSkipListNode*);
+
+// only a snapshot when other threads are working on the list
+#define solSkipList_count(l) atomic_load_explicit(&(l)->c, memory_order_relaxed)
+#define solSkipList_is_empty(l) (solSkipList_count(l) == 0)
+#define solSkipList_allocator(l) (l)->a
+
+#define solSkipList_set_compare_func(l, f) (l)->f_compare = f
+#define solSkipList_set_val_free_func(l, f) (l)->f_free = f
+#define solSkipList_val_compare(l, v1, v2) (*(l)->f_compare)(v1, v2)
+
+#define _solSkipList_ptr(x) ((SolSkipListNode*)((x) & ~(uintptr_t)1))
+#define _solSkipList_marked(x) ((x) & 1)
+
+#endif
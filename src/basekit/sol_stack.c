@@ -1,11 +1,69 @@
+#include <string.h>
 #include "sol_stack.h"
 
-void* solStack_pop(SolStack *s)
+SolStack* solStack_new()
 {
-    if (s->tail == NULL) {
+    SolStack *s = sol_alloc(sizeof(SolStack));
+    if (s == NULL) {
         return NULL;
     }
-    void *val = s->tail->val;
-    solDlList_del_node(s, s->tail);
-    return val;
+    solStack_init(s);
+    return s;
+}
+
+void solStack_free(SolStack *s)
+{
+    solStack_deinit(s);
+    sol_free(s);
+}
+
+/**
+ * init a stack living in other struct or on the stack
+ * call solStack_deinit when done with it
+ */
+void solStack_init(SolStack *s)
+{
+    s->c = 0;
+    s->s = SOL_STACK_INLINE_SIZE;
+    s->d = s->b;
+}
+
+void solStack_deinit(SolStack *s)
+{
+    if (s->d != s->b) {
+        sol_free(s->d);
+    }
+    solStack_init(s);
+}
+
+int solStack_reserve(SolStack *s, size_t size)
+{
+    if (size <= s->s) {
+        return 0;
+    }
+    void **d;
+    if (s->d == s->b) {
+        d = sol_alloc(sizeof(void*) * size);
+        if (d == NULL) {
+            return 1;
+        }
+        memcpy(d, s->b, sizeof(void*) * s->c);
+    } else {
+        d = sol_realloc(s->d, sizeof(void*) * size);
+        if (d == NULL) {
+            return 1;
+        }
+    }
+    s->d = d;
+    s->s = size;
+    return 0;
+}
+
+int _solStack_grow_push(SolStack *s, void *v)
+{
+    if (solStack_reserve(s, s->s * 2)) {
+        return 1;
+    }
+    s->d[s->c++] = v;
+    return 0;
 }
@@ -3,15 +3,33 @@
 
 #include <stddef.h>
 #include "sol_common.h"
-#include "sol_dl_list.h"
 
-typedef SolDlList SolStack;
+// slots kept inside the stack, small stacks never touch the heap
+#ifndef SOL_STACK_INLINE_SIZE
+#define SOL_STACK_INLINE_SIZE 16
+#endif
+
+typedef struct _SolStack {
+    size_t c; // count
+    size_t s; // capacity
+    void **d; // data
+    void *b[SOL_STACK_INLINE_SIZE]; // inline buffer
+} SolStack;
+
+SolStack* solStack_new();
+void solStack_free(SolStack*);
+void solStack_init(SolStack*);
+void solStack_deinit(SolStack*);
+int solStack_reserve(SolStack*, size_t);
+int _solStack_grow_push(SolStack*, void*);
 
-#define solStack_new() solDlList_new()
-#define solStack_free(s) solDlList_free(s)
-#define solStack_empty(s) (solDlList_len(s) == 0)
-#define solStack_size(s) solDlList_len(s)
-#define solStack_push(s, d) solDlList_add(s, d, _SolDlListDirFwd)
-void* solStack_pop(SolStack*);
+#define solStack_empty(x) ((x)->c == 0)
+#define solStack_size(x) (x)->c
+#define solStack_capacity(x) (x)->s
+#define solStack_wipe(x) (x)->c = 0
+#define solStack_top(x) ((x)->c ? (x)->d[(x)->c - 1] : NULL)
+// return 0 when pushed
+#define solStack_push(x, v) ((x)->c < (x)->s ? ((x)->d[(x)->c++] = (v), 0) : _solStack_grow_push(x, v))
+#define solStack_pop(x) ((x)->c ? (x)->d[--(x)->c] : NULL)
 
 #endif
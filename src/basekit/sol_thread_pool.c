@@ -0,0 +1,348 @@
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include "sol_thread_pool.h"
+
+_Thread_local SolThreadPoolWorker *_sol_thread_pool_worker = NULL;
+
+/**
+ * n 0 starts one worker per online cpu
+ */
+SolThreadPool* solThreadPool_new(size_t n)
+{
+    if (n == 0) {
+        long c = sysconf(_SC_NPROCESSORS_ONLN);
+        n = c > 0 ? (size_t)c : 1;
+    }
+    SolThreadPool *p = sol_calloc(1, sizeof(SolThreadPool));
+    if (p == NULL) {
+        return NULL;
+    }
+    p->w = sol_calloc(n, sizeof(SolThreadPoolWorker));
+    p->q = solMpmcQueue_new(SOL_THREAD_POOL_INJECT_SIZE);
+    if (p->w == NULL || p->q == NULL) {
+        goto oops;
+    }
+    atomic_init(&p->stop, 0);
+    _solQueueEvent_init(&p->ev);
+    size_t i;
+    for (i = 0; i < n; i++) {
+        p->w[i].p = p;
+        p->w[i].i = i;
+        p->w[i].r = (unsigned int)i * 2654435761u + 1;
+        p->w[i].d = solWsDeque_new();
+        if (p->w[i].d == NULL) {
+            goto oops;
+        }
+    }
+    p->n = n;
+    for (i = 0; i < n; i++) {
+        if (pthread_create(&p->w[i].t, NULL, _solThreadPool_worker_run, &p->w[i])) {
+            // stop the first i workers, p->n stays as they may read it
+            atomic_store_explicit(&p->stop, 1, memory_order_seq_cst);
+            _solQueueEvent_notify(&p->ev, i);
+            while (i > 0) {
+                pthread_join(p->w[--i].t, NULL);
+            }
+            goto oops;
+        }
+    }
+    return p;
+oops:
+    if (p->w) {
+        for (i = 0; i < n; i++) {
+            if (p->w[i].d) {
+                solWsDeque_free(p->w[i].d);
+            }
+        }
+        sol_free(p->w);
+    }
+    if (p->q) {
+        solMpmcQueue_free(p->q);
+    }
+    sol_free(p);
+    return NULL;
+}
+
+/**
+ * all spawned tasks should have been waited for
+ */
+void solThreadPool_free(SolThreadPool *p)
+{
+    size_t i;
+    atomic_store_explicit(&p->stop, 1, memory_order_seq_cst);
+    _solQueueEvent_notify(&p->ev, p->n);
+    for (i = 0; i < p->n; i++) {
+        pthread_join(p->w[i].t, NULL);
+    }
+    // workers steal from each other until they stop
+    for (i = 0; i < p->n; i++) {
+        solWsDeque_free(p->w[i].d);
+    }
+    if (p->w) {
+        sol_free(p->w);
+    }
+    if (p->q) {
+        solMpmcQueue_free(p->q);
+    }
+    sol_free(p);
+}
+
+/**
+ * run f(a) on the pool as part of group g
+ * a worker pushes to its own deque, other threads go through the inject queue
+ * the task runs on the calling thread when it can not be queued
+ */
+int solThreadPool_spawn(SolThreadPool *p, SolTaskGroup *g, sol_f_task_ptr f, void *a)
+{
+    SolTask *t = sol_alloc(sizeof(SolTask));
+    if (t == NULL) {
+        return 1;
+    }
+    t->f = f;
+    t->a = a;
+    t->g = g;
+    atomic_fetch_add_explicit(&g->c, 1, memory_order_relaxed);
+    SolThreadPoolWorker *w = _solThreadPool_current_worker(p);
+    if ((w && solWsDeque_push(w->d, t) == 0) || (w == NULL && _solMpmcQueue_enqueue(p->q, t) == 0)) {
+        _solQueueEvent_notify(&p->ev, 1);
+    } else {
+        _solThreadPool_run_task(t);
+    }
+    return 0;
+}
+
+/**
+ * run tasks of the pool until all tasks of g are done
+ */
+void solThreadPool_wait(SolThreadPool *p, SolTaskGroup *g)
+{
+    SolThreadPoolWorker *w = _solThreadPool_current_worker(p);
+    SolTask *t;
+    while (!solTaskGroup_done(g)) {
+        t = _solThreadPool_find_task(p, w);
+        if (t) {
+            _solThreadPool_run_task(t);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * call f over [b, e) split in ranges of at most grain
+ * ranges are halved recursively so idle workers steal big pieces first
+ * grain 0 picks about 8 ranges per worker
+ */
+int sol_parallel_for(SolThreadPool *p, size_t b, size_t e, size_t grain, sol_f_range_ptr f, void *ctx)
+{
+    if (b >= e) {
+        return 0;
+    }
+    SolTaskGroup g;
+    solTaskGroup_init(&g);
+    SolParallelCtx c;
+    memset(&c, 0, sizeof(SolParallelCtx));
+    c.p = p;
+    c.g = &g;
+    c.grain = grain ? grain : (e - b) / (solThreadPool_workers(p) * 8);
+    if (c.grain == 0) {
+        c.grain = 1;
+    }
+    c.f = f;
+    c.ctx = ctx;
+    _sol_parallel_for_range(&c, b, e);
+    solThreadPool_wait(p, &g);
+    return 0;
+}
+
+/**
+ * fold [b, e) into acc of size as
+ * acc holds the identity on call and the result on return
+ * f folds a range into an acc, j folds the second acc into the first
+ */
+int sol_parallel_reduce(SolThreadPool *p, size_t b, size_t e, size_t grain, void *acc, size_t as,
+                        sol_f_range_reduce_ptr f, sol_f_join_ptr j, void *ctx)
+{
+    if (b >= e) {
+        return 0;
+    }
+    SolParallelCtx c;
+    memset(&c, 0, sizeof(SolParallelCtx));
+    c.id = sol_alloc(as);
+    if (c.id == NULL) {
+        return 1;
+    }
+    memcpy(c.id, acc, as);
+    c.p = p;
+    c.grain = grain ? grain : (e - b) / (solThreadPool_workers(p) * 8);
+    if (c.grain == 0) {
+        c.grain = 1;
+    }
+    c.fr = f;
+    c.fj = j;
+    c.as = as;
+    c.ctx = ctx;
+    _sol_parallel_reduce_range(&c, b, e, acc);
+    sol_free(c.id);
+    return 0;
+}
+
+void* _solThreadPool_worker_run(void *a)
+{
+    SolThreadPoolWorker *w = a;
+    SolThreadPool *p = w->p;
+    SolTask *t;
+    size_t spin = 0;
+    uint32_t e;
+    _sol_thread_pool_worker = w;
+    for (;;) {
+        t = _solThreadPool_find_task(p, w);
+        if (t) {
+            _solThreadPool_run_task(t);
+            spin = 0;
+            continue;
+        }
+        if (atomic_load_explicit(&p->stop, memory_order_acquire)) {
+            break;
+        }
+        if (++spin < SOL_THREAD_POOL_SPIN) {
+            sched_yield();
+            continue;
+        }
+        e = _solQueueEvent_prepare(&p->ev);
+        t = _solThreadPool_find_task(p, w);
+        if (t) {
+            _solQueueEvent_cancel(&p->ev);
+            _solThreadPool_run_task(t);
+            spin = 0;
+            continue;
+        }
+        if (atomic_load_explicit(&p->stop, memory_order_seq_cst)) {
+            _solQueueEvent_cancel(&p->ev);
+            break;
+        }
+        _solQueueEvent_sleep(&p->ev, e);
+        spin = 0;
+    }
+    _sol_thread_pool_worker = NULL;
+    return NULL;
+}
+
+SolThreadPoolWorker* _solThreadPool_current_worker(SolThreadPool *p)
+{
+    SolThreadPoolWorker *w = _sol_thread_pool_worker;
+    return w && w->p == p ? w : NULL;
+}
+
+/**
+ * own deque first, then the inject queue, then steal from the others
+ */
+SolTask* _solThreadPool_find_task(SolThreadPool *p, SolThreadPoolWorker *w)
+{
+    void *v;
+    if (w && solWsDeque_take(w->d, &v) == 0) {
+        return v;
+    }
+    if (_solMpmcQueue_dequeue(p->q, &v) == 0) {
+        return v;
+    }
+    size_t i, k = 0;
+    int r;
+    if (w) {
+        // xorshift for the first victim
+        w->r ^= w->r << 13;
+        w->r ^= w->r >> 17;
+        w->r ^= w->r << 5;
+        k = w->r % p->n;
+    }
+    for (i = 0; i < p->n; i++, k++) {
+        if (k == p->n) {
+            k = 0;
+        }
+        if (&p->w[k] == w) {
+            continue;
+        }
+        do {
+            r = solWsDeque_steal(p->w[k].d, &v);
+        } while (r == SOL_WS_DEQUE_ABORT);
+        if (r == 0) {
+            return v;
+        }
+    }
+    return NULL;
+}
+
+void _solThreadPool_run_task(SolTask *t)
+{
+    SolTaskGroup *g = t->g;
+    (*t->f)(t->a);
+    sol_free(t);
+    atomic_fetch_sub_explicit(&g->c, 1, memory_order_release);
+}
+
+void _sol_parallel_for_range(SolParallelCtx *c, size_t b, size_t e)
+{
+    size_t m;
+    SolParallelRange *r;
+    while (e - b > c->grain) {
+        m = b + (e - b) / 2;
+        r = sol_alloc(sizeof(SolParallelRange));
+        if (r == NULL) {
+            break;
+        }
+        r->c = c;
+        r->b = m;
+        r->e = e;
+        if (solThreadPool_spawn(c->p, c->g, _sol_parallel_for_task, r)) {
+            sol_free(r);
+            break;
+        }
+        e = m;
+    }
+    (*c->f)(b, e, c->ctx);
+}
+
+void _sol_parallel_for_task(void *a)
+{
+    SolParallelRange *r = a;
+    SolParallelCtx *c = r->c;
+    size_t b = r->b, e = r->e;
+    sol_free(r);
+    _sol_parallel_for_range(c, b, e);
+}
+
+void _sol_parallel_reduce_range(SolParallelCtx *c, size_t b, size_t e, void *acc)
+{
+    if (e - b <= c->grain) {
+        (*c->fr)(b, e, c->ctx, acc);
+        return;
+    }
+    size_t m = b + (e - b) / 2;
+    SolParallelRange *r = sol_alloc(sizeof(SolParallelRange) + c->as);
+    if (r == NULL) {
+        (*c->fr)(b, e, c->ctx, acc);
+        return;
+    }
+    r->c = c;
+    r->b = m;
+    r->e = e;
+    memcpy(r->acc, c->id, c->as);
+    SolTaskGroup g;
+    solTaskGroup_init(&g);
+    if (solThreadPool_spawn(c->p, &g, _sol_parallel_reduce_task, r)) {
+        sol_free(r);
+        (*c->fr)(b, e, c->ctx, acc);
+        return;
+    }
+    _sol_parallel_reduce_range(c, b, m, acc);
+    solThreadPool_wait(c->p, &g);
+    (*c->fj)(acc, r->acc, c->ctx);
+    sol_free(r);
+}
+
+void _sol_parallel_reduce_task(void *a)
+{
+    SolParallelRange *r = a;
+    _sol_parallel_reduce_range(r->c, r->b, r->e, r->acc);
+}
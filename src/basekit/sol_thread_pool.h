@@ -0,0 +1,96 @@
+#ifndef _SOL_THREAD_POOL_H_
+#define _SOL_THREAD_POOL_H_ 1
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "sol_common.h"
+#include "sol_queue.h"
+#include "sol_ws_deque.h"
+
+// tasks queued by threads outside the pool
+#define SOL_THREAD_POOL_INJECT_SIZE 1024
+// rounds of stealing before an idle worker goes to sleep
+#define SOL_THREAD_POOL_SPIN 64
+
+typedef void (*sol_f_task_ptr)(void*);
+// run over [b, e)
+typedef void (*sol_f_range_ptr)(size_t, size_t, void*);
+// run over [b, e) folding into acc
+typedef void (*sol_f_range_reduce_ptr)(size_t, size_t, void*, void*);
+// fold the second acc into the first
+typedef void (*sol_f_join_ptr)(void*, void*, void*);
+
+// tasks spawned together, wait for all of them with solThreadPool_wait
+typedef struct _SolTaskGroup {
+    _Atomic size_t c; // pending tasks
+} SolTaskGroup;
+
+typedef struct _SolTask {
+    sol_f_task_ptr f; // func
+    void *a; // arg
+    SolTaskGroup *g; // group
+} SolTask;
+
+struct _SolThreadPool;
+
+typedef struct _SolThreadPoolWorker {
+    struct _SolThreadPool *p; // pool
+    SolWsDeque *d; // deque
+    pthread_t t; // thread
+    size_t i; // index
+    unsigned int r; // steal victim seed
+} SolThreadPoolWorker;
+
+typedef struct _SolThreadPool {
+    size_t n; // workers
+    SolThreadPoolWorker *w; // workers
+    SolMpmcQueue *q; // injected tasks
+    SolQueueEvent ev; // new work or stop
+    _Atomic int stop; // stop flag
+} SolThreadPool;
+
+// worker running on this thread, NULL outside any pool
+extern _Thread_local SolThreadPoolWorker *_sol_thread_pool_worker;
+
+typedef struct _SolParallelCtx {
+    SolThreadPool *p; // pool
+    SolTaskGroup *g; // group of parallel for
+    size_t grain; // smallest range to split
+    sol_f_range_ptr f; // for func
+    sol_f_range_reduce_ptr fr; // reduce func
+    sol_f_join_ptr fj; // join func
+    void *id; // identity of reduce acc
+    size_t as; // acc size
+    void *ctx; // user ctx
+} SolParallelCtx;
+
+typedef struct _SolParallelRange {
+    SolParallelCtx *c; // ctx
+    size_t b; // begin
+    size_t e; // end
+    char acc[]; // acc of the range, reduce only
+} SolParallelRange;
+
+void _sol_parallel_for_range(SolParallelCtx*, size_t, size_t);
+void _sol_parallel_for_task(void*);
+void _sol_parallel_reduce_range(SolParallelCtx*, size_t, size_t, void*);
+void _sol_parallel_reduce_task(void*);
+
+SolThreadPool* solThreadPool_new(size_t);
+void solThreadPool_free(SolThreadPool*);
+int solThreadPool_spawn(SolThreadPool*, SolTaskGroup*, sol_f_task_ptr, void*);
+void solThreadPool_wait(SolThreadPool*, SolTaskGroup*);
+int sol_parallel_for(SolThreadPool*, size_t, size_t, size_t, sol_f_range_ptr, void*);
+int sol_parallel_reduce(SolThreadPool*, size_t, size_t, size_t, void*, size_t,
+                        sol_f_range_reduce_ptr, sol_f_join_ptr, void*);
+void* _solThreadPool_worker_run(void*);
+SolThreadPoolWorker* _solThreadPool_current_worker(SolThreadPool*);
+SolTask* _solThreadPool_find_task(SolThreadPool*, SolThreadPoolWorker*);
+void _solThreadPool_run_task(SolTask*);
+
+#define solThreadPool_workers(p) (p)->n
+#define solTaskGroup_init(g) atomic_init(&(g)->c, 0)
+#define solTaskGroup_done(g) (atomic_load_explicit(&(g)->c, memory_order_acquire) == 0)
+
+#endif
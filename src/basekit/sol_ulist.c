@@ -0,0 +1,222 @@
+#include "sol_ulist.h"
+
+SolUList* solUList_new()
+{
+    SolUList *l = sol_calloc(1, sizeof(SolUList));
+    return l;
+}
+
+void solUList_free(SolUList *l)
+{
+    SolUListNode *n = solUList_head(l);
+    SolUListNode *nn;
+    while (n) {
+        nn = solUListNode_next(n);
+        solUListNode_free(l, n);
+        n = nn;
+    }
+    sol_free(l);
+}
+
+int solUList_add(SolUList *l, void *v)
+{
+    SolUListNode *n = solUList_tail(l);
+    if (n == NULL || solUListNode_count(n) == SOL_ULIST_NODE_SIZE) {
+        n = solUListNode_new();
+        if (n == NULL) {
+            return 1;
+        }
+        if (solUList_tail(l)) {
+            solUListNode_next(solUList_tail(l)) = n;
+        } else {
+            solUList_head(l) = n;
+        }
+        solUList_tail(l) = n;
+    }
+    n->v[n->c++] = v;
+    l->len++;
+    return 0;
+}
+
+int solUList_has(SolUList *l, void *v)
+{
+    SolUListNode *n = solUList_head(l);
+    if (n == NULL) {
+        return -1;
+    }
+    size_t o;
+    if (solUListVal_match_func(l)) {
+        do {
+            for (o = 0; o < n->c; o++) {
+                if (solUListVal_match(l, n->v[o], v) == 0) {
+                    return 0;
+                }
+            }
+        } while ((n = solUListNode_next(n)));
+    } else {
+        do {
+            for (o = 0; o < n->c; o++) {
+                if (n->v[o] == v) {
+                    return 0;
+                }
+            }
+        } while ((n = solUListNode_next(n)));
+    }
+    return 1;
+}
+
+/**
+ * remove all values matching v
+ * values left in a node are packed to its front, empty nodes are freed
+ */
+int solUList_remove(SolUList *l, void *v)
+{
+    SolUListNode *n = solUList_head(l);
+    SolUListNode *pn = NULL;
+    SolUListNode *nn;
+    size_t o, w;
+    while (n) {
+        nn = solUListNode_next(n);
+        for (o = 0, w = 0; o < n->c; o++) {
+            if (solUListVal_equal(l, n->v[o], v)) {
+                if (solUListVal_free_func(l)) {
+                    solUListVal_free(l, n->v[o]);
+                }
+                l->len--;
+            } else {
+                n->v[w++] = n->v[o];
+            }
+        }
+        n->c = w;
+        if (w == 0) {
+            if (pn) {
+                solUListNode_next(pn) = nn;
+            } else {
+                solUList_head(l) = nn;
+            }
+            if (solUList_tail(l) == n) {
+                solUList_tail(l) = pn;
+            }
+            sol_free(n);
+        } else {
+            pn = n;
+        }
+        n = nn;
+    }
+    return 1;
+}
+
+/**
+ * link nodes of l2 after l1 in O(1), l2 is freed
+ */
+int solUList_attach(SolUList *l1, SolUList *l2)
+{
+    if (l1 == NULL || l2 == NULL) {
+        return -1;
+    }
+    if (solUList_head(l1) == NULL) {
+        solUList_head(l1) = solUList_head(l2);
+    } else {
+        solUListNode_next(solUList_tail(l1)) = solUList_head(l2);
+    }
+    if (solUList_tail(l2)) {
+        solUList_tail(l1) = solUList_tail(l2);
+    }
+    l1->len += l2->len;
+    solUList_head(l2) = NULL;
+    solUList_tail(l2) = NULL;
+    l2->len = 0;
+    solUList_free(l2);
+    return 0;
+}
+
+int solUList_merge(SolUList *l1, SolUList *l2)
+{
+    if (l1 == NULL || l2 == NULL) {
+        return -1;
+    }
+    SolUListNode *n = solUList_head(l2);
+    size_t o;
+    while (n) {
+        for (o = 0; o < n->c; o++) {
+            if (solUList_add(l1, n->v[o])) {
+                return 1;
+            }
+        }
+        n = solUListNode_next(n);
+    }
+    return 0;
+}
+
+SolUList* solUList_dup(SolUList *l)
+{
+    if (l == NULL) return NULL;
+    SolUList *l1 = solUList_new();
+    if (l1 == NULL) return NULL;
+    if (solUList_merge(l1, l)) {
+        solUList_free(l1);
+        return NULL;
+    }
+    return l1;
+}
+
+SolUListNode* solUListNode_new()
+{
+    SolUListNode *n = sol_alloc(sizeof(SolUListNode));
+    if (n == NULL) {
+        return NULL;
+    }
+    n->next = NULL;
+    n->c = 0;
+    return n;
+}
+
+void solUListNode_free(SolUList *l, SolUListNode *n)
+{
+    size_t o;
+    if (solUListVal_free_func(l)) {
+        for (o = 0; o < n->c; o++) {
+            solUListVal_free(l, n->v[o]);
+        }
+    }
+    sol_free(n);
+}
+
+SolUListIter* solUListIter_new(SolUList *l)
+{
+    if (l == NULL) return NULL;
+    SolUListIter *i = sol_alloc(sizeof(SolUListIter));
+    if (i == NULL) return NULL;
+    solUListIter_init(i, l);
+    return i;
+}
+
+void solUListIter_init(SolUListIter *i, SolUList *l)
+{
+    i->l = l;
+    i->n = solUList_head(l);
+    i->o = 0;
+}
+
+void solUListIter_free(SolUListIter *i)
+{
+    if (i) sol_free(i);
+}
+
+void* solUListIter_current_val(SolUListIter *i)
+{
+    if (i == NULL || i->n == NULL)
+        return NULL;
+    return i->n->v[i->o];
+}
+
+void* solUListIter_next_val(SolUListIter *i)
+{
+    if (i == NULL || i->n == NULL) return NULL;
+    if (++i->o >= i->n->c) {
+        i->n = solUListNode_next(i->n);
+        i->o = 0;
+    }
+    if (i->n == NULL) return NULL;
+    return i->n->v[i->o];
+}
@@ -0,0 +1,69 @@
+#ifndef _SOL_ULIST_H_
+#define _SOL_ULIST_H_ 1
+
+#include "sol_common.h"
+
+// values per node, a node fills two 64 bytes cache lines
+#ifndef SOL_ULIST_NODE_SIZE
+#define SOL_ULIST_NODE_SIZE 14
+#endif
+
+typedef struct _SolUListNode {
+    struct _SolUListNode *next;
+    size_t c; // count
+    void *v[SOL_ULIST_NODE_SIZE];
+} SolUListNode;
+
+typedef struct _SolUList {
+    SolUListNode *head;
+    SolUListNode *tail;
+    unsigned long len;
+    void *(*f_dup)(void*);
+    void (*f_free)(void*);
+    int (*f_match)(void*, void*);
+} SolUList;
+
+typedef struct _SolUListIter {
+    SolUList *l;
+    SolUListNode *n;
+    size_t o; // offset in node
+} SolUListIter;
+
+#define solUList_head(l) (l)->head
+#define solUList_tail(l) (l)->tail
+#define solUList_len(l) (l)->len
+
+#define solUList_set_val_dup_func(l, f) (l)->f_dup = f
+#define solUList_set_val_free_func(l, f) (l)->f_free = f
+#define solUList_set_val_match_func(l, f) (l)->f_match = f
+
+#define solUListVal_free_func(l) (l)->f_free
+#define solUListVal_match_func(l) (l)->f_match
+
+#define solUListVal_free(l, v) (*(l)->f_free)(v)
+#define solUListVal_match(l, v1, v2) (*(l)->f_match)(v1, v2)
+#define solUListVal_equal(l, v1, v2) ((l)->f_match ? solUListVal_match(l, v1, v2) == 0 : (v1) == (v2))
+
+#define solUListNode_next(n) (n)->next
+#define solUListNode_count(n) (n)->c
+#define solUListNode_val(n, o) (n)->v[o]
+
+SolUList* solUList_new();
+void solUList_free(SolUList*);
+int solUList_add(SolUList*, void*);
+int solUList_remove(SolUList*, void*);
+int solUList_has(SolUList*, void*);
+int solUList_attach(SolUList*, SolUList*);
+int solUList_merge(SolUList*, SolUList*);
+SolUList* solUList_dup(SolUList*);
+
+SolUListNode* solUListNode_new();
+void solUListNode_free(SolUList*, SolUListNode*);
+
+SolUListIter* solUListIter_new(SolUList*);
+void solUListIter_init(SolUListIter*, SolUList*);
+void solUListIter_free(SolUListIter*);
+void* solUListIter_current_val(SolUListIter*);
+void* solUListIter_next_val(SolUListIter*);
+
+#endif
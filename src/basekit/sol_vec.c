@@ -0,0 +1,219 @@
+#include <string.h>
+#include "sol_vec.h"
+
+/**
+ * vec of elements of size es, stored inline
+ * es 0 makes a vec of pointers
+ * compare funcs of sort and search get addresses of elements
+ */
+SolVec* solVec_new(size_t es)
+{
+    return solVec_new_with_allocator(es, NULL);
+}
+
+SolVec* solVec_new_with_allocator(size_t es, SolAllocator *a)
+{
+    SolVec *v = solAllocator_calloc(a, 1, sizeof(SolVec));
+    if (v == NULL) {
+        return NULL;
+    }
+    v->es = es ? es : sizeof(void*);
+    v->a = a;
+    return v;
+}
+
+void solVec_free(SolVec *v)
+{
+    solVec_wipe(v);
+    if (v->d) {
+        solAllocator_free(v->a, v->d);
+    }
+    solAllocator_free(v->a, v);
+}
+
+void solVec_wipe(SolVec *v)
+{
+    size_t i;
+    if (solVec_val_free_func(v)) {
+        for (i = 0; i < v->c; i++) {
+            solVec_val_free(v, solVec_ptr(v, i));
+        }
+    }
+    v->c = 0;
+}
+
+int solVec_reserve(SolVec *v, size_t s)
+{
+    if (s <= v->s) {
+        return 0;
+    }
+    char *d = solAllocator_realloc(v->a, v->d, v->es * v->s, v->es * s);
+    if (d == NULL) {
+        return 1;
+    }
+    v->d = d;
+    v->s = s;
+    return 0;
+}
+
+int _solVec_grow(SolVec *v)
+{
+    if (v->c < v->s) {
+        return 0;
+    }
+    return solVec_reserve(v, v->s ? v->s * 2 : SOL_VEC_INIT_SIZE);
+}
+
+int solVec_push(SolVec *v, void *e)
+{
+    if (_solVec_grow(v)) {
+        return 1;
+    }
+    memcpy(v->d + v->es * v->c, e, v->es);
+    v->c++;
+    return 0;
+}
+
+int solVec_push_ptr(SolVec *v, void *p)
+{
+    return solVec_push(v, &p);
+}
+
+/**
+ * take the last element out, copy it to e when e is not NULL
+ */
+int solVec_pop(SolVec *v, void *e)
+{
+    if (v->c == 0) {
+        return 1;
+    }
+    v->c--;
+    if (e) {
+        memcpy(e, v->d + v->es * v->c, v->es);
+    }
+    return 0;
+}
+
+int solVec_insert(SolVec *v, size_t i, void *e)
+{
+    if (i > v->c) {
+        return -1;
+    }
+    if (_solVec_grow(v)) {
+        return 1;
+    }
+    memmove(v->d + v->es * (i + 1), v->d + v->es * i, v->es * (v->c - i));
+    memcpy(v->d + v->es * i, e, v->es);
+    v->c++;
+    return 0;
+}
+
+int solVec_remove(SolVec *v, size_t i)
+{
+    if (i >= v->c) {
+        return -1;
+    }
+    if (solVec_val_free_func(v)) {
+        solVec_val_free(v, solVec_ptr(v, i));
+    }
+    memmove(v->d + v->es * i, v->d + v->es * (i + 1), v->es * (v->c - i - 1));
+    v->c--;
+    return 0;
+}
+
+/**
+ * remove in O(1), the last element takes the hole
+ */
+int solVec_swap_remove(SolVec *v, size_t i)
+{
+    if (i >= v->c) {
+        return -1;
+    }
+    if (solVec_val_free_func(v)) {
+        solVec_val_free(v, solVec_ptr(v, i));
+    }
+    v->c--;
+    if (i != v->c) {
+        memcpy(v->d + v->es * i, v->d + v->es * v->c, v->es);
+    }
+    return 0;
+}
+
+/**
+ * move elements of v2 to the end of v1, v2 is freed
+ */
+int solVec_attach(SolVec *v1, SolVec *v2)
+{
+    if (v1 == NULL || v2 == NULL) {
+        return -1;
+    }
+    if (v1->es != v2->es) {
+        return -2;
+    }
+    if (solVec_reserve(v1, v1->c + v2->c)) {
+        return 1;
+    }
+    memcpy(v1->d + v1->es * v1->c, v2->d, v2->es * v2->c);
+    v1->c += v2->c;
+    v2->c = 0;
+    solVec_free(v2);
+    return 0;
+}
+
+// compare func of the sort running on this thread, qsort passes no context
+static _Thread_local sol_f_cmp_ptr _sol_vec_sort_f;
+
+static int _solVec_sort_compare(const void *e1, const void *e2)
+{
+    return (*_sol_vec_sort_f)((void*)e1, (void*)e2);
+}
+
+void solVec_sort(SolVec *v, sol_f_cmp_ptr f)
+{
+    if (v->c > 1) {
+        // f may sort a vec of its own
+        sol_f_cmp_ptr o = _sol_vec_sort_f;
+        _sol_vec_sort_f = f;
+        qsort(v->d, v->c, v->es, &_solVec_sort_compare);
+        _sol_vec_sort_f = o;
+    }
+}
+
+/**
+ * index of the first element not less than key, vec must be sorted
+ */
+size_t solVec_lower_bound(SolVec *v, void *k, sol_f_cmp_ptr f)
+{
+    size_t l = 0;
+    size_t h = v->c;
+    size_t m;
+    while (l < h) {
+        m = l + (h - l) / 2;
+        if ((*f)(solVec_get(v, m), k) < 0) {
+            l = m + 1;
+        } else {
+            h = m;
+        }
+    }
+    return l;
+}
+
+void* solVec_search(SolVec *v, void *k, sol_f_cmp_ptr f)
+{
+    size_t i = solVec_lower_bound(v, k, f);
+    if (i < v->c && (*f)(solVec_get(v, i), k) == 0) {
+        return solVec_get(v, i);
+    }
+    return NULL;
+}
+
+/**
+ * add struct and data of the vec to u, pointed vals are not counted
+ */
+void _solVec_memory_usage(SolVec *v, SolMemoryUsage *u)
+{
+    solMemoryUsage_add(u, sb, sizeof(SolVec));
+    if (v->d) {
+        solMemoryUsage_add(u, nb, v->s * v->es);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef _SOL_VEC_H_
+#define _SOL_VEC_H_ 1
+
+#include <stddef.h>
+#include "sol_common.h"
+#include "sol_allocator.h"
+
+#define SOL_VEC_INIT_SIZE 8
+
+typedef struct _SolVec {
+    size_t c; // count
+    size_t s; // capacity
+    size_t es; // element size
+    char *d; // data
+    sol_f_free_ptr f_free; // free val func, only for vec of pointers
+    SolAllocator *a; // allocator, NULL for sol_alloc
+} SolVec;
+
+SolVec* solVec_new(size_t);
+SolVec* solVec_new_with_allocator(size_t, SolAllocator*);
+void solVec_free(SolVec*);
+void solVec_wipe(SolVec*);
+int solVec_reserve(SolVec*, size_t);
+int _solVec_grow(SolVec*);
+int solVec_push(SolVec*, void*);
+int solVec_push_ptr(SolVec*, void*);
+int solVec_pop(SolVec*, void*);
+int solVec_insert(SolVec*, size_t, void*);
+int solVec_remove(SolVec*, size_t);
+int solVec_swap_remove(SolVec*, size_t);
+int solVec_attach(SolVec*, SolVec*);
+void solVec_sort(SolVec*, sol_f_cmp_ptr);
+size_t solVec_lower_bound(SolVec*, void*, sol_f_cmp_ptr);
+void* solVec_search(SolVec*, void*, sol_f_cmp_ptr);
+void _solVec_memory_usage(SolVec*, SolMemoryUsage*);
+
+#define solVec_count(v) (v)->c
+#define solVec_capacity(v) (v)->s
+#define solVec_elem_size(v) (v)->es
+#define solVec_allocator(v) (v)->a
+#define solVec_is_empty(v) ((v)->c == 0)
+
+#define solVec_set_val_free_func(v, f) (v)->f_free = f
+#define solVec_val_free_func(v) (v)->f_free
+#define solVec_val_free(v, x) (*(v)->f_free)(x)
+
+// address of element i
+#define solVec_get(v, i) ((void*)((v)->d + (v)->es * (i)))
+// value of element i, for vec of pointers
+#define solVec_ptr(v, i) (((void**)(v)->d)[i])
+
+#endif
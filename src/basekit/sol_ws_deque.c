@@ -0,0 +1,130 @@
+#include "sol_ws_deque.h"
+
+SolWsDeque* solWsDeque_new()
+{
+    SolWsDeque *d = sol_alloc(sizeof(SolWsDeque));
+    if (d == NULL) {
+        return NULL;
+    }
+    SolWsDequeArray *a = _solWsDequeArray_new(SOL_WS_DEQUE_INIT_SIZE);
+    if (a == NULL) {
+        sol_free(d);
+        return NULL;
+    }
+    atomic_init(&d->t, 0);
+    atomic_init(&d->b, 0);
+    atomic_init(&d->a, a);
+    return d;
+}
+
+/**
+ * no other thread may touch the deque any more
+ */
+void solWsDeque_free(SolWsDeque *d)
+{
+    SolWsDequeArray *a = atomic_load_explicit(&d->a, memory_order_relaxed);
+    SolWsDequeArray *o;
+    while (a) {
+        o = a->o;
+        sol_free(a);
+        a = o;
+    }
+    sol_free(d);
+}
+
+/**
+ * owner only, return 1 when the array can not grow
+ */
+int solWsDeque_push(SolWsDeque *d, void *v)
+{
+    ptrdiff_t b = atomic_load_explicit(&d->b, memory_order_relaxed);
+    ptrdiff_t t = atomic_load_explicit(&d->t, memory_order_acquire);
+    SolWsDequeArray *a = atomic_load_explicit(&d->a, memory_order_relaxed);
+    if (b - t > (ptrdiff_t)a->s - 1) {
+        a = _solWsDeque_grow(d, a, t, b);
+        if (a == NULL) {
+            return 1;
+        }
+    }
+    atomic_store_explicit(&a->v[b & (a->s - 1)], v, memory_order_relaxed);
+    atomic_store_explicit(&d->b, b + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * owner only, take the newest val
+ */
+int solWsDeque_take(SolWsDeque *d, void **v)
+{
+    ptrdiff_t b = atomic_load_explicit(&d->b, memory_order_relaxed) - 1;
+    SolWsDequeArray *a = atomic_load_explicit(&d->a, memory_order_relaxed);
+    atomic_store_explicit(&d->b, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    ptrdiff_t t = atomic_load_explicit(&d->t, memory_order_relaxed);
+    if (t > b) {
+        atomic_store_explicit(&d->b, b + 1, memory_order_relaxed);
+        return SOL_WS_DEQUE_EMPTY;
+    }
+    *v = atomic_load_explicit(&a->v[b & (a->s - 1)], memory_order_relaxed);
+    if (t == b) {
+        // last val, race thieves for it
+        int r = atomic_compare_exchange_strong_explicit(&d->t, &t, t + 1,
+                                                        memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->b, b + 1, memory_order_relaxed);
+        if (!r) {
+            return SOL_WS_DEQUE_EMPTY;
+        }
+    }
+    return 0;
+}
+
+/**
+ * any thread, take the oldest val
+ */
+int solWsDeque_steal(SolWsDeque *d, void **v)
+{
+    ptrdiff_t t = atomic_load_explicit(&d->t, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    ptrdiff_t b = atomic_load_explicit(&d->b, memory_order_acquire);
+    if (t >= b) {
+        return SOL_WS_DEQUE_EMPTY;
+    }
+    SolWsDequeArray *a = atomic_load_explicit(&d->a, memory_order_acquire);
+    *v = atomic_load_explicit(&a->v[t & (a->s - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->t, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return SOL_WS_DEQUE_ABORT;
+    }
+    return 0;
+}
+
+SolWsDequeArray* _solWsDequeArray_new(size_t s)
+{
+    SolWsDequeArray *a = sol_alloc(sizeof(SolWsDequeArray) + sizeof(_Atomic(void*)) * s);
+    if (a == NULL) {
+        return NULL;
+    }
+    a->s = s;
+    a->o = NULL;
+    return a;
+}
+
+/**
+ * thieves may still read the old array, so it is kept until the deque is freed
+ */
+SolWsDequeArray* _solWsDeque_grow(SolWsDeque *d, SolWsDequeArray *a, ptrdiff_t t, ptrdiff_t b)
+{
+    SolWsDequeArray *na = _solWsDequeArray_new(a->s * 2);
+    if (na == NULL) {
+        return NULL;
+    }
+    ptrdiff_t i;
+    for (i = t; i < b; i++) {
+        atomic_store_explicit(&na->v[i & (na->s - 1)],
+                              atomic_load_explicit(&a->v[i & (a->s - 1)], memory_order_relaxed),
+                              memory_order_relaxed);
+    }
+    na->o = a;
+    atomic_store_explicit(&d->a, na, memory_order_release);
+    return na;
+}
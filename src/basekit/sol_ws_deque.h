@@ -0,0 +1,41 @@
+#ifndef _SOL_WS_DEQUE_H_
+#define _SOL_WS_DEQUE_H_ 1
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sol_common.h"
+
+#define SOL_WS_DEQUE_INIT_SIZE 64
+
+#define SOL_WS_DEQUE_EMPTY 1
+// lost a race with the owner or another thief, try again
+#define SOL_WS_DEQUE_ABORT 2
+
+typedef struct _SolWsDequeArray {
+    size_t s; // size, power of two
+    struct _SolWsDequeArray *o; // older array, kept until the deque is freed
+    _Atomic(void*) v[]; // vals
+} SolWsDequeArray;
+
+// Chase-Lev work stealing deque
+// the owner pushes and takes at the bottom, other threads steal from the top
+typedef struct _SolWsDeque {
+    _Atomic ptrdiff_t t; // top
+    char _p0[SOL_CACHE_LINE_SIZE - sizeof(ptrdiff_t)];
+    _Atomic ptrdiff_t b; // bottom
+    _Atomic(SolWsDequeArray*) a; // array
+} SolWsDeque;
+
+SolWsDeque* solWsDeque_new();
+void solWsDeque_free(SolWsDeque*);
+int solWsDeque_push(SolWsDeque*, void*);
+int solWsDeque_take(SolWsDeque*, void**);
+int solWsDeque_steal(SolWsDeque*, void**);
+SolWsDequeArray* _solWsDequeArray_new(size_t);
+SolWsDequeArray* _solWsDeque_grow(SolWsDeque*, SolWsDequeArray*, ptrdiff_t, ptrdiff_t);
+
+// only a snapshot when other threads are working on the deque
+#define solWsDeque_count(d) \
+    (atomic_load_explicit(&(d)->b, memory_order_relaxed) - atomic_load_explicit(&(d)->t, memory_order_relaxed))
+
+#endif
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "sol_allocator.h"
+#include "sol_hash.h"
+#include "sol_list.h"
+#include "sol_rbtree.h"
+#include "sol_vec.h"
+#include "Hash_fnv.h"
+#include "Hash_murmur.h"
+
+size_t hash_func_murmur(void*);
+size_t hash_func_fnv32(void*);
+int equals(void*, void*);
+int cmp_int(void*, void*);
+
+int vals[] = {5, 3, 8, 1, 9, 2};
+
+size_t hash_func_murmur(void *key)
+{
+    int len = strlen((char *)key);
+    return MurmurHash2(key, len, 0);
+}
+
+size_t hash_func_fnv32(void *key)
+{
+    int len = strlen((char *)key);
+    return (size_t)fnv_32_buf(key, len, FNV1_32_INIT);
+}
+
+int equals(void *k1, void *k2)
+{
+    return strcmp((char *)k1, (char *)k2);
+}
+
+int cmp_int(void *v1, void *v2)
+{
+    return *(int*)v1 - *(int*)v2;
+}
+
+#define THREADS 4
+#define ROUNDS 200
+#define NODES 1000
+
+// build and destroy lists and trees, like a worker parsing its own input
+void* worker(void *a)
+{
+    SolAllocator *al = a;
+    int i, j;
+    for (i = 0; i < ROUNDS; i++) {
+        SolList *l = solList_new_with_allocator(al);
+        SolRBTree *t = solRBTree_new_with_allocator(al);
+        solRBTree_set_compare_func(t, &cmp_int);
+        for (j = 0; j < NODES; j++) {
+            solList_add(l, &cmp_int);
+            solRBTree_insert(t, &vals[j % 6]);
+        }
+        solList_free(l);
+        solRBTree_free(t);
+    }
+    // hand the magazines back before the numbers are read
+    sol_magazine_flush();
+    return NULL;
+}
+
+double run(SolAllocator *a)
+{
+    pthread_t t[THREADS];
+    struct timespec b, e;
+    int i;
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < THREADS; i++) {
+        pthread_create(&t[i], NULL, &worker, a);
+    }
+    for (i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    return (e.tv_sec - b.tv_sec) + (e.tv_nsec - b.tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        printf("malloc    %.3f s\n", run(NULL));
+        printf("magazine  %.3f s\n", run(&sol_magazine_allocator));
+        return 0;
+    }
+    SolArena *ar = solArena_new(1024);
+    SolAllocator *a = solArena_allocator(ar);
+    char *keys[] = {"one", "two", "three", "four", "five", "six"};
+    int i, round;
+    for (round = 0; round < 2; round++) {
+        SolHash *h = solHash_new_with_allocator(a);
+        solHash_set_hash_func1(h, &hash_func_murmur);
+        solHash_set_hash_func2(h, &hash_func_fnv32);
+        solHash_set_equal_func(h, &equals);
+        SolList *l = solList_new_with_allocator(a);
+        SolRBTree *t = solRBTree_new_with_allocator(a);
+        solRBTree_set_compare_func(t, &cmp_int);
+        SolVec *v = solVec_new_with_allocator(sizeof(int), a);
+        for (i = 0; i < 6; i++) {
+            solHash_put(h, keys[i], &vals[i]);
+            solList_add(l, keys[i]);
+            solRBTree_insert(t, &vals[i]);
+            solVec_push(v, &vals[i]);
+        }
+        printf("round %d: hash count %zu, list len %zu, vec count %zu\n",
+               round, solHash_count(h), solList_len(l), solVec_count(v));
+        printf("get three => %d, min %d, max %d\n", *(int*)solHash_get(h, "three"),
+               *(int*)solRBTree_min(t), *(int*)solRBTree_max(t));
+        printf("arena used %zu\n", solArena_used(ar));
+        SolMemoryUsage u;
+        solHash_memory_usage(h, &u);
+        printf("hash memory %zu (records %zu), peak %zu\n", u.b, u.rb, u.pb);
+        solRBTree_memory_usage(t, &u);
+        printf("rbtree memory %zu (nodes %zu) in %zu allocations\n", u.b, u.nb, u.n);
+        // everything above goes back at once
+        solArena_reset(ar);
+        printf("after reset used %zu\n", solArena_used(ar));
+    }
+    char *p = solArena_alloc(ar, 10);
+    strcpy(p, "arena");
+    char *q = solArena_realloc(ar, p, 10, 100);
+    printf("realloc last in place: %s, %s\n", q == p ? "yes" : "no", q);
+    solArena_alloc(ar, 8);
+    q = solArena_realloc(ar, p, 100, 200);
+    printf("realloc not last in place: %s, %s\n", q == p ? "yes" : "no", q);
+    p = solArena_alloc(ar, 4096);
+    printf("big alloc: %s, used %zu\n", p ? "ok" : "failed", solArena_used(ar));
+    solArena_free(ar);
+    // NULL allocator is plain sol_alloc
+    SolVec *v = solVec_new_with_allocator(sizeof(int), NULL);
+    solVec_push(v, &vals[0]);
+    printf("libc vec count %zu\n", solVec_count(v));
+    solVec_free(v);
+    run(&sol_magazine_allocator);
+    SolMagazineStats ms;
+    size_t k;
+    for (k = 0; sol_magazine_stats(k, &ms) == 0; k++) {
+        if (ms.a) {
+            printf("class %3zu: %zu allocs, %zu frees\n", ms.s, ms.a, ms.f);
+        }
+    }
+#ifdef SOL_ALLOC_STATS
+    SolAllocStats st;
+    sol_alloc_stats(&st);
+    printf("live %zu bytes in %zu allocations, peak %zu, %zu allocations made\n", st.b, st.n, st.pb, st.tn);
+#endif
+    return 0;
+}
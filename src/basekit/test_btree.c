@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "sol_btree.h"
+#include "sol_rbtree.h"
+
+#define N 100000
+#define BENCH_N 2000000
+
+// vals are the integers themselves
+int cmp_int(void *v1, void *v2)
+{
+    intptr_t a = (intptr_t)v1, b = (intptr_t)v2;
+    return (a > b) - (a < b);
+}
+
+// vals are malloc'd ints owned by the tree
+int cmp_pint(void *v1, void *v2)
+{
+    int a = *(int*)v1, b = *(int*)v2;
+    return (a > b) - (a < b);
+}
+
+int print_val(SolBTree *t, void *v, void *d)
+{
+    printf(" %ld", (long)(intptr_t)v);
+    return 0;
+}
+
+int sum_val(SolBTree *t, void *v, void *d)
+{
+    *(long*)d += (long)(intptr_t)v;
+    return 0;
+}
+
+int rb_sum_val(SolRBTree *t, SolRBTreeNode *n, void *d)
+{
+    *(long*)d += (long)(intptr_t)solRBTreeNode_val(n);
+    return 0;
+}
+
+// every val in order, the count agrees and the leaf chain runs both ways
+int check(SolBTree *t)
+{
+    SolBTreeIter i;
+    void *v, *pv = NULL;
+    size_t c = 0;
+    solBTreeIter_init(&i, t);
+    while ((v = solBTreeIter_next(&i))) {
+        if (c && cmp_int(pv, v) >= 0) {
+            return 1;
+        }
+        pv = v;
+        c++;
+    }
+    if (c != solBTree_count(t)) {
+        return 2;
+    }
+    solBTreeIter_init_last(&i, t);
+    while ((v = solBTreeIter_prev(&i))) {
+        c--;
+    }
+    return c != 0 ? 3 : 0;
+}
+
+int check_pint(SolBTree *t)
+{
+    SolBTreeIter i;
+    void *v, *pv = NULL;
+    size_t c = 0;
+    solBTreeIter_init(&i, t);
+    while ((v = solBTreeIter_next(&i))) {
+        if (c && cmp_pint(pv, v) >= 0) {
+            return 1;
+        }
+        if (solBTree_search(t, v) != v) {
+            return 2;
+        }
+        pv = v;
+        c++;
+    }
+    return c != solBTree_count(t) ? 3 : 0;
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void bench()
+{
+    SolBTree *bt = solBTree_new();
+    SolRBTree *rt = solRBTree_new();
+    solBTree_set_compare_func(bt, &cmp_int);
+    solRBTree_set_compare_func(rt, &cmp_int);
+    size_t i;
+    long s = 0;
+    double t;
+    for (i = 0; i < BENCH_N; i++) {
+        // odd multiplier walks all of [0, BENCH_N) in scattered order
+        intptr_t k = (intptr_t)((i * 2654435761u) % BENCH_N) + 1;
+        solBTree_insert(bt, (void*)k);
+        solRBTree_insert(rt, (void*)k);
+    }
+    t = now();
+    for (i = 0; i < BENCH_N; i++) {
+        s += solBTree_search(bt, (void*)(intptr_t)((i * 7919) % BENCH_N + 1)) != NULL;
+    }
+    printf("btree  search %.3f s\n", now() - t);
+    t = now();
+    for (i = 0; i < BENCH_N; i++) {
+        s += solRBTree_search_node(rt, (void*)(intptr_t)((i * 7919) % BENCH_N + 1)) != solRBTree_nil(rt);
+    }
+    printf("rbtree search %.3f s\n", now() - t);
+    t = now();
+    solBTree_travelsal_inorder(bt, &sum_val, &s);
+    printf("btree  scan   %.3f s\n", now() - t);
+    t = now();
+    solRBTree_travelsal_inorder(rt, solRBTree_root(rt), &rb_sum_val, &s);
+    printf("rbtree scan   %.3f s\n", now() - t);
+    SolMemoryUsage u;
+    solBTree_memory_usage(bt, &u);
+    printf("btree  %.1f bytes per key\n", (double)u.b / BENCH_N);
+    solRBTree_memory_usage(rt, &u);
+    printf("rbtree %.1f bytes per key\n", (double)u.b / BENCH_N);
+    printf("(%ld)\n", s);
+    solBTree_free(bt);
+    solRBTree_free(rt);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+    SolBTree *t = solBTree_new();
+    solBTree_set_compare_func(t, &cmp_int);
+    intptr_t i;
+    for (i = 1; i <= 40; i++) {
+        solBTree_insert(t, (void*)((i * 17) % 41));
+    }
+    printf("count %zu height %zu min %ld max %ld\n", solBTree_count(t), solBTree_height(t),
+           (long)(intptr_t)solBTree_min(t), (long)(intptr_t)solBTree_max(t));
+    printf("insert 5 again keeps %ld, count %zu\n", (long)(intptr_t)solBTree_insert(t, (void*)5), solBTree_count(t));
+    printf("range [10, 20):");
+    solBTree_range(t, (void*)10, (void*)20, &print_val, NULL);
+    printf("\n");
+    for (i = 2; i <= 40; i += 2) {
+        solBTree_del(t, (void*)i);
+    }
+    printf("odd:");
+    solBTree_travelsal_inorder(t, &print_val, NULL);
+    printf("\n");
+    printf("search 7: %ld, search 8: %p, del 8: %d\n", (long)(intptr_t)solBTree_search(t, (void*)7),
+           solBTree_search(t, (void*)8), solBTree_del(t, (void*)8));
+    solBTree_wipe(t);
+    // scattered inserts and deletes with a check of the whole tree on the way
+    for (i = 0; i < N; i++) {
+        solBTree_insert(t, (void*)((i * 7919) % N + 1));
+    }
+    printf("%zu vals, height %zu, check %d\n", solBTree_count(t), solBTree_height(t), check(t));
+    for (i = 0; i < N; i += 3) {
+        solBTree_del(t, (void*)((i * 104729) % N + 1));
+    }
+    printf("%zu vals, height %zu, check %d\n", solBTree_count(t), solBTree_height(t), check(t));
+    for (i = 1; i <= N; i++) {
+        solBTree_del(t, (void*)i);
+    }
+    printf("%zu vals, height %zu, check %d, min %p\n", solBTree_count(t), solBTree_height(t), check(t),
+           solBTree_min(t));
+    solBTree_free(t);
+    // the first val of a leaf is also a separator, deleting it must not leave a freed val behind
+    int *pv, k;
+    t = solBTree_new();
+    solBTree_set_compare_func(t, &cmp_pint);
+    solBTree_set_val_free_func(t, &free);
+    for (i = 1; i <= 100; i++) {
+        pv = malloc(sizeof(int));
+        *pv = i * 10;
+        solBTree_insert(t, pv);
+    }
+    // fill the second leaf past its minimum, no borrow or merge follows the delete
+    k = *(int*)t->hd->nx->n.k[0];
+    for (i = 1; i <= 4; i++) {
+        pv = malloc(sizeof(int));
+        *pv = k + i;
+        solBTree_insert(t, pv);
+    }
+    printf("del first of second leaf %d: %d, ", k, solBTree_del(t, &k));
+    printf("search %d: %p, ", k, solBTree_search(t, &k));
+    k++;
+    printf("search %d: %d, ", k, *(int*)solBTree_search(t, &k));
+    pv = malloc(sizeof(int));
+    *pv = k - 1;
+    solBTree_insert(t, pv);
+    printf("insert back, count %zu, check %d\n", solBTree_count(t), check_pint(t));
+    // built with a small SOL_BTREE_ORDER leaves run empty and merge away under these
+    for (i = 0; i < 100; i += 3) {
+        k = ((i * 37) % 100 + 1) * 10;
+        solBTree_del(t, &k);
+    }
+    printf("scattered deletes, count %zu, check %d\n", solBTree_count(t), check_pint(t));
+    solBTree_free(t);
+    return 0;
+}
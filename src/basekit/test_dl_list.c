@@ -1,6 +1,22 @@
 #include <stdio.h>
+#include <string.h>
 #include "sol_dl_list.h"
 
+size_t hash_s1(void *v)
+{
+    return (size_t)(*(char*)v);
+}
+
+size_t hash_s2(void *v)
+{
+    return (size_t)(*(char*)v) * 2654435761u;
+}
+
+int cmp_s(void *v1, void *v2)
+{
+    return strcmp((char*)v1, (char*)v2);
+}
+
 int main()
 {
     char *x = "a";
@@ -15,7 +31,38 @@ int main()
     while ((c = solDlListIter_next(i))) {
         printf("value is: %s\n", (char*)c->val);
     }
+    solDlList_add(l, "d", _SolDlListDirFwd);
+    solDlList_add(l, "c", _SolDlListDirFwd);
+    solDlList_add(l, y, _SolDlListDirFwd);
+    solDlList_uniq_hashed(l, &hash_s1, &hash_s2, &cmp_s);
+    solDlListIter_rewind(i);
+    while ((c = solDlListIter_next(i))) {
+        printf("uniq value is: %s\n", (char*)c->val);
+    }
+    solDlList_add(l, x, _SolDlListDirFwd);
+    solDlList_sort(l, &cmp_s);
+    solDlList_uniq_sorted(l, &cmp_s);
+    solDlListIter_free(i);
+    i = solDlListIter_new(l, _SolDlListDirBak);
+    while ((c = solDlListIter_next(i))) {
+        printf("sorted value backward is: %s\n", (char*)c->val);
+    }
+    printf("len is: %lu\n", solDlList_len(l));
     solDlListIter_free(i);
     solDlList_free(l);
+    // arena nodes can not go to free, attach copies them into the plain list
+    SolArena *ar = solArena_new(0);
+    l = solDlList_new();
+    SolDlList *la = solDlList_new_with_allocator(solArena_allocator(ar));
+    solDlList_add(l, x, _SolDlListDirFwd);
+    solDlList_add(la, y, _SolDlListDirFwd);
+    solDlList_add(la, "c", _SolDlListDirFwd);
+    printf("attach arena list: %d, values:", solDlList_attach(l, la));
+    for (c = l->head; c; c = c->next) {
+        printf(" %s", (char*)c->val);
+    }
+    printf(", len %lu\n", solDlList_len(l));
+    solDlList_free(l);
+    solArena_free(ar);
     return 0;
 }
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "sol_epoch.h"
+
+#define READERS 3
+#define WRITERS 2
+#define ROUNDS 100000
+#define BENCH_N 10000000
+
+typedef struct _Box {
+    size_t v;
+    size_t k; // 3 * v while the box is alive
+} Box;
+
+_Atomic(Box*) cur;
+_Atomic int done;
+size_t bad[READERS];
+size_t seen[READERS];
+
+// wipe the box before it goes, a reader still holding it would see k broken
+void poison_free(void *d, void *p)
+{
+    Box *b = p;
+    b->k = 0;
+    sol_free(b);
+    if (d) {
+        (*(size_t*)d)++;
+    }
+}
+
+void* reader(void *arg)
+{
+    size_t i = (size_t)arg;
+    Box *b;
+    do {
+        sol_epoch_enter();
+        b = atomic_load_explicit(&cur, memory_order_acquire);
+        if (b->k != 3 * b->v) {
+            bad[i]++;
+        }
+        seen[i]++;
+        sol_epoch_exit();
+    } while (!atomic_load(&done));
+    return NULL;
+}
+
+// every box swapped out is deferred, readers may still be looking at it
+void* writer(void *arg)
+{
+    size_t p = (size_t)arg, i;
+    Box *b, *o;
+    for (i = 1; i <= ROUNDS; i++) {
+        b = sol_alloc(sizeof(Box));
+        b->v = i * WRITERS + p;
+        b->k = 3 * b->v;
+        o = atomic_exchange_explicit(&cur, b, memory_order_acq_rel);
+        sol_epoch_defer(&poison_free, NULL, o);
+    }
+    return NULL;
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void bench()
+{
+    pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+    size_t i;
+    double t = now();
+    for (i = 0; i < BENCH_N; i++) {
+        sol_epoch_enter();
+        sol_epoch_exit();
+    }
+    printf("enter+exit         %.1f ns\n", (now() - t) * 1e9 / BENCH_N);
+    t = now();
+    for (i = 0; i < BENCH_N; i++) {
+        pthread_mutex_lock(&m);
+        pthread_mutex_unlock(&m);
+    }
+    printf("mutex lock+unlock  %.1f ns\n", (now() - t) * 1e9 / BENCH_N);
+    t = now();
+    for (i = 0; i < BENCH_N / 10; i++) {
+        sol_free_deferred(sol_alloc(sizeof(Box)));
+    }
+    sol_epoch_barrier();
+    printf("alloc+free deferred %.1f ns\n", (now() - t) * 1e9 / (BENCH_N / 10));
+    t = now();
+    for (i = 0; i < BENCH_N / 10; i++) {
+        sol_free(sol_alloc(sizeof(Box)));
+    }
+    printf("alloc+free         %.1f ns\n", (now() - t) * 1e9 / (BENCH_N / 10));
+}
+
+void print_stats(char *s)
+{
+    SolEpochStats st;
+    sol_epoch_stats(&st);
+    printf("%s: threads %zu, deferred %zu, freed %zu, waiting %zu\n", s, st.t, st.d, st.f, st.w);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+    size_t freed = 0, i;
+    Box *b;
+    sol_epoch_enter();
+    sol_epoch_enter();
+    for (i = 0; i < 10; i++) {
+        b = sol_alloc(sizeof(Box));
+        sol_epoch_defer(&poison_free, &freed, b);
+    }
+    printf("inside twice: barrier %d, ", sol_epoch_barrier());
+    sol_epoch_exit();
+    printf("inside once: barrier %d, ", sol_epoch_barrier());
+    printf("freed %zu, ", freed);
+    sol_epoch_exit();
+    printf("outside: barrier %d, ", sol_epoch_barrier());
+    printf("freed %zu\n", freed);
+    b = sol_alloc(sizeof(Box));
+    sol_free_deferred(b);
+    print_stats("one sol_free_deferred");
+    sol_epoch_flush();
+    sol_epoch_barrier();
+    print_stats("after barrier");
+
+    // readers never see a box freed under them
+    pthread_t rt[READERS], wt[WRITERS];
+    SolEpochStats st;
+    size_t n = 0, s = 0;
+    b = sol_alloc(sizeof(Box));
+    b->v = 0;
+    b->k = 0;
+    atomic_store(&cur, b);
+    for (i = 0; i < READERS; i++) {
+        pthread_create(&rt[i], NULL, reader, (void*)i);
+    }
+    for (i = 0; i < WRITERS; i++) {
+        pthread_create(&wt[i], NULL, writer, (void*)i);
+    }
+    for (i = 0; i < WRITERS; i++) {
+        pthread_join(wt[i], NULL);
+    }
+    atomic_store(&done, 1);
+    for (i = 0; i < READERS; i++) {
+        pthread_join(rt[i], NULL);
+        n += bad[i];
+        s += seen[i] > 0;
+    }
+    sol_epoch_barrier();
+    sol_epoch_stats(&st);
+    printf("%d writers, %d readers all reading %zu, bad %zu, epoch moved on %d\n", WRITERS, READERS, s, n, st.a > 2);
+    print_stats("threads joined");
+    sol_free(atomic_load(&cur));
+    return 0;
+}
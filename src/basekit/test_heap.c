@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include "sol_heap.h"
+
+int cmp_int(void *a, void *b)
+{
+    return *(int*)a - *(int*)b;
+}
+
+void pop_all(SolHeap *h)
+{
+    void *v;
+    printf("pop:");
+    while ((v = solHeap_pop(h))) {
+        printf(" %d", *(int*)v);
+    }
+    printf("\n");
+}
+
+int main()
+{
+    int d[20] = {15, 3, 17, 8, 1, 12, 19, 5, 10, 0, 7, 14, 2, 18, 6, 11, 4, 16, 9, 13};
+    int i;
+    SolHeap *h = solHeap_new(0);
+    solHeap_set_compare_func(h, cmp_int);
+    printf("arity: %zu\n", solHeap_arity(h));
+    for (i = 0; i < 20; i++) {
+        solHeap_push(h, &d[i]);
+    }
+    printf("count: %zu, peek: %d\n", solHeap_count(h), *(int*)solHeap_peek(h));
+    pop_all(h);
+    printf("empty? %d\n", solHeap_is_empty(h));
+
+    void *vals[20];
+    for (i = 0; i < 20; i++) {
+        vals[i] = &d[i];
+    }
+    solHeap_heapify(h, vals, 20);
+    printf("heapify count: %zu\n", solHeap_count(h));
+    pop_all(h);
+
+    int k[10] = {50, 40, 30, 20, 10, 60, 70, 80, 90, 100};
+    SolHeapNode *n[10];
+    for (i = 0; i < 10; i++) {
+        n[i] = solHeap_push_node(h, &k[i]);
+    }
+    k[7] = 5;
+    solHeap_decrease_key(h, n[7]);
+    printf("after decrease key, peek: %d\n", *(int*)solHeap_peek(h));
+    k[7] = 95;
+    solHeap_update(h, n[7]);
+    printf("after update, peek: %d\n", *(int*)solHeap_peek(h));
+    printf("remove: %d\n", *(int*)solHeap_remove(h, n[2]));
+    printf("remove: %d\n", *(int*)solHeap_remove(h, n[9]));
+    solHeap_push(h, &d[0]);
+    pop_all(h);
+    solHeap_free(h);
+
+    h = solHeap_new(2);
+    solHeap_set_compare_func(h, cmp_int);
+    for (i = 0; i < 20; i++) {
+        solHeap_push(h, &d[i]);
+    }
+    printf("binary heap ");
+    pop_all(h);
+    solHeap_free(h);
+    return 0;
+}
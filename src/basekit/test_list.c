@@ -3,6 +3,32 @@
 
 #define DC(x) char *x = #x
 
+size_t hash_i1(void *v)
+{
+    return (size_t)(*(int*)v);
+}
+
+size_t hash_i2(void *v)
+{
+    return (size_t)(*(int*)v) * 2654435761u;
+}
+
+int cmp_i(void *v1, void *v2)
+{
+    return *(int*)v1 - *(int*)v2;
+}
+
+void print_i_list(char *t, SolList *l)
+{
+    SolListNode *n = solList_head(l);
+    printf("%s (len %lu):", t, solList_len(l));
+    while (n) {
+        printf(" %d", *(int*)solListNode_val(n));
+        n = solListNode_next(n);
+    }
+    printf("\n");
+}
+
 int main()
 {
     DC(a);
@@ -63,5 +89,40 @@ int main()
         solList_free(l1);
     }
     solList_free(l);
-    return 1;
+    // plain nodes can not go to an arena, attach copies them into the arena list
+    SolArena *ar = solArena_new(0);
+    l = solList_new_with_allocator(solArena_allocator(ar));
+    l1 = solList_new();
+    solList_add(l, "x");
+    solList_add(l1, "y");
+    solList_add(l1, "z");
+    printf("attach to arena list: %d, values:", solList_attach(l, l1));
+    for (n = solList_head(l); n; n = solListNode_next(n)) {
+        printf(" %s", (char*)solListNode_val(n));
+    }
+    printf(", len %zu\n", (size_t)solList_len(l));
+    solList_free(l);
+    solArena_free(ar);
+    int iv[] = {5, 3, 9, 3, 1, 5, 7, 1, 9, 2};
+    int ic = sizeof(iv) / sizeof(int);
+    SolList *li = solList_new();
+    solList_set_val_match_func(li, &cmp_i);
+    for (lm = 0; lm < ic; lm++) {
+        solList_add(li, &iv[lm]);
+    }
+    SolList *li2 = solList_dup(li);
+    solList_set_val_match_func(li2, &cmp_i);
+    print_i_list("INT list", li);
+    solList_uniq_hashed(li, &hash_i1, &hash_i2);
+    print_i_list("UNIQ HASHED", li);
+    solList_sort(li, &cmp_i);
+    print_i_list("SORTED", li);
+    solList_sort(li2, &cmp_i);
+    print_i_list("SORTED dup", li2);
+    solList_uniq_sorted(li2);
+    print_i_list("UNIQ SORTED dup", li2);
+    printf("tail is [%d]\n", *(int*)solListNode_val(solList_tail(li2)));
+    solList_free(li);
+    solList_free(li2);
+    return 0;
 }
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <string.h>
+#include "sol_lru.h"
+#include "Hash_fnv.h"
+#include "Hash_murmur.h"
+
+size_t hash_func_murmur(void*);
+size_t hash_func_fnv32(void*);
+int equals(void *, void*);
+void on_evict(void*, void*);
+
+size_t hash_func_murmur(void *key)
+{
+    int len = strlen((char *)key);
+    return MurmurHash2(key, len, 0);
+}
+
+size_t hash_func_fnv32(void *key)
+{
+    int len = strlen((char *)key);
+    return (size_t)fnv_32_buf(key, len, FNV1_32_INIT);
+}
+
+int equals(void *k1, void *k2)
+{
+    return strcmp((char *)k1, (char *)k2);
+}
+
+void on_evict(void *k, void *v)
+{
+    printf("evict %s => %s\n", (char*)k, (char*)v);
+}
+
+int main()
+{
+    SolLRU *c = solLRU_new(3);
+    solLRU_set_hash_func1(c, &hash_func_murmur);
+    solLRU_set_hash_func2(c, &hash_func_fnv32);
+    solLRU_set_equal_func(c, &equals);
+    solLRU_set_evict_func(c, &on_evict);
+    solLRU_add(c, "a", "1");
+    solLRU_add(c, "b", "2");
+    solLRU_add(c, "c", "3");
+    printf("get a: %s\n", (char*)solLRU_get(c, "a"));
+    solLRU_add(c, "d", "4");
+    printf("get b: %s\n", (char*)solLRU_get(c, "b"));
+    printf("peek c: %s\n", (char*)solLRU_peek(c, "c"));
+    solLRU_add(c, "a", "10");
+    solLRU_add(c, "e", "5");
+    printf("get c: %s\n", (char*)solLRU_get(c, "c"));
+    printf("remove d: %d\n", solLRU_remove(c, "d"));
+    printf("remove d again: %d\n", solLRU_remove(c, "d"));
+    printf("count: %lu, used: %zu, hits: %zu, misses: %zu, evictions: %zu\n",
+           solLRU_count(c), solLRU_used(c), solLRU_hits(c), solLRU_misses(c), solLRU_evictions(c));
+    solLRU_free(c);
+
+    c = solLRU_new(100);
+    solLRU_set_hash_func1(c, &hash_func_murmur);
+    solLRU_set_hash_func2(c, &hash_func_fnv32);
+    solLRU_set_equal_func(c, &equals);
+    solLRU_set_evict_func(c, &on_evict);
+    solLRU_put(c, "small", "s", 10);
+    solLRU_put(c, "medium", "m", 40);
+    solLRU_put(c, "large", "l", 45);
+    printf("too big: %d\n", solLRU_put(c, "huge", "h", 101));
+    solLRU_get(c, "small");
+    solLRU_put(c, "other", "o", 30);
+    printf("bytes count: %lu, used: %zu\n", solLRU_count(c), solLRU_used(c));
+    solLRU_free(c);
+
+    SolClockCache *k = solClockCache_new(3);
+    solClockCache_set_hash_func1(k, &hash_func_murmur);
+    solClockCache_set_hash_func2(k, &hash_func_fnv32);
+    solClockCache_set_equal_func(k, &equals);
+    solClockCache_set_evict_func(k, &on_evict);
+    solClockCache_put(k, "a", "1");
+    solClockCache_put(k, "b", "2");
+    solClockCache_put(k, "c", "3");
+    printf("clock get a: %s\n", (char*)solClockCache_get(k, "a"));
+    printf("clock get c: %s\n", (char*)solClockCache_get(k, "c"));
+    solClockCache_put(k, "d", "4");
+    printf("clock get b: %s\n", (char*)solClockCache_get(k, "b"));
+    solClockCache_put(k, "e", "5");
+    solClockCache_put(k, "a", "11");
+    printf("clock remove e: %d\n", solClockCache_remove(k, "e"));
+    solClockCache_put(k, "f", "6");
+    printf("clock count: %zu, hits: %zu, misses: %zu, evictions: %zu\n",
+           solClockCache_count(k), solClockCache_hits(k), solClockCache_misses(k), solClockCache_evictions(k));
+    solClockCache_free(k);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include "sol_pool.h"
+#include "sol_list.h"
+#include "sol_dl_list.h"
+
+#define DC(x) char *x = #x
+
+int main()
+{
+    DC(a);
+    DC(b);
+    DC(c);
+    SolPool *p = solPool_new(sizeof(SolListNode), 2);
+    void *x1 = solPool_alloc(p);
+    void *x2 = solPool_alloc(p);
+    void *x3 = solPool_alloc(p);
+    printf("pool used: %zu\n", solPool_used(p));
+    solPool_recycle(p, x2);
+    printf("recycled slot reused? %d\n", solPool_alloc(p) == x2);
+    solPool_recycle(p, x1);
+    solPool_recycle(p, x2);
+    solPool_recycle(p, x3);
+    printf("pool used: %zu\n", solPool_used(p));
+    SolList *l1 = solList_new();
+    SolList *l2 = solList_new();
+    solList_set_pool(l1, p);
+    solList_set_pool(l2, p);
+    solPool_free(p);
+    solList_add(l1, a);
+    solList_add(l1, b);
+    solList_add(l2, c);
+    printf("pool used: %zu\n", solPool_used(p));
+    solList_remove(l1, a);
+    printf("pool used: %zu\n", solPool_used(p));
+    solList_attach(l1, l2);
+    SolListNode *n = solList_head(l1);
+    while (n) {
+        printf("shared pool list node val is [%s]\n", (char*)solListNode_val(n));
+        n = solListNode_next(n);
+    }
+    SolList *l3 = solList_new();
+    solList_add(l3, a);
+    solList_attach(l1, l3);
+    n = solList_head(l1);
+    while (n) {
+        printf("attached list node val is [%s]\n", (char*)solListNode_val(n));
+        n = solListNode_next(n);
+    }
+    printf("pool used: %zu\n", solPool_used(p));
+    solList_free(l1);
+    SolDlList *dl = solDlList_new();
+    p = solDlList_pool_new(0);
+    solDlList_set_pool(dl, p);
+    solPool_free(p);
+    int i;
+    for (i = 0; i < 200; i++) {
+        solDlList_add(dl, a, _SolDlListDirFwd);
+    }
+    solDlList_del_node(dl, solDlList_head(dl));
+    printf("dl list len: %lu, pool used: %zu\n", solDlList_len(dl), solPool_used(p));
+    solDlList_free(dl);
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "sol_prbtree.h"
+#include "sol_queue.h"
+
+#define READERS 3
+#define ROUNDS 2000
+#define K 64
+#define BENCH_N 1000000
+
+SolMpmcQueue *q;
+size_t bad[READERS];
+
+// vals are the integers themselves
+int cmp_int(void *v1, void *v2)
+{
+    intptr_t a = (intptr_t)v1, b = (intptr_t)v2;
+    return (a > b) - (a < b);
+}
+
+int print_val(SolPRBTree *t, void *v, void *d)
+{
+    printf(" %ld", (long)(intptr_t)v);
+    return 0;
+}
+
+int sum_val(SolPRBTree *t, void *v, void *d)
+{
+    *(long*)d += (long)(intptr_t)v;
+    return 0;
+}
+
+void print_tree(char *s, SolPRBTree *t)
+{
+    printf("%s (%zu):", s, solPRBTree_count(t));
+    solPRBTree_travelsal_inorder(t, &print_val, NULL);
+    printf("\n");
+}
+
+// every snapshot holds one unbroken run of vals, the writer keeps moving on
+void* reader(void *arg)
+{
+    size_t i = (size_t)arg;
+    SolPRBTree *s;
+    long lo, hi, sum;
+    while ((s = solMpmcQueue_dequeue_wait(q))) {
+        lo = (long)(intptr_t)solPRBTree_min(s);
+        hi = (long)(intptr_t)solPRBTree_max(s);
+        sum = 0;
+        solPRBTree_travelsal_inorder(s, &sum_val, &sum);
+        if ((long)solPRBTree_count(s) != hi - lo + 1 || sum != (lo + hi) * (hi - lo + 1) / 2) {
+            bad[i]++;
+        }
+        solPRBTree_free(s);
+    }
+    return NULL;
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void bench()
+{
+    SolPRBTree *t = solPRBTree_new();
+    SolPRBTree *s;
+    solPRBTree_set_compare_func(t, &cmp_int);
+    size_t i;
+    double tm = now();
+    for (i = 0; i < BENCH_N; i++) {
+        solPRBTree_insert(t, (void*)(intptr_t)((i * 2654435761u) % BENCH_N + 1));
+    }
+    printf("insert          %.3f s\n", now() - tm);
+    tm = now();
+    for (i = 0; i < BENCH_N; i++) {
+        s = solPRBTree_snapshot(t);
+        solPRBTree_free(s);
+    }
+    printf("snapshot+free   %.3f s\n", now() - tm);
+    // a live snapshot makes every update copy its path
+    s = solPRBTree_snapshot(t);
+    tm = now();
+    for (i = 0; i < BENCH_N; i += 2) {
+        solPRBTree_del(t, (void*)(intptr_t)((i * 7919) % BENCH_N + 1));
+    }
+    printf("del, shared     %.3f s\n", now() - tm);
+    solPRBTree_free(s);
+    tm = now();
+    for (i = 1; i < BENCH_N; i += 2) {
+        solPRBTree_del(t, (void*)(intptr_t)((i * 7919) % BENCH_N + 1));
+    }
+    printf("del, unshared   %.3f s\n", now() - tm);
+    solPRBTree_free(t);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+    SolPRBTree *t = solPRBTree_new();
+    SolPRBTree *s1, *s2;
+    solPRBTree_set_compare_func(t, &cmp_int);
+    intptr_t i;
+    for (i = 1; i <= 10; i++) {
+        solPRBTree_insert(t, (void*)i);
+    }
+    s1 = solPRBTree_snapshot(t);
+    for (i = 2; i <= 10; i += 2) {
+        solPRBTree_del(t, (void*)i);
+    }
+    solPRBTree_insert(t, (void*)20);
+    s2 = solPRBTree_snapshot(t);
+    solPRBTree_insert(t, (void*)30);
+    printf("insert 3 again: %d, del 4 again: %d\n", solPRBTree_insert(t, (void*)3), solPRBTree_del(t, (void*)4));
+    print_tree("s1", s1);
+    print_tree("s2", s2);
+    print_tree("t", t);
+    printf("search 6 in s1: %ld, in t: %p\n", (long)(intptr_t)solPRBTree_search(s1, (void*)6),
+           solPRBTree_search(t, (void*)6));
+    solPRBTree_free(s1);
+    solPRBTree_free(t);
+    print_tree("s2 alone", s2);
+    solPRBTree_free(s2);
+
+    // one writer, readers walk snapshots while it goes on updating
+    pthread_t rt[READERS];
+    size_t j, r, n = 0;
+    t = solPRBTree_new();
+    solPRBTree_set_compare_func(t, &cmp_int);
+    q = solMpmcQueue_new(64);
+    for (j = 0; j < READERS; j++) {
+        pthread_create(&rt[j], NULL, reader, (void*)j);
+    }
+    for (r = 0; r < ROUNDS; r++) {
+        for (j = 1; j <= K; j++) {
+            solPRBTree_insert(t, (void*)(intptr_t)(r * K + j));
+        }
+        if (r >= 4) {
+            for (j = 1; j <= K; j++) {
+                solPRBTree_del(t, (void*)(intptr_t)((r - 4) * K + j));
+            }
+        }
+        solMpmcQueue_enqueue_wait(q, solPRBTree_snapshot(t));
+    }
+    for (j = 0; j < READERS; j++) {
+        solMpmcQueue_enqueue_wait(q, NULL);
+    }
+    for (j = 0; j < READERS; j++) {
+        pthread_join(rt[j], NULL);
+        n += bad[j];
+    }
+    printf("%d snapshots read by %d threads, bad %zu, writer left %zu vals\n", ROUNDS, READERS, n,
+           solPRBTree_count(t));
+    solMpmcQueue_free(q);
+    solPRBTree_free(t);
+    return 0;
+}
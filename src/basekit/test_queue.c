@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <pthread.h>
+#include "sol_queue.h"
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS 200000
+
+SolMpmcQueue *mq;
+SolSpscQueue *sq;
+size_t sums[CONSUMERS];
+size_t counts[CONSUMERS];
+
+void* mpmc_producer(void *arg)
+{
+    size_t p = (size_t)arg;
+    size_t i;
+    for (i = 0; i < ITEMS; i++) {
+        solMpmcQueue_enqueue_wait(mq, (void*)(p * ITEMS + i + 1));
+    }
+    return NULL;
+}
+
+void* mpmc_consumer(void *arg)
+{
+    size_t c = (size_t)arg;
+    size_t v;
+    for (;;) {
+        v = (size_t)solMpmcQueue_dequeue_wait(mq);
+        if (v == 0) {
+            break;
+        }
+        sums[c] += v;
+        counts[c]++;
+    }
+    return NULL;
+}
+
+void* spsc_producer(void *arg)
+{
+    void *b[32];
+    size_t i = 1, j, n;
+    while (i <= ITEMS) {
+        for (j = 0; j < 32 && i + j <= ITEMS; j++) {
+            b[j] = (void*)(i + j);
+        }
+        n = solSpscQueue_enqueue_batch(sq, b, j);
+        if (n == 0) {
+            solSpscQueue_enqueue_wait(sq, b[0]);
+            n = 1;
+        }
+        i += n;
+    }
+    solSpscQueue_enqueue_wait(sq, NULL);
+    return NULL;
+}
+
+int main()
+{
+    size_t i, n;
+    void *v;
+    void *b[8];
+
+    mq = solMpmcQueue_new(5);
+    printf("mpmc capacity: %zu\n", solMpmcQueue_capacity(mq));
+    for (i = 1; i <= 10; i++) {
+        if (solMpmcQueue_enqueue(mq, (void*)i)) {
+            printf("full at %zu, count: %zu\n", i, solMpmcQueue_count(mq));
+            break;
+        }
+    }
+    while (solMpmcQueue_dequeue(mq, &v) == 0) {
+        printf("dequeue: %zu\n", (size_t)v);
+    }
+    for (i = 0; i < 8; i++) {
+        b[i] = (void*)(i + 100);
+    }
+    n = solMpmcQueue_enqueue_batch(mq, b, 0);
+    printf("empty batch enqueued: %zu, ", n);
+    n = solMpmcQueue_dequeue_batch(mq, b, 0);
+    printf("dequeued: %zu\n", n);
+    n = solMpmcQueue_enqueue_batch(mq, b, 3);
+    printf("batch enqueued: %zu\n", n);
+    n = solMpmcQueue_enqueue_batch(mq, b + 3, 5);
+    printf("batch enqueued: %zu\n", n);
+    n = solMpmcQueue_dequeue_batch(mq, b, 8);
+    printf("batch dequeued: %zu:", n);
+    for (i = 0; i < n; i++) {
+        printf(" %zu", (size_t)b[i]);
+    }
+    printf("\n");
+    solMpmcQueue_free(mq);
+
+    pthread_t pt[PRODUCERS], ct[CONSUMERS];
+    mq = solMpmcQueue_new(64);
+    for (i = 0; i < CONSUMERS; i++) {
+        pthread_create(&ct[i], NULL, mpmc_consumer, (void*)i);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        pthread_create(&pt[i], NULL, mpmc_producer, (void*)i);
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        pthread_join(pt[i], NULL);
+    }
+    for (i = 0; i < CONSUMERS; i++) {
+        solMpmcQueue_enqueue_wait(mq, NULL);
+    }
+    size_t sum = 0, count = 0;
+    for (i = 0; i < CONSUMERS; i++) {
+        pthread_join(ct[i], NULL);
+        sum += sums[i];
+        count += counts[i];
+    }
+    n = (size_t)PRODUCERS * ITEMS;
+    printf("mpmc threads: count %zu, sum ok %d\n", count, sum == n * (n + 1) / 2);
+    solMpmcQueue_free(mq);
+
+    sq = solSpscQueue_new(3);
+    printf("spsc capacity: %zu\n", solSpscQueue_capacity(sq));
+    for (i = 1; i <= 5; i++) {
+        if (solSpscQueue_enqueue(sq, (void*)i)) {
+            printf("full at %zu, count: %zu\n", i, solSpscQueue_count(sq));
+            break;
+        }
+    }
+    n = solSpscQueue_dequeue_batch(sq, b, 3);
+    printf("batch dequeued: %zu\n", n);
+    while (solSpscQueue_dequeue(sq, &v) == 0) {
+        printf("dequeue: %zu\n", (size_t)v);
+    }
+    solSpscQueue_free(sq);
+
+    pthread_t spt;
+    sq = solSpscQueue_new(128);
+    pthread_create(&spt, NULL, spsc_producer, NULL);
+    size_t last = 0, ordered = 1;
+    count = 0;
+    for (;;) {
+        n = solSpscQueue_dequeue_batch(sq, b, 8);
+        if (n == 0) {
+            b[0] = solSpscQueue_dequeue_wait(sq);
+            n = 1;
+        }
+        for (i = 0; i < n && b[i]; i++) {
+            if ((size_t)b[i] != last + 1) {
+                ordered = 0;
+            }
+            last = (size_t)b[i];
+            count++;
+        }
+        if (i < n) {
+            break;
+        }
+    }
+    pthread_join(spt, NULL);
+    printf("spsc threads: count %zu, in order %zu\n", count, ordered);
+    solSpscQueue_free(sq);
+    return 0;
+}
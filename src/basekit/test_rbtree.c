@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 #include "sol_rbtree.h"
 #include "sol_rbtree_iter.h"
 
@@ -56,11 +57,93 @@ int cmp(void *v1, void *v2)
     return 1;
 }
 
+// [lo, hi) spans, ordered by start then end
+typedef struct _Span {
+    int lo;
+    int hi;
+} Span;
+
+void* span_lo(void *v)
+{
+    return &((Span*)v)->lo;
+}
+
+void* span_hi(void *v)
+{
+    return &((Span*)v)->hi;
+}
+
+int span_cmp(void *v1, void *v2)
+{
+    Span *a = v1, *b = v2;
+    if (a->lo != b->lo) return a->lo < b->lo ? -1 : 1;
+    return (a->hi > b->hi) - (a->hi < b->hi);
+}
+
+int print_span(SolRBTree *tree, SolRBTreeNode *node, void *d)
+{
+    Span *s = solRBTreeNode_val(node);
+    printf(" [%d, %d)", s->lo, s->hi);
+    return 0;
+}
+
+// overlap queries against a scan of every span, over inserts, deletes and a split
+int check_spans(SolRBTree *tree, Span *spans, int n)
+{
+    SolRBTreeOverlap o;
+    Span *v;
+    int i, lo, hi, c, bad = 0;
+    for (lo = 0; lo < 64; lo += 3) {
+        for (hi = lo; hi < lo + 20; hi += 4) {
+            c = 0;
+            solRBTreeOverlap_init(&o, tree, &lo, &hi);
+            while ((v = solRBTreeOverlap_next_val(&o))) {
+                bad += lo == hi ? !(v->lo <= lo && lo < v->hi) : !(v->lo < hi && v->hi > lo);
+                c++;
+            }
+            for (i = 0; i < n; i++) {
+                if (solRBTree_node_is_NOT_nil(tree, solRBTree_search_node(tree, &spans[i]))) {
+                    c -= lo == hi ? spans[i].lo <= lo && lo < spans[i].hi : spans[i].lo < hi && spans[i].hi > lo;
+                }
+            }
+            bad += c != 0;
+        }
+    }
+    return bad;
+}
+
+// typed descent, the compare is inlined
+#define int_cmp(a, b) ((*(a) > *(b)) - (*(a) < *(b)))
+SOL_RBTREE_DEFINE(intTree, int*, int_cmp)
+
+// one half of a split, filled, searched and freed on its own thread
+typedef struct _Half {
+    SolRBTree *t;
+    int *vals; // vals on this half's side of the cut
+    int n;
+    int found;
+} Half;
+
+void* work_half(void *arg)
+{
+    Half *h = arg;
+    int i;
+    for (i = 0; i < h->n; i++) {
+        solRBTree_insert(h->t, &h->vals[i]);
+    }
+    for (i = 0; i < h->n; i++) {
+        h->found += solRBTree_node_is_NOT_nil(h->t, solRBTree_search_node(h->t, &h->vals[i]));
+    }
+    solRBTree_free(h->t);
+    return NULL;
+}
+
 int main()
 {
     const int CLEN = 12;
     SolRBTree *tree = solRBTree_new();
     solRBTree_set_compare_func(tree, &cmp);
+    solRBTree_set_sized(tree);
     solRBTree_set_val_free_func(tree, &print_free_val);
     int counts[CLEN];
     int i;
@@ -77,6 +160,11 @@ int main()
     solRBTree_travelsal_backorder(tree, solRBTree_root(tree), &print_key, NULL);
     printf("MAX is %d\n", conv_val(solRBTree_max(tree)));
     printf("MIN is %d\n", conv_val(solRBTree_min(tree)));
+    int lo = 4, hi = 9;
+    printf("select 0: %d, select 5: %d, select %d: %p\n", conv_val(solRBTree_select(tree, 0)),
+           conv_val(solRBTree_select(tree, 5)), CLEN, solRBTree_select(tree, CLEN));
+    printf("rank of %d: %zu, count in [%d, %d): %zu\n", lo, solRBTree_rank(tree, &lo), lo, hi,
+           solRBTree_count_range(tree, &lo, &hi));
     SolRBTreeNode *n = solRBTree_search_node(tree, &counts[CLEN - 2]);
     i = conv_node_val(n);
     printf("delete node %d, result %d\n", i, solRBTree_delete_node(tree, n));
@@ -113,6 +201,179 @@ int main()
     }
     solRBTreeIter_free(ib);
     printf("---------End test iter backorder--------\n");
+    // stackless walks hand out the same nodes in the same order
+    SolRBTreeIterTravelsalType tts[] = {SolRBTreeIterTT_preorder, SolRBTreeIterTT_inorder, SolRBTreeIterTT_backorder};
+    SolRBTreeWalk w;
+    for (i = 0; i < 3; i++) {
+        SolRBTreeIter *it = solRBTreeIter_new(tree, solRBTree_root(tree), tts[i]);
+        solRBTreeWalk_init(&w, tree, solRBTree_root(tree), tts[i]);
+        printf("walk %d:", tts[i]);
+        while ((n = solRBTreeWalk_next(&w))) {
+            printf(" %d%s", conv_node_val(n), n == solRBTreeIter_next(it) ? "" : "(differs)");
+        }
+        printf("%s\n", solRBTreeIter_next(it) ? " (iter has more)" : "");
+        solRBTreeIter_free(it);
+    }
+    solRBTreeWalk_init(&w, tree, solRBTreeNode_left(solRBTree_root(tree)), SolRBTreeIterTT_inorder);
+    printf("walk left subtree:");
+    while ((n = solRBTreeWalk_next(&w))) {
+        printf(" %d", conv_node_val(n));
+    }
+    printf("\n");
+    // select and rank agree after the deletes above
+    size_t k;
+    for (k = 0; k < solRBTree_count(tree); k++) {
+        if (solRBTree_rank(tree, solRBTree_select(tree, k)) != k) {
+            break;
+        }
+    }
+    printf("rank of select: %zu of %zu agree\n", k, solRBTree_count(tree));
+    int b = 7, end = 100;
+    printf("lower bound %d: %d, upper bound %d: %d, predecessor of %d: %d\n",
+           b, conv_node_val(solRBTree_lower_bound(tree, &b)), b, conv_node_val(solRBTree_upper_bound(tree, &b)),
+           hi, conv_node_val(solRBTree_search_predecessor(tree, solRBTree_lower_bound(tree, &hi))));
+    SolRBTreeRange r;
+    void *v;
+    printf("range [%d, %d):", lo, hi);
+    solRBTreeRange_init(&r, tree, &lo, &hi);
+    while ((v = solRBTreeRange_next_val(&r))) {
+        printf(" %d", conv_val(v));
+    }
+    printf("\n");
+    printf("delete range [%d, %d): %zu\n", lo, hi, solRBTree_delete_range(tree, &lo, &hi));
+    printf("left:");
+    solRBTreeRange_init(&r, tree, solRBTree_min(tree), &end);
+    while ((v = solRBTreeRange_next_val(&r))) {
+        printf(" %d", conv_val(v));
+    }
+    printf(", count %zu\n", solRBTree_count(tree));
+    solRBTree_free(tree);
+    // bulk load, split off the upper half and join it back around a pivot
+    int sorted[15];
+    void *sv[15];
+    for (i = 0; i < 15; i++) {
+        sorted[i] = i * 2;
+        sv[i] = &sorted[i];
+    }
+    tree = solRBTree_new();
+    solRBTree_set_compare_func(tree, &cmp);
+    solRBTree_set_sized(tree);
+    printf("build sorted: %d, ", solRBTree_build_sorted(tree, sv, 15));
+    printf("root %d, count %zu\n", conv_node_val(solRBTree_root(tree)), solRBTree_count(tree));
+    int pivot = 15;
+    SolRBTree *upper = solRBTree_split(tree, &pivot);
+    printf("split at %d: %zu below, %zu from min %d\n", pivot, solRBTree_count(tree), solRBTree_count(upper),
+           conv_val(solRBTree_min(upper)));
+    printf("join out of order: %d, ", solRBTree_join(upper, &pivot, tree));
+    printf("join: %d, ", solRBTree_join(tree, &pivot, upper));
+    printf("count %zu, rank of %d: %zu\n", solRBTree_count(tree), pivot, solRBTree_rank(tree, &pivot));
+    int again = 20, fresh = 21, is_new;
+    n = solRBTree_insert_or_get(tree, &again, &is_new);
+    printf("insert or get %d: new %d, kept own val %s, ", again, is_new, solRBTreeNode_val(n) == &again ? "no" : "yes");
+    n = intTree_insert_or_get(tree, &fresh, &is_new);
+    printf("typed insert %d: new %d, ", fresh, is_new);
+    printf("typed search %d: %d, count %zu\n", fresh, conv_node_val(intTree_search_node(tree, &fresh)),
+           solRBTree_count(tree));
+    solRBTree_wipe(tree);
+    printf("wipe: count %zu, min %p, ", solRBTree_count(tree), solRBTree_min(tree));
+    printf("insert after wipe: %d\n", conv_node_val(solRBTree_insert(tree, &fresh)));
+    solRBTree_free(upper);
     solRBTree_free(tree);
+    // interval tree
+    Span spans[200];
+    tree = solRBTree_new();
+    solRBTree_set_compare_func(tree, &span_cmp);
+    solRBTree_set_interval_funcs(tree, &span_lo, &span_hi, &cmp);
+    solRBTree_set_sized(tree);
+    for (i = 0; i < 200; i++) {
+        spans[i].lo = (i * 37) % 64;
+        spans[i].hi = spans[i].lo + 1 + (i * 11) % 9;
+    }
+    for (i = 0; i < 8; i++) {
+        solRBTree_insert(tree, &spans[i]);
+    }
+    int qlo = 10, qhi = 30, pt = 37;
+    printf("spans overlapping [%d, %d):", qlo, qhi);
+    solRBTree_overlap_iter(tree, &qlo, &qhi, &print_span, NULL);
+    printf("\nspans holding %d:", pt);
+    solRBTree_overlap_iter(tree, &pt, &pt, &print_span, NULL);
+    printf("\n");
+    for (; i < 200; i++) {
+        solRBTree_insert(tree, &spans[i]);
+    }
+    printf("%zu spans, check %d", solRBTree_count(tree), check_spans(tree, spans, 200));
+    for (i = 0; i < 200; i += 3) {
+        solRBTree_del(tree, &spans[i]);
+    }
+    printf(", after deletes %zu, check %d", solRBTree_count(tree), check_spans(tree, spans, 200));
+    Span cut = {32, 0};
+    upper = solRBTree_split(tree, &cut);
+    printf(", split %zu + %zu, check %d %d\n", solRBTree_count(tree), solRBTree_count(upper),
+           check_spans(tree, spans, 200), check_spans(upper, spans, 200));
+    solRBTree_free(upper);
+    solRBTree_free(tree);
+    // sorted runs through the finger
+    int run[100], miss = 61;
+    tree = solRBTree_new();
+    solRBTree_set_compare_func(tree, &cmp);
+    for (i = 0; i < 100; i++) {
+        run[i] = i * 2;
+        solRBTree_insert_hint(tree, NULL, &run[i]);
+    }
+    printf("hinted sorted run: count %zu, finger %d, ", solRBTree_count(tree), conv_node_val(solRBTree_finger(tree)));
+    n = solRBTree_search_hint(tree, NULL, &run[30]);
+    printf("search %d: %d, ", run[30], conv_node_val(n));
+    printf("search %d from %d: %s, ", miss, run[30],
+           solRBTree_node_is_nil(tree, solRBTree_search_hint(tree, n, &miss)) ? "nil" : "found");
+    solRBTree_del(tree, &run[30]);
+    printf("finger after its delete: %p\n", (void*)solRBTree_finger(tree));
+    // no sizes kept, select, rank and split walk the vals instead
+    printf("unsized: select 30: %d, ", conv_val(solRBTree_select(tree, 30)));
+    printf("rank of %d: %zu, ", run[40], solRBTree_rank(tree, &run[40]));
+    printf("count in [%d, %d): %zu, ", run[10], run[20], solRBTree_count_range(tree, &run[10], &run[20]));
+    printf("sized after inserts: %d, ", solRBTree_set_sized(tree));
+    upper = solRBTree_split(tree, &run[50]);
+    printf("split at %d: %zu + %zu\n", run[50], solRBTree_count(tree), solRBTree_count(upper));
+    solRBTree_free(upper);
+    solRBTree_free(tree);
+    tree = solRBTree_new();
+    solRBTree_set_compare_func(tree, &span_cmp);
+    solRBTree_set_interval_funcs(tree, &span_lo, &span_hi, &cmp);
+    for (i = 0; i < 200; i++) {
+        solRBTree_insert_hint(tree, NULL, &spans[i]);
+    }
+    printf("hinted spans %zu, check %d\n", solRBTree_count(tree), check_spans(tree, spans, 200));
+    solRBTree_free(tree);
+    // the halves of a split share a nil, work on them and free them from two threads
+    int lo_vals[500], hi_vals[500], round, found = 0;
+    pthread_t th[2];
+    Half hs[2];
+    for (i = 0; i < 500; i++) {
+        lo_vals[i] = 1000 - i * 2;
+        hi_vals[i] = 1001 + i * 2;
+    }
+    for (round = 0; round < 100; round++) {
+        tree = solRBTree_new();
+        solRBTree_set_compare_func(tree, &cmp);
+        for (i = 0; i < 15; i++) {
+            solRBTree_insert(tree, &sorted[i]);
+            solRBTree_insert(tree, &hi_vals[499 - i]);
+        }
+        pivot = 1000;
+        hs[1].t = solRBTree_split(tree, &pivot);
+        hs[0].t = tree;
+        hs[0].vals = lo_vals;
+        hs[1].vals = hi_vals;
+        for (i = 0; i < 2; i++) {
+            hs[i].n = 500 - 15;
+            hs[i].found = 0;
+            pthread_create(&th[i], NULL, work_half, &hs[i]);
+        }
+        for (i = 0; i < 2; i++) {
+            pthread_join(th[i], NULL);
+            found += hs[i].found;
+        }
+    }
+    printf("split halves on two threads: found %d of %d\n", found, 100 * 2 * (500 - 15));
     return 0;
 }
@@ -59,6 +59,27 @@ int main()
         printf("Got:\t%s\n", (char *)c);
         // printf("Set size: %d\t, iter num: %d\n", (int)solSet_size(s), (int)s->iter->num);
     }
+    SolSetIter i, j;
+    void *c1;
+    solSetIter_init(&i, s);
+    while ((c = solSetIter_get(&i))) {
+        solSetIter_init(&j, s);
+        while ((c1 = solSetIter_get(&j))) {
+            printf("Pair:\t%s %s\n", (char *)c, (char *)c1);
+        }
+    }
+    SolSet *s1 = solSet_new();
+    solSet_set_hash_func1(s1, f1);
+    solSet_set_hash_func2(s1, f2);
+    solSet_set_equal_func(s1, &equals);
+    solSet_add(s1, "value2");
+    solSet_add(s1, "value4");
+    printf("s1 is subset of s?\t%d\n", solSet_is_subset(s, s1));
+    printf("s is subset of s1?\t%d\n", solSet_is_subset(s1, s));
+    SolSet *s2 = solSet_get_intersection(s, s1);
+    printf("intersection length: %d\n", (int)solSet_count(s2));
+    solSet_free(s2);
+    solSet_free(s1);
     solSet_free(s);
     return 0;
 }
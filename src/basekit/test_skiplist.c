@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "sol_skiplist.h"
+#include "sol_rbtree.h"
+
+#define THREADS 4
+#define N 50000
+#define BENCH_N 1000000
+
+SolSkipList *l;
+SolRBTree *rt;
+pthread_mutex_t rt_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// vals are the integers themselves
+int cmp_int(void *v1, void *v2)
+{
+    intptr_t a = (intptr_t)v1, b = (intptr_t)v2;
+    return (a > b) - (a < b);
+}
+
+int print_val(SolSkipList *l, void *v, void *d)
+{
+    printf(" %ld", (long)(intptr_t)v);
+    return 0;
+}
+
+// thread p inserts its own vals, then deletes the odd ones while others search
+void* worker(void *arg)
+{
+    intptr_t p = (intptr_t)arg;
+    intptr_t i;
+    for (i = 1; i <= N; i++) {
+        solSkipList_insert(l, (void*)(i * THREADS + p));
+    }
+    for (i = 1; i <= N; i += 2) {
+        solSkipList_del(l, (void*)(i * THREADS + p));
+        solSkipList_search(l, (void*)((i + 1) * THREADS + (p + 1) % THREADS));
+    }
+    return NULL;
+}
+
+// vals that should be left, in order and each once
+int check()
+{
+    SolSkipListIter i;
+    intptr_t v, pv = 0;
+    size_t c = 0;
+    solSkipListIter_init(&i, l);
+    while ((v = (intptr_t)solSkipListIter_next(&i))) {
+        if (v <= pv || (v / THREADS) % 2) {
+            break;
+        }
+        pv = v;
+        c++;
+    }
+    solSkipListIter_end(&i);
+    return c != (size_t)THREADS * N / 2 || c != solSkipList_count(l);
+}
+
+void* bench_skiplist(void *arg)
+{
+    size_t p = (size_t)arg, i;
+    for (i = p; i < BENCH_N; i += THREADS) {
+        solSkipList_insert(l, (void*)(intptr_t)((i * 2654435761u) % BENCH_N + 1));
+    }
+    for (i = p; i < BENCH_N; i += THREADS) {
+        solSkipList_search(l, (void*)(intptr_t)((i * 7919) % BENCH_N + 1));
+    }
+    return NULL;
+}
+
+void* bench_rbtree(void *arg)
+{
+    size_t p = (size_t)arg, i;
+    for (i = p; i < BENCH_N; i += THREADS) {
+        pthread_mutex_lock(&rt_lock);
+        solRBTree_insert(rt, (void*)(intptr_t)((i * 2654435761u) % BENCH_N + 1));
+        pthread_mutex_unlock(&rt_lock);
+    }
+    for (i = p; i < BENCH_N; i += THREADS) {
+        pthread_mutex_lock(&rt_lock);
+        solRBTree_search_node(rt, (void*)(intptr_t)((i * 7919) % BENCH_N + 1));
+        pthread_mutex_unlock(&rt_lock);
+    }
+    return NULL;
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void bench()
+{
+    pthread_t t[THREADS];
+    size_t i;
+    double tm;
+    l = solSkipList_new();
+    solSkipList_set_compare_func(l, &cmp_int);
+    rt = solRBTree_new();
+    solRBTree_set_compare_func(rt, &cmp_int);
+    tm = now();
+    for (i = 0; i < THREADS; i++) {
+        pthread_create(&t[i], NULL, bench_skiplist, (void*)i);
+    }
+    for (i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+    printf("skiplist          %.3f s\n", now() - tm);
+    tm = now();
+    for (i = 0; i < THREADS; i++) {
+        pthread_create(&t[i], NULL, bench_rbtree, (void*)i);
+    }
+    for (i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+    printf("rbtree with lock  %.3f s\n", now() - tm);
+    solSkipList_free(l);
+    solRBTree_free(rt);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+    l = solSkipList_new();
+    solSkipList_set_compare_func(l, &cmp_int);
+    intptr_t i;
+    for (i = 1; i <= 20; i++) {
+        solSkipList_insert(l, (void*)((i * 8) % 21));
+    }
+    printf("insert 5 again: %d", solSkipList_insert(l, (void*)5));
+    printf(", del 4: %d", solSkipList_del(l, (void*)4));
+    printf(", del 4 again: %d\n", solSkipList_del(l, (void*)4));
+    printf("count %zu, min %ld, search 6: %ld, search 4: %p\n", solSkipList_count(l),
+           (long)(intptr_t)solSkipList_min(l), (long)(intptr_t)solSkipList_search(l, (void*)6),
+           solSkipList_search(l, (void*)4));
+    printf("lower bound 4: %ld, upper bound 5: %ld, upper bound 20: %p\n",
+           (long)(intptr_t)solSkipList_lower_bound(l, (void*)4), (long)(intptr_t)solSkipList_upper_bound(l, (void*)5),
+           solSkipList_upper_bound(l, (void*)20));
+    printf("vals:");
+    solSkipList_travelsal_inorder(l, &print_val, NULL);
+    printf("\n");
+    SolSkipListIter it;
+    printf("from 15:");
+    solSkipListIter_seek(&it, l, (void*)15);
+    while ((i = (intptr_t)solSkipListIter_next(&it))) {
+        printf(" %ld", (long)i);
+    }
+    solSkipListIter_end(&it);
+    printf("\n");
+    solSkipList_free(l);
+
+    pthread_t t[THREADS];
+    l = solSkipList_new();
+    solSkipList_set_compare_func(l, &cmp_int);
+    for (i = 0; i < THREADS; i++) {
+        pthread_create(&t[i], NULL, worker, (void*)i);
+    }
+    for (i = 0; i < THREADS; i++) {
+        pthread_join(t[i], NULL);
+    }
+    printf("%d threads: count %zu, check %d\n", THREADS, solSkipList_count(l), check());
+    solSkipList_free(l);
+    return 0;
+}
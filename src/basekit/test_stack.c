@@ -32,5 +32,22 @@ int main()
     printf("pop value: %s\n", (char*)solStack_pop(s));
     printf("pop value: %s\n", (char*)solStack_pop(s));
     solStack_free(s);
+    SolStack ss;
+    solStack_init(&ss);
+    int i;
+    int d1[100];
+    for (i = 0; i < 100; i++) {
+        d1[i] = i;
+        solStack_push(&ss, &d1[i]);
+    }
+    printf("stack size: %zu, capacity: %zu\n", solStack_size(&ss), solStack_capacity(&ss));
+    printf("top value: %d\n", *(int*)solStack_top(&ss));
+    while ((d = solStack_pop(&ss))) {
+        if (*(int*)d % 25 == 0) {
+            printf("pop value: %d\n", *(int*)d);
+        }
+    }
+    printf("stack empty? %d\n", solStack_empty(&ss));
+    solStack_deinit(&ss);
     return 0;
 }
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sol_thread_pool.h"
+#include "sol_ws_deque.h"
+
+#define N 1000000
+
+unsigned char marks[N];
+
+void mark(size_t b, size_t e, void *ctx)
+{
+    size_t i;
+    for (i = b; i < e; i++) {
+        marks[i]++;
+    }
+}
+
+void sum(size_t b, size_t e, void *ctx, void *acc)
+{
+    size_t i;
+    for (i = b; i < e; i++) {
+        *(size_t*)acc += i;
+    }
+}
+
+void sum_join(void *acc, void *acc2, void *ctx)
+{
+    *(size_t*)acc += *(size_t*)acc2;
+}
+
+void spin(size_t b, size_t e, void *ctx, void *acc)
+{
+    size_t i, j;
+    double x;
+    for (i = b; i < e; i++) {
+        x = (double)i;
+        for (j = 0; j < 200; j++) {
+            x = x * 0.999999 + 1.0;
+        }
+        *(double*)acc += x;
+    }
+}
+
+void spin_join(void *acc, void *acc2, void *ctx)
+{
+    *(double*)acc += *(double*)acc2;
+}
+
+_Atomic size_t hits;
+
+void hit(void *a)
+{
+    atomic_fetch_add(&hits, (size_t)a);
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void bench()
+{
+    SolThreadPool *p = solThreadPool_new(0);
+    size_t n, max = solThreadPool_workers(p);
+    solThreadPool_free(p);
+    double t, base = 0, r;
+    printf("workers  seconds  speedup\n");
+    for (n = 1; n <= max; n *= 2) {
+        p = solThreadPool_new(n);
+        r = 0;
+        t = now();
+        sol_parallel_reduce(p, 0, N * 2, 0, &r, sizeof(double), spin, spin_join, NULL);
+        t = now() - t;
+        if (n == 1) {
+            base = t;
+        }
+        printf("%7zu  %7.3f  %7.2f\n", n, t, base / t);
+        solThreadPool_free(p);
+        if (n < max && n * 2 > max) {
+            n = max / 2;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        bench();
+        return 0;
+    }
+    SolWsDeque *d = solWsDeque_new();
+    size_t i;
+    void *v;
+    for (i = 1; i <= 100; i++) {
+        solWsDeque_push(d, (void*)i);
+    }
+    printf("deque count: %zu\n", (size_t)solWsDeque_count(d));
+    solWsDeque_take(d, &v);
+    printf("take: %zu\n", (size_t)v);
+    solWsDeque_steal(d, &v);
+    printf("steal: %zu\n", (size_t)v);
+    while (solWsDeque_take(d, &v) == 0);
+    printf("deque empty take: %d, steal: %d\n", solWsDeque_take(d, &v), solWsDeque_steal(d, &v));
+    solWsDeque_free(d);
+
+    SolThreadPool *p = solThreadPool_new(4);
+    printf("workers: %zu\n", solThreadPool_workers(p));
+    SolTaskGroup g;
+    solTaskGroup_init(&g);
+    for (i = 1; i <= 1000; i++) {
+        solThreadPool_spawn(p, &g, hit, (void*)i);
+    }
+    solThreadPool_wait(p, &g);
+    printf("spawned tasks sum: %zu\n", (size_t)hits);
+
+    sol_parallel_for(p, 0, N, 0, mark, NULL);
+    sol_parallel_for(p, 0, N / 2, 100, mark, NULL);
+    size_t bad = 0;
+    for (i = 0; i < N; i++) {
+        if (marks[i] != (i < N / 2 ? 2 : 1)) {
+            bad++;
+        }
+    }
+    printf("parallel for wrong marks: %zu\n", bad);
+
+    size_t s = 0;
+    sol_parallel_reduce(p, 0, N, 0, &s, sizeof(size_t), sum, sum_join, NULL);
+    printf("parallel reduce sum ok: %d\n", s == (size_t)N * (N - 1) / 2);
+    s = 7;
+    sol_parallel_reduce(p, 5, 6, 1, &s, sizeof(size_t), sum, sum_join, NULL);
+    printf("parallel reduce one: %zu\n", s);
+    solThreadPool_free(p);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include "sol_ulist.h"
+
+int main()
+{
+    int d[40];
+    int i;
+    SolUList *l = solUList_new();
+    for (i = 0; i < 40; i++) {
+        d[i] = i;
+        solUList_add(l, &d[i]);
+    }
+    printf("len is %lu\n", solUList_len(l));
+    printf("has 17? %d\n", solUList_has(l, &d[17]));
+    for (i = 0; i < 40; i += 3) {
+        solUList_remove(l, &d[i]);
+    }
+    for (i = 14; i < 28; i++) {
+        solUList_remove(l, &d[i]);
+    }
+    printf("has 15? %d\n", solUList_has(l, &d[15]));
+    printf("len after remove is %lu\n", solUList_len(l));
+    SolUList *l1 = solUList_new();
+    solUList_add(l1, &d[0]);
+    solUList_add(l1, &d[3]);
+    solUList_attach(l, l1);
+    SolUListIter it;
+    solUListIter_init(&it, l);
+    void *v = solUListIter_current_val(&it);
+    while (v) {
+        printf("val is [%d]\n", *(int*)v);
+        v = solUListIter_next_val(&it);
+    }
+    SolUList *l2 = solUList_dup(l);
+    printf("dup len is %lu\n", solUList_len(l2));
+    solUList_free(l2);
+    solUList_free(l);
+    return 0;
+}
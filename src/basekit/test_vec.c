@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include "sol_vec.h"
+
+struct Span {
+    int s;
+    int e;
+};
+
+int cmp_span(void *v1, void *v2)
+{
+    return ((struct Span*)v1)->s - ((struct Span*)v2)->s;
+}
+
+void print_spans(char *t, SolVec *v)
+{
+    size_t i;
+    struct Span *x;
+    printf("%s (count %zu):", t, solVec_count(v));
+    for (i = 0; i < solVec_count(v); i++) {
+        x = solVec_get(v, i);
+        printf(" [%d,%d)", x->s, x->e);
+    }
+    printf("\n");
+}
+
+int main()
+{
+    SolVec *v = solVec_new(sizeof(struct Span));
+    struct Span x;
+    int i;
+    for (i = 0; i < 20; i++) {
+        x.s = (i * 7) % 20;
+        x.e = x.s + 3;
+        solVec_push(v, &x);
+    }
+    print_spans("PUSHED", v);
+    solVec_sort(v, &cmp_span);
+    print_spans("SORTED", v);
+    x.s = 13;
+    struct Span *f = solVec_search(v, &x, &cmp_span);
+    printf("search 13: [%d,%d)\n", f->s, f->e);
+    x.s = 30;
+    printf("search 30: %p\n", solVec_search(v, &x, &cmp_span));
+    solVec_remove(v, 0);
+    solVec_swap_remove(v, 0);
+    x.s = -1;
+    x.e = 0;
+    solVec_insert(v, 0, &x);
+    print_spans("EDITED", v);
+    solVec_pop(v, &x);
+    printf("pop: [%d,%d), capacity %zu\n", x.s, x.e, solVec_capacity(v));
+    solVec_free(v);
+    SolVec *pv = solVec_new(0);
+    SolVec *pv2 = solVec_new(0);
+    solVec_push_ptr(pv, "a");
+    solVec_push_ptr(pv, "b");
+    solVec_push_ptr(pv2, "c");
+    solVec_attach(pv, pv2);
+    for (i = 0; i < solVec_count(pv); i++) {
+        printf("ptr val is [%s]\n", (char*)solVec_ptr(pv, i));
+    }
+    solVec_free(pv);
+    return 0;
+}
@@ -2,7 +2,12 @@
 
 SolDfaStateMark* solDfaStateMark_new()
 {
-    SolDfaStateMark *m = sol_calloc(1, sizeof(SolDfaStateMark));
+    return solDfaStateMark_new_with_allocator(NULL);
+}
+
+SolDfaStateMark* solDfaStateMark_new_with_allocator(SolAllocator *a)
+{
+    SolDfaStateMark *m = solAllocator_calloc(a, 1, sizeof(SolDfaStateMark));
     if (m) {
         return m;
     }
@@ -10,6 +15,11 @@ SolDfaStateMark* solDfaStateMark_new()
 }
 
 void solDfaStateMark_free(SolDfaStateMark *m)
+{
+    solDfaStateMark_free_with_allocator(m, NULL);
+}
+
+void solDfaStateMark_free_with_allocator(SolDfaStateMark *m, SolAllocator *a)
 {
     if (m == NULL) {
         return;
@@ -17,18 +27,24 @@ void solDfaStateMark_free(SolDfaStateMark *m)
     SolDfaStateMark *n;
     do {
         n = solDfaStateMark_next(m);
-        sol_free(m);
+        solAllocator_free(a, m);
         m = n;
     } while (m);
 }
 
 SolDfaState* solDfaState_new(void *s)
 {
-    SolDfaState *ds = sol_calloc(1, sizeof(SolDfaState));
+    return solDfaState_new_with_allocator(s, NULL);
+}
+
+SolDfaState* solDfaState_new_with_allocator(void *s, SolAllocator *a)
+{
+    SolDfaState *ds = solAllocator_calloc(a, 1, sizeof(SolDfaState));
     if (ds == NULL) {
         return NULL;
     }
     solDfaState_set_state(ds, s);
+    ds->a = a;
     return ds;
 }
 
@@ -37,8 +53,8 @@ void solDfaState_free(SolDfaState *ds)
     if (solDfaState_rules(ds)) {
         solHash_free(solDfaState_rules(ds));
     }
-    solDfaStateMark_free(solDfaState_mark(ds));
-    sol_free(ds);
+    solDfaStateMark_free_with_allocator(solDfaState_mark(ds), ds->a);
+    solAllocator_free(ds->a, ds);
 }
 
 void _solDfaState_free(void *ds)
@@ -62,7 +78,7 @@ int solDfaState_add_mark(SolDfaState *ds, void *m, int f)
 {
     SolDfaStateMark *mark;
     if (solDfaState_mark(ds) == NULL) {
-        solDfaState_set_mark(ds, solDfaStateMark_new());
+        solDfaState_set_mark(ds, solDfaStateMark_new_with_allocator(ds->a));
         if (solDfaState_mark(ds) == NULL) {
             return -1;
         }
@@ -72,7 +88,7 @@ int solDfaState_add_mark(SolDfaState *ds, void *m, int f)
         while (solDfaStateMark_next(mark))  {
             mark = solDfaStateMark_next(mark);
         }
-        solDfaStateMark_set_next_mark(mark, solDfaStateMark_new());
+        solDfaStateMark_set_next_mark(mark, solDfaStateMark_new_with_allocator(ds->a));
         mark = solDfaStateMark_next(mark);
     }
     solDfaStateMark_set_mark(mark, m);
@@ -107,12 +123,24 @@ SolDfaState* solDfaState_next(SolDfaState *ds, void *c)
 SolDfa* solDfa_new(sol_f_hash_ptr fsh1, sol_f_hash_ptr fsh2, sol_f_cmp_ptr fsm,
                    sol_f_hash_ptr fch1, sol_f_hash_ptr fch2, sol_f_cmp_ptr fcm)
 {
-    SolDfa *d = sol_calloc(1, sizeof(SolDfa));
+    return solDfa_new_with_allocator(fsh1, fsh2, fsm, fch1, fch2, fcm, NULL);
+}
+
+/**
+ * dfa whose states, marks and rules come from allocator a
+ * dfas merged together must share the allocator
+ */
+SolDfa* solDfa_new_with_allocator(sol_f_hash_ptr fsh1, sol_f_hash_ptr fsh2, sol_f_cmp_ptr fsm,
+                                  sol_f_hash_ptr fch1, sol_f_hash_ptr fch2, sol_f_cmp_ptr fcm,
+                                  SolAllocator *a)
+{
+    SolDfa *d = solAllocator_calloc(a, 1, sizeof(SolDfa));
     if (d == NULL) {
         return NULL;
     }
-    solDfa_set_all_states(d, solHash_new());
-    solDfa_set_accepting_states(d, solSet_new());
+    d->a = a;
+    solDfa_set_all_states(d, solHash_new_with_allocator(a));
+    solDfa_set_accepting_states(d, solSet_new_with_allocator(a));
     if (solDfa_all_states(d) == NULL || solDfa_accepting_states(d) == NULL) {
         solDfa_free(d);
         return NULL;
@@ -143,14 +171,59 @@ void solDfa_free(SolDfa *d)
     if (solDfa_accepting_states(d)) {
         solSet_free(solDfa_accepting_states(d));
     }
-    sol_free(d);
+    solAllocator_free(solDfa_allocator(d), d);
+}
+
+/**
+ * bytes held by the dfa, states and characters themselves are not counted
+ * records of the state and accepting hashes go to rb,
+ * the per state rule hashes to ub and the marks to mb
+ */
+void solDfa_memory_usage(SolDfa *d, SolMemoryUsage *u)
+{
+    solMemoryUsage_init(u);
+    _solDfa_memory_usage(d, u);
+    solMemoryUsage_sum(u);
+}
+
+void _solDfa_memory_usage(SolDfa *d, SolMemoryUsage *u)
+{
+    SolHashIter i;
+    SolHashRecord *r;
+    solMemoryUsage_add(u, sb, sizeof(SolDfa));
+    if (solDfa_accepting_states(d)) {
+        _solSet_memory_usage(solDfa_accepting_states(d), u);
+    }
+    if (solDfa_all_states(d) == NULL) {
+        return;
+    }
+    _solHash_memory_usage(solDfa_all_states(d), u);
+    solHashIter_init(&i, solDfa_all_states(d));
+    while ((r = solHashIter_get(&i))) {
+        _solDfaState_memory_usage(r->v, u);
+    }
+}
+
+void _solDfaState_memory_usage(SolDfaState *ds, SolMemoryUsage *u)
+{
+    SolMemoryUsage t;
+    SolDfaStateMark *m;
+    solMemoryUsage_add(u, sb, sizeof(SolDfaState));
+    if (solDfaState_rules(ds)) {
+        solMemoryUsage_init(&t);
+        _solHash_memory_usage(solDfaState_rules(ds), &t);
+        solMemoryUsage_add_as(u, &t, ub);
+    }
+    for (m = solDfaState_mark(ds); m; m = solDfaStateMark_next(m)) {
+        solMemoryUsage_add(u, mb, sizeof(SolDfaStateMark));
+    }
 }
 
 int solDfa_set_starting_state(SolDfa *d, void *s)
 {
     SolDfaState *ds = solHash_get(solDfa_all_states(d), s);
     if (ds == NULL) {
-        ds = solDfaState_new(s);
+        ds = solDfaState_new_with_allocator(s, solDfa_allocator(d));
         if (ds == NULL) {
             return 1;
         }
@@ -165,7 +238,7 @@ int solDfa_add_accepting_state(SolDfa *d, void *s)
 {
     SolDfaState *ds = solHash_get(solDfa_all_states(d), s);
     if (ds == NULL) {
-        ds = solDfaState_new(s);
+        ds = solDfaState_new_with_allocator(s, solDfa_allocator(d));
         if (ds == NULL) {
             return 1;
         }
@@ -177,7 +250,7 @@ int solDfa_add_accepting_state(SolDfa *d, void *s)
 
 int solDfa_init_dfa_state_rule(SolDfa *d, SolDfaState *ds)
 {
-    solDfaState_set_rules(ds, solHash_new());
+    solDfaState_set_rules(ds, solHash_new_with_allocator(solDfa_allocator(d)));
     if (solDfaState_rules(ds) == NULL) {
         return -1;
     }
@@ -191,7 +264,7 @@ int solDfa_add_rule(SolDfa *d, void *s1, void *s2, void *c)
 {
     SolDfaState *ds1 = solHash_get(solDfa_all_states(d), s1);
     if (ds1 == NULL) {
-        ds1 = solDfaState_new(s1);
+        ds1 = solDfaState_new_with_allocator(s1, solDfa_allocator(d));
         if (ds1 == NULL) {
             return -1;
         }
@@ -204,7 +277,7 @@ int solDfa_add_rule(SolDfa *d, void *s1, void *s2, void *c)
     }
     SolDfaState *ds2 = solHash_get(solDfa_all_states(d), s2);
     if (ds2 == NULL) {
-        ds2 = solDfaState_new(s2);
+        ds2 = solDfaState_new_with_allocator(s2, solDfa_allocator(d));
         if (ds2 == NULL) {
             return -1;
         }
@@ -250,7 +323,8 @@ int solDfa_state_merge(SolDfa *d1, SolDfa *d2, void *s1, void *s2)
     if (ds1 == NULL || ds2 == NULL) {
         return -2;
     }
-    SolHashIter *i;
+    SolHashIter i;
+    SolHashIter in;
     SolDfaState *dsn;
     SolDfaState *ds2n;
     SolHashRecord *r = NULL;
@@ -262,9 +336,8 @@ int solDfa_state_merge(SolDfa *d1, SolDfa *d2, void *s1, void *s2)
             && solDfa_init_dfa_state_rule(d1, ds1) != 0) {
             return -3;
         }
-        i = solHashIter_new(solDfaState_rules(ds2));
-        solHashIter_rewind(i);
-        while ((r2 = solHashIter_get(i))) {
+        solHashIter_init(&i, solDfaState_rules(ds2));
+        while ((r2 = solHashIter_get(&i))) {
             c = r2->k;
             ds2n = (SolDfaState*)(r2->v);
             dsn = solDfaState_next(ds1, c);
@@ -278,18 +351,14 @@ int solDfa_state_merge(SolDfa *d1, SolDfa *d2, void *s1, void *s2)
                 solDfaState_add_rule(ds1, ds2n, c);
             }
         }
-        solHashIter_free(i);
     }
     // upstream
-    i = solHashIter_new(solDfa_all_states(d2));
-    solHashIter_rewind(i);
-    SolHashIter *in;
-    while ((r2 = solHashIter_get(i))) {
+    solHashIter_init(&i, solDfa_all_states(d2));
+    while ((r2 = solHashIter_get(&i))) {
         ds2n = (SolDfaState*)(r2->v);
         if (solDfaState_rules(ds2n)) {
-            in = solHashIter_new(solDfaState_rules(ds2n));
-            solHashIter_rewind(in);
-            while ((r = solHashIter_get(in))) {
+            solHashIter_init(&in, solDfaState_rules(ds2n));
+            while ((r = solHashIter_get(&in))) {
                 dsn = (SolDfaState*)(r->v);
                 // redirect ds2's parent relations to ds1
                 // dsn --c--> ds2
@@ -297,10 +366,8 @@ int solDfa_state_merge(SolDfa *d1, SolDfa *d2, void *s1, void *s2)
                     solDfaState_add_rule(ds2n, ds1, r->k);
                 }
             }
-            solHashIter_free(in);
         }
     }
-    solHashIter_free(i);
     if (solDfa_state_match(d1, s1, s2) != 0) {
         solDfaState_merge_mark(ds1, ds2);
         if (solDfaState_mark(ds2)) {
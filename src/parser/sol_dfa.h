@@ -15,6 +15,7 @@ typedef struct _SolDfaState {
     void *s; // state
     SolHash *r; // rules {character: dfa_state, ...}
     SolDfaStateMark *m;
+    SolAllocator *a; // allocator of the state and its marks
 } SolDfaState;
 
 typedef struct _SolDfa {
@@ -28,6 +29,7 @@ typedef struct _SolDfa {
     sol_f_hash_ptr f_c_hash2; // character hash func2
     sol_f_cmp_ptr f_sm; // func state match
     sol_f_cmp_ptr f_cm; // func character match
+    SolAllocator *a; // allocator, NULL for sol_alloc
 } SolDfa;
 
 #define solDfaState_set_state(ds, s) (ds)->s = s
@@ -56,6 +58,7 @@ typedef struct _SolDfa {
 #define solDfa_current_state(d) (d)->cs
 #define solDfa_accepting_states(d) (d)->as
 #define solDfa_all_states(d) (d)->als
+#define solDfa_allocator(d) (d)->a
 
 #define solDfa_free_all_states(d) solHash_free(solDfa_all_states(d))
 #define solDfa_wipe_all_states(d) solHash_wipe(solDfa_all_states(d))
@@ -65,6 +68,7 @@ typedef struct _SolDfa {
 #define solDfa_state_in_accepting_states(d, s) solSet_in_set(solDfa_accepting_states(d), s)
 #define solDfa_accepting_states_rewind(d) solSet_rewind(solDfa_accepting_states(d))
 #define solDfa_accepting_states_get_one(d) solSet_get(solDfa_accepting_states(d))
+#define solDfa_accepting_states_iter_init(d, i) solSetIter_init(i, solDfa_accepting_states(d))
 #define solDfa_wipe_accepting_states(d) solSet_wipe(solDfa_accepting_states(d))
 #define solDfa_merge_accepting_states(d1, d2) solSet_merge(solDfa_accepting_states(d1), \
                                                            solDfa_accepting_states(d2))
@@ -92,6 +96,7 @@ typedef struct _SolDfa {
 #define solDfa_state_is_starting_state(d, s) (solDfa_state_match(d, solDfa_starting_state(d), s) == 0)
 
 SolDfaState* solDfaState_new(void*);
+SolDfaState* solDfaState_new_with_allocator(void*, SolAllocator*);
 void solDfaState_free(SolDfaState*);
 void _solDfaState_free(void*);
 int solDfaState_add_rule(SolDfaState*, SolDfaState*, void*);
@@ -100,10 +105,14 @@ int solDfaState_add_mark(SolDfaState*, void*, int);
 void solDfaState_merge_mark(SolDfaState*, SolDfaState*);
 
 SolDfaStateMark* solDfaStateMark_new();
+SolDfaStateMark* solDfaStateMark_new_with_allocator(SolAllocator*);
 void solDfaStateMark_free(SolDfaStateMark*);
+void solDfaStateMark_free_with_allocator(SolDfaStateMark*, SolAllocator*);
 
 SolDfa* solDfa_new(sol_f_hash_ptr, sol_f_hash_ptr, sol_f_cmp_ptr,
                    sol_f_hash_ptr, sol_f_hash_ptr, sol_f_cmp_ptr);
+SolDfa* solDfa_new_with_allocator(sol_f_hash_ptr, sol_f_hash_ptr, sol_f_cmp_ptr,
+                                  sol_f_hash_ptr, sol_f_hash_ptr, sol_f_cmp_ptr, SolAllocator*);
 void solDfa_free(SolDfa*);
 int solDfa_set_starting_state(SolDfa*, void*);
 int solDfa_add_accepting_state(SolDfa*, void*);
@@ -112,6 +121,9 @@ int solDfa_add_rule(SolDfa*, void*, void*, void*);
 int solDfa_read_character(SolDfa*, void*);
 
 int solDfa_init_dfa_state_rule(SolDfa*, SolDfaState*);
+void solDfa_memory_usage(SolDfa*, SolMemoryUsage*);
+void _solDfa_memory_usage(SolDfa*, SolMemoryUsage*);
+void _solDfaState_memory_usage(SolDfaState*, SolMemoryUsage*);
 
 int solDfa_state_merge(SolDfa*, SolDfa*, void*, void*);
 
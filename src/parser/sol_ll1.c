@@ -2,22 +2,38 @@
 #include "sol_ll1.h"
 #include "sol_rbtree_iter.h"
 
+// entries order by symbol, this compare is inlined into the FIRST and FOLLOW descents
+#define _solLL1Parser_entry_cmp(e1, e2) \
+    ((solLL1ParserEntry_symbol(e1) > solLL1ParserEntry_symbol(e2)) \
+     - (solLL1ParserEntry_symbol(e1) < solLL1ParserEntry_symbol(e2)))
+SOL_RBTREE_DEFINE(_solLL1ParserEntryTree, SolLL1ParserEntry*, _solLL1Parser_entry_cmp)
+
 SolLL1Parser* solLL1Parser_new()
 {
-    SolLL1Parser *p = sol_calloc(1, sizeof(SolLL1Parser));
+    return solLL1Parser_new_with_allocator(NULL);
+}
+
+/**
+ * a holds the parser, its product list and symbol tree
+ * symbols, products and table entries stay on sol_alloc
+ */
+SolLL1Parser* solLL1Parser_new_with_allocator(SolAllocator *a)
+{
+    SolLL1Parser *p = solAllocator_calloc(a, 1, sizeof(SolLL1Parser));
     if (p == NULL) {
         return NULL;
     }
+    p->a = a;
     solLL1Parser_set_stack(p, solStack_new());
-    solLL1Parser_set_product_list(p, solList_new());
-    solLL1Parser_set_symbol_list(p, solRBTree_new());
+    solLL1Parser_set_product_list(p, solVec_new_with_allocator(0, a));
+    solLL1Parser_set_symbol_list(p, solRBTree_new_with_allocator(a));
     if (solLL1Parser_stack(p) == NULL
         || solLL1Parser_product_list(p) == NULL
         ) {
         solLL1Parser_free(p);
         return NULL;
     }
-    solList_set_val_free_func(solLL1Parser_product_list(p), &_solLL1ParserProduct_free);
+    solVec_set_val_free_func(solLL1Parser_product_list(p), &_solLL1ParserProduct_free);
     solRBTree_set_compare_func(solLL1Parser_symbol_list(p), &_solLL1Parser_symbol_compare);
     solRBTree_set_val_free_func(solLL1Parser_symbol_list(p), &_solLL1ParserSymbol_free);
     return p;
@@ -29,12 +45,12 @@ void solLL1Parser_free(SolLL1Parser *p)
         solStack_free(solLL1Parser_stack(p));
     }
     if (solLL1Parser_product_list(p)) {
-        solList_free(solLL1Parser_product_list(p));
+        solVec_free(solLL1Parser_product_list(p));
     }
     if (solLL1Parser_symbol_list(p)) {
         solRBTree_free(solLL1Parser_symbol_list(p));
     }
-    sol_free(p);
+    solAllocator_free(p->a, p);
 }
 
 int solLL1Parser_reg_product(SolLL1Parser *p, SolLL1ParserProduct *f)
@@ -45,10 +61,10 @@ int solLL1Parser_reg_product(SolLL1Parser *p, SolLL1ParserProduct *f)
         ) {
         return -1;
     }
-    if (solList_add(solLL1Parser_product_list(p), f)) {
-        return 0;
+    if (solVec_push_ptr(solLL1Parser_product_list(p), f)) {
+        return 1;
     }
-    return 1;
+    return 0;
 }
 
 int solLL1Parser_reg_symbol(SolLL1Parser *p, SolLL1ParserSymbol *s)
@@ -117,16 +133,17 @@ int solLL1Parser_symbol_compute_nullable(SolLL1Parser *p, SolLL1ParserSymbol *s)
 {
     if (p == NULL) return -1;
     if (solLL1Parser_product_list(p) == NULL) return -2;
-    if (solList_len(solLL1Parser_product_list(p)) == 0) return -3;
+    if (solVec_count(solLL1Parser_product_list(p)) == 0) return -3;
     if (solLL1ParserSymbol_is_nullable(s)) return 0;
     if (solLL1ParserSymbol_is_nullable_computed(s)) return 1;
-    SolListNode *nf = solList_head(solLL1Parser_product_list(p));
+    SolVec *fl = solLL1Parser_product_list(p);
+    size_t k;
     SolLL1ParserProductNode *ns;
     SolLL1ParserProduct *f;
     SolLL1ParserSymbol *s1;
     int status = 2;
-    do {
-        f = solListNode_val(nf);
+    for (k = 0; k < solVec_count(fl); k++) {
+        f = solVec_ptr(fl, k);
         ns = solLL1ParserProduct_left(f);
         s1 = solLL1ParserProductNode_symbol(ns);
         if (s == s1) {
@@ -148,7 +165,7 @@ int solLL1Parser_symbol_compute_nullable(SolLL1Parser *p, SolLL1ParserSymbol *s)
                 break;
             }
         }
-    } while ((nf = solListNode_next(nf)));
+    }
     solLL1ParserSymbol_set_nullable_computed(s);
     return status;
 }
@@ -157,14 +174,15 @@ int solLL1Parser_symbol_compute_first(SolLL1Parser *p, SolLL1ParserSymbol *s)
 {
     if (p == NULL) return -1;
     if (solLL1Parser_product_list(p) == NULL) return -2;
-    if (solList_len(solLL1Parser_product_list(p)) == 0) return -3;
+    if (solVec_count(solLL1Parser_product_list(p)) == 0) return -3;
     if (solLL1ParserSymbol_is_first_computed(s)) return 0;
-    SolListNode *nf = solList_head(solLL1Parser_product_list(p));
+    SolVec *fl = solLL1Parser_product_list(p);
+    size_t k;
     SolLL1ParserProductNode *ns;
     SolLL1ParserProduct *f;
     SolLL1ParserSymbol *s1;
-    do {
-        f = solListNode_val(nf);
+    for (k = 0; k < solVec_count(fl); k++) {
+        f = solVec_ptr(fl, k);
         ns = solLL1ParserProduct_left(f);
         s1 = solLL1ParserProductNode_symbol(ns);
         if (s1 != s) {
@@ -187,7 +205,7 @@ int solLL1Parser_symbol_compute_first(SolLL1Parser *p, SolLL1ParserSymbol *s)
             }
             break;
         }
-    } while ((nf = solListNode_next(nf)));
+    }
     solLL1ParserSymbol_set_first_computed(s);
     return 0;
 }
@@ -196,18 +214,19 @@ int solLL1Parser_symbol_compute_follow(SolLL1Parser *p, SolLL1ParserSymbol *s)
 {
     if (p == NULL) return -1;
     if (solLL1Parser_product_list(p) == NULL) return -2;
-    if (solList_len(solLL1Parser_product_list(p)) == 0) return -3;
+    if (solVec_count(solLL1Parser_product_list(p)) == 0) return -3;
     if (solLL1ParserSymbol_is_terminal(s)) return -4;
     if (solLL1ParserSymbol_is_follow_computed(s)) return 0;
-    SolListNode *nf = solList_head(solLL1Parser_product_list(p));
+    SolVec *fl = solLL1Parser_product_list(p);
+    size_t k;
     SolLL1ParserSymbol *s1;
     SolLL1ParserSymbol *s2;
     SolLL1ParserProduct *f;
     SolLL1ParserProductNode *ns;
     int status = 1;
-    do {
+    for (k = 0; k < solVec_count(fl); k++) {
         status = 2;
-        f = solListNode_val(nf);
+        f = solVec_ptr(fl, k);
         ns = solLL1ParserProduct_left(f);
         s1 = solLL1ParserProductNode_symbol(ns);
         while ((ns = solLL1ParserProductNode_symbol_next(ns))) {
@@ -247,7 +266,7 @@ int solLL1Parser_symbol_compute_follow(SolLL1Parser *p, SolLL1ParserSymbol *s)
                 }
             }
         }
-    } while ((nf = solListNode_next(nf)));
+    }
     solLL1ParserSymbol_set_follow_computed(s);
     return 0;
 }
@@ -259,7 +278,7 @@ int solLL1Parser_generate_table(SolLL1Parser *p)
         || solRBTree_count(solLL1Parser_symbol_list(p)) == 0
         ) return -2;
     if (solLL1Parser_product_list(p) == NULL
-        || solList_len(solLL1Parser_product_list(p)) == 0
+        || solVec_count(solLL1Parser_product_list(p)) == 0
         ) return -3;
     SolRBTree *t = solLL1Parser_symbol_list(p);
     if (solRBTree_travelsal_preorder(t, solRBTree_root(t), &_solLL1Parser_rbnode_compute_nullable, p)) {
@@ -274,6 +293,40 @@ int solLL1Parser_generate_table(SolLL1Parser *p)
     return 0;
 }
 
+/**
+ * bytes held by the parser, its products, symbols and first/follow tables
+ * table entries go to ub, symbol names are not counted
+ */
+void solLL1Parser_memory_usage(SolLL1Parser *p, SolMemoryUsage *u)
+{
+    size_t i;
+    SolLL1ParserProduct *f;
+    solMemoryUsage_init(u);
+    solMemoryUsage_add(u, sb, sizeof(SolLL1Parser));
+    if (solLL1Parser_stack(p)) {
+        solMemoryUsage_add(u, sb, sizeof(SolStack));
+        if (solLL1Parser_stack(p)->d != solLL1Parser_stack(p)->b) {
+            solMemoryUsage_add(u, nb, sizeof(void*) * solStack_capacity(solLL1Parser_stack(p)));
+        }
+    }
+    if (solLL1Parser_product_list(p)) {
+        _solVec_memory_usage(solLL1Parser_product_list(p), u);
+        for (i = 0; i < solVec_count(solLL1Parser_product_list(p)); i++) {
+            f = solVec_ptr(solLL1Parser_product_list(p), i);
+            solMemoryUsage_add(u, sb, sizeof(SolLL1ParserProduct));
+            u->nb += sizeof(SolDlListNode) * solLL1ParserProduct_len(f);
+            u->pb += sizeof(SolDlListNode) * solLL1ParserProduct_len(f);
+            u->n += solLL1ParserProduct_len(f);
+        }
+    }
+    if (solLL1Parser_symbol_list(p)) {
+        _solRBTree_memory_usage(solLL1Parser_symbol_list(p), u);
+        solRBTree_travelsal_inorder(solLL1Parser_symbol_list(p), solRBTree_root(solLL1Parser_symbol_list(p)),
+                                    &_solLL1Parser_rbnode_memory_usage, u);
+    }
+    solMemoryUsage_sum(u);
+}
+
 void _solLL1ParserProduct_free(void *f)
 {
     solLL1ParserProduct_free((SolLL1ParserProduct*)(f));
@@ -340,27 +393,22 @@ int solLL1ParserSymbol_add_first_entry(SolLL1ParserSymbol *s, SolLL1ParserEntry
     if (s == solLL1ParserEntry_symbol(e)) return -2;
     if (solLL1ParserSymbol_is_NOT_nonterminal(s)) return -3;
     if (solLL1ParserSymbol_first(s) == NULL) return -4;
-    if (solRBTree_insert(solLL1ParserSymbol_first(s), e)) {
-        return 0;
-    }
-    return 1;
+    return _solLL1ParserSymbol_insert_entry(solLL1ParserSymbol_first(s), e);
 }
 
 int solLL1ParserSymbol_dup_first(SolLL1ParserSymbol *s, SolRBTree *t, SolLL1ParserProduct *p)
 {
-    SolRBTreeIter *i = solRBTreeIter_new(t, solRBTree_root(t), SolRBTreeIterTT_preorder);
+    SolRBTreeWalk w;
     SolLL1ParserEntry *e;
-    SolRBTreeNode *n;
     SolLL1ParserSymbol *s1;
-    while ((n = solRBTreeIter_next(i))) {
-        e = solRBTreeNode_val(n);
+    solRBTreeWalk_init(&w, t, solRBTree_root(t), SolRBTreeIterTT_preorder);
+    while ((e = solRBTreeWalk_next_val(&w))) {
         s1 = solLL1ParserEntry_symbol(e);
         if (p == NULL) {
             p = solLL1ParserEntry_product(e);
         }
         solLL1ParserSymbol_add_first(s, s1, p);
     }
-    solRBTreeIter_free(i);
     return 0;
 }
 
@@ -379,10 +427,23 @@ int solLL1ParserSymbol_add_follow(SolLL1ParserSymbol *s1, SolLL1ParserSymbol *s2
     }
     SolLL1ParserEntry *e = solLL1ParserEntry_new(s2, p);
     if (e == NULL) return -5;
-    if (solRBTree_insert(solLL1ParserSymbol_follow(s1), e)) {
-        return 0;
+    return _solLL1ParserSymbol_insert_entry(solLL1ParserSymbol_follow(s1), e);
+}
+
+/**
+ * add e to a FIRST or FOLLOW tree, e is freed when its symbol is already there
+ */
+int _solLL1ParserSymbol_insert_entry(SolRBTree *t, SolLL1ParserEntry *e)
+{
+    int is_new;
+    if (_solLL1ParserEntryTree_insert_or_get(t, e, &is_new) == NULL) {
+        solLL1ParserEntry_free(e);
+        return 1;
     }
-    return 1;
+    if (is_new == 0) {
+        solLL1ParserEntry_free(e);
+    }
+    return 0;
 }
 
 int solLL1ParserSymbol_dup_follow(SolLL1ParserSymbol *s, SolRBTree *t, SolLL1ParserProduct *p)
@@ -399,19 +460,17 @@ int solLL1ParserSymbol_dup_follow(SolLL1ParserSymbol *s, SolRBTree *t, SolLL1Par
         solRBTree_set_val_free_func(solLL1ParserSymbol_follow(s), &_solLL1ParserEntry_free);
     }
     if (solLL1ParserSymbol_follow(s) == t) return -5;
-    SolRBTreeIter *i = solRBTreeIter_new(t, solRBTree_root(t), SolRBTreeIterTT_preorder);
+    SolRBTreeWalk w;
     SolLL1ParserEntry *e;
-    SolRBTreeNode *n;
     SolLL1ParserSymbol *s1;
-    while ((n = solRBTreeIter_next(i))) {
-        e = solRBTreeNode_val(n);
+    solRBTreeWalk_init(&w, t, solRBTree_root(t), SolRBTreeIterTT_preorder);
+    while ((e = solRBTreeWalk_next_val(&w))) {
         s1 = solLL1ParserEntry_symbol(e);
         if (p == NULL) {
             p = solLL1ParserEntry_product(e);
         }
         solLL1ParserSymbol_add_follow(s, s1, p);
     }
-    solRBTreeIter_free(i);
     return 0;
 }
 
@@ -469,7 +528,7 @@ int solLL1Parser_parse(SolLL1Parser *p, void *g, void *x)
         if (solLL1ParserSymbol_first(sbl2) == NULL) break;
         solLL1ParserEntry_set_symbol(e1, sbl1);
         if (solRBTree_count(solLL1ParserSymbol_first(sbl2))) {
-            rbn = solRBTree_search_node(solLL1ParserSymbol_first(sbl2), e1);
+            rbn = _solLL1ParserEntryTree_search_node(solLL1ParserSymbol_first(sbl2), e1);
             e2 = (SolLL1ParserEntry*)solRBTreeNode_val(rbn);
             if (e2 == NULL || solLL1ParserEntry_product(e2) == NULL)
                 goto check_nullable;
@@ -556,3 +615,28 @@ int _solLL1Parser_rbnode_compute_follow(SolRBTree *t, SolRBTreeNode *n, void *p)
     }
     return 0;
 }
+
+int _solLL1Parser_rbnode_memory_usage(SolRBTree *t, SolRBTreeNode *n, void *u)
+{
+    SolLL1ParserSymbol *s = solRBTreeNode_val(n);
+    solMemoryUsage_add((SolMemoryUsage*)u, sb, sizeof(SolLL1ParserSymbol));
+    if (solLL1ParserSymbol_first(s)) {
+        _solLL1ParserSymbol_set_memory_usage(solLL1ParserSymbol_first(s), u);
+    }
+    if (solLL1ParserSymbol_follow(s)) {
+        _solLL1ParserSymbol_set_memory_usage(solLL1ParserSymbol_follow(s), u);
+    }
+    return 0;
+}
+
+/**
+ * add a first or follow tree and its entries to u
+ */
+void _solLL1ParserSymbol_set_memory_usage(SolRBTree *t, SolMemoryUsage *u)
+{
+    size_t s = sizeof(SolLL1ParserEntry) * solRBTree_count(t);
+    _solRBTree_memory_usage(t, u);
+    u->ub += s;
+    u->pb += s;
+    u->n += solRBTree_count(t);
+}
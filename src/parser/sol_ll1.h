@@ -3,6 +3,7 @@
 
 #include "sol_common.h"
 #include "sol_list.h"
+#include "sol_vec.h"
 #include "sol_dl_list.h"
 #include "sol_stack.h"
 #include "sol_hash.h"
@@ -29,13 +30,14 @@ typedef struct _SolLL1ParserSymbol {
 
 typedef struct _SolLL1Parser {
     SolStack *s;
-    SolList *fl; // product list
+    SolVec *fl; // product list
     SolRBTree *ss; // symbol list
     SolLL1ParserSymbol* start;
     SolLL1ParserSymbol* end;
     SolLL1ParserSymbol* (*f_read)(void*);
     // output ANY, PRODUCT, SYMBOL, IGNORE
     int (*f_out)(void*, SolLL1ParserProduct*, SolLL1ParserSymbol*, SolLL1ParserSymbol*);
+    SolAllocator *a; // allocator of the parser and its lists
 } SolLL1Parser;
 
 typedef struct _SolLL1ParserEntry {
@@ -44,6 +46,7 @@ typedef struct _SolLL1ParserEntry {
 } SolLL1ParserEntry;
 
 SolLL1Parser* solLL1Parser_new();
+SolLL1Parser* solLL1Parser_new_with_allocator(SolAllocator*);
 void solLL1Parser_free(SolLL1Parser*);
 int solLL1Parser_reg_product(SolLL1Parser*, SolLL1ParserProduct*);
 int solLL1Parser_reg_symbol(SolLL1Parser*, SolLL1ParserSymbol*);
@@ -55,6 +58,7 @@ SolLL1ParserSymbol* solLL1Parser_null(SolLL1Parser*, void*);
 SolLL1ParserSymbol* solLL1Parser_symbol_end(SolLL1Parser*, void*);
 
 int solLL1Parser_generate_table(SolLL1Parser*);
+void solLL1Parser_memory_usage(SolLL1Parser*, SolMemoryUsage*);
 int solLL1Parser_symbol_compute_first(SolLL1Parser*, SolLL1ParserSymbol*);
 int solLL1Parser_symbol_compute_follow(SolLL1Parser*, SolLL1ParserSymbol*);
 int solLL1Parser_symbol_compute_nullable(SolLL1Parser*, SolLL1ParserSymbol*);
@@ -77,6 +81,7 @@ void _solLL1ParserSymbol_free(void*);
 int solLL1ParserSymbol_add_first(SolLL1ParserSymbol*, SolLL1ParserSymbol*, SolLL1ParserProduct*);
 int solLL1ParserSymbol_add_first_entry(SolLL1ParserSymbol*, SolLL1ParserEntry*);
 int solLL1ParserSymbol_add_follow(SolLL1ParserSymbol*, SolLL1ParserSymbol*, SolLL1ParserProduct*);
+int _solLL1ParserSymbol_insert_entry(SolRBTree*, SolLL1ParserEntry*);
 
 int solLL1ParserSymbol_dup_first(SolLL1ParserSymbol*, SolRBTree*, SolLL1ParserProduct*);
 int solLL1ParserSymbol_dup_follow(SolLL1ParserSymbol*, SolRBTree*, SolLL1ParserProduct*);
@@ -90,6 +95,8 @@ void _solLL1ParserEntry_free(void*);
 int _solLL1Parser_rbnode_compute_nullable(SolRBTree*, SolRBTreeNode*, void*);
 int _solLL1Parser_rbnode_compute_first(SolRBTree*, SolRBTreeNode*, void*);
 int _solLL1Parser_rbnode_compute_follow(SolRBTree*, SolRBTreeNode*, void*);
+int _solLL1Parser_rbnode_memory_usage(SolRBTree*, SolRBTreeNode*, void*);
+void _solLL1ParserSymbol_set_memory_usage(SolRBTree*, SolMemoryUsage*);
 
 #define solLL1Parser_set_stack(p, stack) (p)->s = stack
 #define solLL1Parser_set_product_list(p, l) (p)->fl = l
@@ -102,6 +109,7 @@ int _solLL1Parser_rbnode_compute_follow(SolRBTree*, SolRBTreeNode*, void*);
 #define solLL1Parser_stack(p) (p)->s
 #define solLL1Parser_product_list(p) (p)->fl
 #define solLL1Parser_symbol_list(p) (p)->ss
+#define solLL1Parser_allocator(p) (p)->a
 #define solLL1Parser_read_symbol_func(p) (p)->f_read
 #define solLL1Parser_output_func(p) (p)->f_out
 #define solLL1Parser_start_symbol(p) (p)->start
@@ -4,13 +4,22 @@
 
 SolPattern* solPattern_new()
 {
-    SolPattern *p = sol_calloc(1, sizeof(SolPattern));
+    return solPattern_new_with_allocator(NULL);
+}
+
+/**
+ * patterns joined together must share an allocator
+ */
+SolPattern* solPattern_new_with_allocator(SolAllocator *a)
+{
+    SolPattern *p = solAllocator_calloc(a, 1, sizeof(SolPattern));
     if (p == NULL) {
         return NULL;
     }
+    p->a = a;
     if (solPattern_dfa(p) == NULL) {
-        p->dfa = solDfa_new(&sol_i_hash_func1, &sol_i_hash_func2, &_solPattern_state_equal,
-                            &sol_c_hash_func1, &sol_c_hash_func2, &_solPattern_char_equal);
+        p->dfa = solDfa_new_with_allocator(&sol_i_hash_func1, &sol_i_hash_func2, &_solPattern_state_equal,
+                                           &sol_c_hash_func1, &sol_c_hash_func2, &_solPattern_char_equal, a);
     }
     if (solPattern_dfa(p) == NULL) {
         solPattern_free(p);
@@ -21,38 +30,94 @@ SolPattern* solPattern_new()
 
 void solPattern_free(SolPattern *p)
 {
+    size_t i;
     if (p->dfa) {
         solDfa_free(p->dfa);
     }
     if (solPattern_capture_list(p)) {
-        solList_free(solPattern_capture_list(p));
+        for (i = 0; i < solVec_count(solPattern_capture_list(p)); i++) {
+            solAllocator_free(p->a, solVec_ptr(solPattern_capture_list(p), i));
+        }
+        solVec_free(solPattern_capture_list(p));
     }
     if (p) {
-        sol_free(p);
+        solAllocator_free(p->a, p);
     }
 }
 
+/**
+ * bytes held by the pattern, its dfa and capture marks
+ * states are shared with the generator and not counted
+ */
+void solPattern_memory_usage(SolPattern *p, SolMemoryUsage *u)
+{
+    size_t i;
+    solMemoryUsage_init(u);
+    solMemoryUsage_add(u, sb, sizeof(SolPattern));
+    if (solPattern_dfa(p)) {
+        _solDfa_memory_usage(solPattern_dfa(p), u);
+    }
+    if (solPattern_capture_list(p)) {
+        _solVec_memory_usage(solPattern_capture_list(p), u);
+        for (i = 0; i < solVec_count(solPattern_capture_list(p)); i++) {
+            solMemoryUsage_add(u, mb, sizeof(SolPatternCaptureMark));
+        }
+    }
+    solMemoryUsage_sum(u);
+}
+
 SolPatternStateGen* solPatternStateGen_new()
 {
-    SolPatternStateGen *g = sol_alloc(sizeof(SolPatternStateGen));
+    return solPatternStateGen_new_with_allocator(NULL);
+}
+
+/**
+ * states and every pattern built from them come from a
+ */
+SolPatternStateGen* solPatternStateGen_new_with_allocator(SolAllocator *a)
+{
+    SolPatternStateGen *g = solAllocator_alloc(a, sizeof(SolPatternStateGen));
+    if (g == NULL) {
+        return NULL;
+    }
     g->i = 1;
-    g->l = solList_new();
-    solList_set_val_free_func(g->l, &sol_free);
+    g->a = a;
+    g->l = solVec_new_with_allocator(0, a);
+    if (g->l == NULL) {
+        solAllocator_free(a, g);
+        return NULL;
+    }
     return g;
 }
 
 void solPatternStateGen_free(SolPatternStateGen *g)
 {
-    solList_free(g->l);
-    sol_free(g);
+    size_t i;
+    for (i = 0; i < solVec_count(g->l); i++) {
+        solAllocator_free(g->a, solVec_ptr(g->l, i));
+    }
+    solVec_free(g->l);
+    solAllocator_free(g->a, g);
 }
 
 SolPatternState* solPatternGen_gen_state(SolPatternStateGen *g)
 {
-    SolPatternState *s = sol_alloc(sizeof(SolPatternState));
-    *s = g->i++;
-    SolListNode *n = solList_add(g->l, s);
-    return solListNode_val(n);
+    SolPatternState *b;
+    size_t o = (g->i - 1) % SOL_PATTERN_STATE_BLOCK_SIZE;
+    if (o == 0) {
+        b = solAllocator_alloc(g->a, sizeof(SolPatternState) * SOL_PATTERN_STATE_BLOCK_SIZE);
+        if (b == NULL) {
+            return NULL;
+        }
+        if (solVec_push_ptr(g->l, b)) {
+            solAllocator_free(g->a, b);
+            return NULL;
+        }
+    } else {
+        b = solVec_ptr(g->l, solVec_count(g->l) - 1);
+    }
+    b[o] = g->i++;
+    return b + o;
 }
 
 void solPattern_reset(SolPattern *p)
@@ -95,7 +160,7 @@ int solPattern_read_character(SolPattern *p, void *c)
 
 SolPattern* solPattern_empty_new(SolPatternStateGen *g)
 {
-    SolPattern *p = solPattern_new();
+    SolPattern *p = solPattern_new_with_allocator(g->a);
     SolPatternState *s = solPatternGen_gen_state(g);
     if (solDfa_set_starting_state(solPattern_dfa(p), s) != 0) {
         solPattern_free(p);
@@ -110,7 +175,7 @@ SolPattern* solPattern_empty_new(SolPatternStateGen *g)
 
 SolPattern* solPattern_literal_new(SolPatternStateGen *g, void *c)
 {
-    SolPattern *p = solPattern_new();
+    SolPattern *p = solPattern_new_with_allocator(g->a);
     SolPatternState *s1 = solPatternGen_gen_state(g);
     SolPatternState *s2 = solPatternGen_gen_state(g);
     if (solDfa_set_starting_state(solPattern_dfa(p), s1) != 0) {
@@ -127,7 +192,7 @@ SolPattern* solPattern_literal_new(SolPatternStateGen *g, void *c)
 
 SolPattern* solPattern_repeat_new(SolPatternStateGen *g, void *c)
 {
-    SolPattern *p = solPattern_new();
+    SolPattern *p = solPattern_new_with_allocator(g->a);
     SolPatternState *s = solPatternGen_gen_state(g);
     if (solDfa_set_starting_state(solPattern_dfa(p), s) != 0) {
         solPattern_free(p);
@@ -147,8 +212,9 @@ SolPattern* solPattern_repeat(SolPattern *p)
         return NULL;
     }
     void *s;
-    solDfa_accepting_states_rewind(solPattern_dfa(p));
-    while ((s = (solDfa_accepting_states_get_one(solPattern_dfa(p))))) {
+    SolSetIter i;
+    solDfa_accepting_states_iter_init(solPattern_dfa(p), &i);
+    while ((s = solSetIter_get(&i))) {
         if (solDfa_state_merge(solPattern_dfa(p),
                                solPattern_dfa(p),
                                solDfa_starting_state(solPattern_dfa(p)),
@@ -167,7 +233,7 @@ SolPattern* solPattern_repeat(SolPattern *p)
 
 SolPattern* solPattern_concatenate_new(SolPatternStateGen *g, SolList *l)
 {
-    SolPattern *p = solPattern_new();
+    SolPattern *p = solPattern_new_with_allocator(g->a);
     SolPatternState *s1 = solPatternGen_gen_state(g);
     if (solDfa_set_starting_state(solPattern_dfa(p), s1) != 0) {
         solPattern_free(p);
@@ -206,8 +272,9 @@ SolPattern* solPattern_concatenate(SolPattern *p1, SolPattern *p2)
     solDfa_free_all_states(solPattern_dfa(p2));
     solDfa_set_all_states(solPattern_dfa(p2), solDfa_all_states(solPattern_dfa(p1)));
     void *s;
-    solDfa_accepting_states_rewind(solPattern_dfa(p2));
-    while ((s = (solDfa_accepting_states_get_one(solPattern_dfa(p2))))) {
+    SolSetIter i;
+    solDfa_accepting_states_iter_init(solPattern_dfa(p2), &i);
+    while ((s = solSetIter_get(&i))) {
         if (solDfa_state_merge(solPattern_dfa(p1),
                                solPattern_dfa(p2),
                                solDfa_starting_state(solPattern_dfa(p1)),
@@ -220,7 +287,9 @@ SolPattern* solPattern_concatenate(SolPattern *p1, SolPattern *p2)
     solDfa_set_starting_state(solPattern_dfa(p1), solDfa_starting_state(solPattern_dfa(p2)));
     solPattern_set_reading_literal_func(p1, solPattern_reading_literal_func(p2));
     if (solPattern_capture_list(p1)) {
-        solList_attach(solPattern_capture_list(p1), solPattern_capture_list(p2));
+        if (solPattern_capture_list(p2)) {
+            solVec_attach(solPattern_capture_list(p1), solPattern_capture_list(p2));
+        }
     } else if (solPattern_capture_list(p2)) {
         solPattern_set_capture_list(p1, solPattern_capture_list(p2));
     }
@@ -232,7 +301,7 @@ SolPattern* solPattern_concatenate(SolPattern *p1, SolPattern *p2)
 
 SolPattern* solPattern_choose_new(SolPatternStateGen *g, SolList *l)
 {
-    SolPattern *p = solPattern_new();
+    SolPattern *p = solPattern_new_with_allocator(g->a);
     SolPatternState *s1 = solPatternGen_gen_state(g);
     if (solDfa_set_starting_state(solPattern_dfa(p), s1) != 0) {
         solPattern_free(p);
@@ -274,7 +343,9 @@ SolPattern* solPattern_choose(SolPattern *p1, SolPattern *p2)
     }
     solDfa_merge_accepting_states(solPattern_dfa(p1), solPattern_dfa(p2));
     if (solPattern_capture_list(p1)) {
-        solList_attach(solPattern_capture_list(p1), solPattern_capture_list(p2));
+        if (solPattern_capture_list(p2)) {
+            solVec_attach(solPattern_capture_list(p1), solPattern_capture_list(p2));
+        }
     } else if (solPattern_capture_list(p2)) {
         solPattern_set_capture_list(p1, solPattern_capture_list(p2));
     }
@@ -296,21 +367,24 @@ SolPattern* solPattern_capture(SolPattern *p, enum SolPatternCaptureMarkFlag f,
         return NULL;
     }
     if (solPattern_capture_list(p) == NULL) {
-        solPattern_set_capture_list(p, solList_new());
+        solPattern_set_capture_list(p, solVec_new_with_allocator(0, p->a));
         if (solPattern_capture_list(p) == NULL) {
             solPattern_free(p);
             return NULL;
         }
-        solList_set_val_free_func(solPattern_capture_list(p), &sol_free);
     }
-    SolPatternCaptureMark* cm = sol_calloc(1, sizeof(SolPatternCaptureMark));
+    SolPatternCaptureMark* cm = solAllocator_calloc(p->a, 1, sizeof(SolPatternCaptureMark));
     if (cm == NULL) {
         solPattern_free(p);
         return NULL;
     }
     solPatternCaptureMark_set_tag(cm, t);
     solPatternCaptureMark_set_flag(cm, f);
-    solList_add(solPattern_capture_list(p), cm);
+    if (solVec_push_ptr(solPattern_capture_list(p), cm)) {
+        solAllocator_free(p->a, cm);
+        solPattern_free(p);
+        return NULL;
+    }
     SolDfaState *ds = solDfa_conv_dfa_state(solPattern_dfa(p), solDfa_starting_state(solPattern_dfa(p)));
     SolDfaStateMark *dsm = solDfaState_mark(ds);
     int flag = SolPatternDfaStateFlag_Begin | SolPatternDfaStateFlag_Is_cm;
@@ -318,9 +392,10 @@ SolPattern* solPattern_capture(SolPattern *p, enum SolPatternCaptureMarkFlag f,
         flag |= solDfaStateMark_flag(dsm);
     }
     solDfaState_add_mark(ds, cm, flag);
-    solSet_rewind(solDfa_accepting_states(solPattern_dfa(p)));
     void *s;
-    while ((s = solSet_get(solDfa_accepting_states(solPattern_dfa(p))))) {
+    SolSetIter i;
+    solDfa_accepting_states_iter_init(solPattern_dfa(p), &i);
+    while ((s = solSetIter_get(&i))) {
         ds = solDfa_conv_dfa_state(solPattern_dfa(p), s);
         dsm = solDfaState_mark(ds);
         solPatternCaptureMark_set_flag(cm, f);
@@ -362,8 +437,9 @@ SolPattern* solPattern_end_with(SolPattern *p)
     }
     SolDfaState *ds;
     void *s;
-    solSet_rewind(solDfa_accepting_states(solPattern_dfa(p)));
-    while ((s = solSet_get(solDfa_accepting_states(solPattern_dfa(p))))) {
+    SolSetIter i;
+    solDfa_accepting_states_iter_init(solPattern_dfa(p), &i);
+    while ((s = solSetIter_get(&i))) {
         ds = solDfa_conv_dfa_state(solPattern_dfa(p), s);
         solDfaState_add_mark(ds, NULL, SolPatternDfaStateFlag_Is_final);
     }
@@ -514,10 +590,11 @@ inline void solPattern_reset_unmatched_capture_mark(SolPattern *p)
         return;
     }
     SolPatternCaptureMark *m;
-    SolListNode *n = solList_head(solPattern_capture_list(p));
+    SolVec *l = solPattern_capture_list(p);
+    size_t i;
     int f;
-    while (n) {
-        m = (SolPatternCaptureMark*)(solListNode_val(n));
+    for (i = 0; i < solVec_count(l); i++) {
+        m = (SolPatternCaptureMark*)(solVec_ptr(l, i));
         if (m == NULL) {
             continue;
         }
@@ -532,7 +609,6 @@ inline void solPattern_reset_unmatched_capture_mark(SolPattern *p)
             printf("FLUSH flag to %d!!!!!!\n", solPatternCaptureMark_flag(m));
 #endif
         }
-        n = solListNode_next(n);
     }
 }
 
@@ -542,10 +618,11 @@ inline void solPattern_reset_capture_mark(SolPattern *p)
         return;
     }
     SolPatternCaptureMark *m;
-    SolListNode *n = solList_head(solPattern_capture_list(p));
+    SolVec *l = solPattern_capture_list(p);
+    size_t i;
     int f;
-    while (n) {
-        m = solListNode_val(n);
+    for (i = 0; i < solVec_count(l); i++) {
+        m = solVec_ptr(l, i);
         if (m == NULL) {
             continue;
         }
@@ -559,6 +636,5 @@ inline void solPattern_reset_capture_mark(SolPattern *p)
 #ifdef __SOL_DEBUG__
         printf("RESET flag to %d!!!!!!\n", solPatternCaptureMark_flag(m));
 #endif
-        n = solListNode_next(n);
     }
 }
@@ -6,18 +6,23 @@
 #include "sol_utils.h"
 #include "sol_dfa.h"
 #include "sol_list.h"
+#include "sol_vec.h"
 
 #define SolPatternState unsigned int
+// states are taken from blocks, their address is the state identity
+#define SOL_PATTERN_STATE_BLOCK_SIZE 64
 
 typedef struct _SolPattern {
     SolDfa *dfa;
-    SolList *cl; // capture list
+    SolVec *cl; // capture list
     size_t (*r)(void*); // read literal
+    SolAllocator *a; // allocator of the dfa and the capture marks
 } SolPattern;
 
 typedef struct _SolPatternStateGen {
     SolPatternState i;
-    SolList *l;
+    SolVec *l; // state blocks
+    SolAllocator *a; // allocator of the blocks and the patterns built on them
 } SolPatternStateGen;
 
 enum SolPatternCaptureMarkFlag {
@@ -54,6 +59,8 @@ enum _SolPatternReadStrStatus {
 #define solPattern_dfa(p) (p)->dfa
 #define solPattern_capture_list(p) (p)->cl
 #define solPattern_reading_literal_func(p) (p)->r
+#define solPattern_allocator(p) (p)->a
+#define solPatternStateGen_allocator(g) (g)->a
 
 #define solPattern_set_capture_list(p, l) (p)->cl = l
 #define solPattern_set_reading_literal_func(p, f) (p)->r = f
@@ -74,10 +81,13 @@ enum _SolPatternReadStrStatus {
 #define solPattern_state_marked_final(dsm) (solDfaStateMark_flag(dsm) & SolPatternDfaStateFlag_Is_final)
 
 SolPattern* solPattern_new();
+SolPattern* solPattern_new_with_allocator(SolAllocator*);
 void solPattern_free(SolPattern*);
 
 SolPatternStateGen* solPatternStateGen_new();
+SolPatternStateGen* solPatternStateGen_new_with_allocator(SolAllocator*);
 void solPatternStateGen_free(SolPatternStateGen*);
+void solPattern_memory_usage(SolPattern*, SolMemoryUsage*);
 SolPatternState* solPatternGen_gen_state(SolPatternStateGen*);
 
 int solPattern_check_matching(SolPattern*);
@@ -101,8 +111,8 @@ int _solPattern_char_equal(void *c1, void *c2);
 int _solPattern_state_equal(void *s1, void *s2);
 void _solPattern_debug_relations(SolPattern *p);
 
-inline void solPatternCapture_update_mark(SolDfaStateMark*, size_t);
-inline void solPattern_reset_capture_mark(SolPattern*);
-inline void solPattern_reset_unmatched_capture_mark(SolPattern*);
+void solPatternCapture_update_mark(SolDfaStateMark*, size_t);
+void solPattern_reset_capture_mark(SolPattern*);
+void solPattern_reset_unmatched_capture_mark(SolPattern*);
 
 #endif
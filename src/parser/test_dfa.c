@@ -135,6 +135,9 @@ int main()
     printf("read %c\n", c);
     solDfa_read_character(d, &c);
     print_current_state(d);
+    SolMemoryUsage u;
+    solDfa_memory_usage(d, &u);
+    printf("memory %zu bytes in %zu allocations, rules %zu marks %zu\n", u.b, u.n, u.ub, u.mb);
     solDfa_free(d);
     return 0;
  err:
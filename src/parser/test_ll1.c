@@ -316,6 +316,9 @@ int main()
     solLL1Parser_set_output_func(p, &_output);
     solLL1Parser_set_start_symbol(p, sS);
     printf("Parse result %d\n", solLL1Parser_parse(p, i, p));
+    SolMemoryUsage u;
+    solLL1Parser_memory_usage(p, &u);
+    printf("memory %zu bytes in %zu allocations, table entries %zu\n", u.b, u.n, u.ub);
 
     solListIter_free(i);
     solList_free(l);
@@ -89,11 +89,10 @@ void print_match_result(SolPattern *p, char* s)
 {
     char *ms = sol_calloc(10, sizeof(char));
     SolPatternCaptureMark *cm;
-    SolListNode *ln;
+    size_t i;
     if (solPattern_capture_list(p)) {
-        ln = solList_head(solPattern_capture_list(p));
-        while (ln) {
-            cm = solListNode_val(ln);
+        for (i = 0; i < solVec_count(solPattern_capture_list(p)); i++) {
+            cm = solVec_ptr(solPattern_capture_list(p), i);
             strncpy(ms,
                     s + solPatternCaptureMark_starting_index(cm),
                     solPatternCaptureMark_end_index(cm) - solPatternCaptureMark_starting_index(cm)
@@ -106,7 +105,6 @@ void print_match_result(SolPattern *p, char* s)
                    solPatternCaptureMark_end_index(cm),
                    (solPatternCaptureMark_flag(cm) & SolPatternCaptureMarkFlag_Matched)
                 );
-            ln = solListNode_next(ln);
         }
     }
     sol_free(ms);
@@ -267,6 +265,9 @@ int main()
     //_solPattern_debug_dfa_relations(pIF_abc);
     printf("/(M1:^(abc))/\t\"%s\"\tmatch? %d\n", sabcabcabc, solPattern_match(pIF_abc, sabcabcabc, l9));
     printf("/(M1:^(abc))/\t\"%s\"\tmatch? %d\n", sacabcababcac, solPattern_match(pIF_abc, sacabcababcac, l12));
+    SolMemoryUsage u;
+    solPattern_memory_usage(pIF_abc, &u);
+    printf("memory %zu bytes in %zu allocations, rules %zu marks %zu\n", u.b, u.n, u.ub, u.mb);
     solPattern_free(pIF_abc);
     solPatternStateGen_free(g);
     return 0;